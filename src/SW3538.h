@@ -13,6 +13,7 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include "sw3538_regs.h"
 
 // SW3538寄存器定义
 #define SW3538_DEFAULT_ADDRESS     0x3C
@@ -31,15 +32,44 @@
 #define SW3538_REG_MOS_SETTING      0x107
 #define SW3538_REG_TEMP_SETTING     0x10D
 
-// 调试开关 - 设置为0可完全关闭调试信息
-#define SW3538_DEBUG 1
+// ADC通道（写入ADC_CONFIG选择）
+#define SW3538_ADC_CH_IBUS1         1
+#define SW3538_ADC_CH_IBUS2         2
+#define SW3538_ADC_CH_VIN           6
+#define SW3538_ADC_CH_NTC           7
+#define SW3538_ADC_CH_VOUT          11
+#define SW3538_ADC_CH_NONE          0xFF
 
-#if SW3538_DEBUG
-    #define SW3538_LOG(msg) Serial.println(msg)
-    #define SW3538_LOG_VAL(msg, val) do { Serial.print(msg); Serial.println(val); } while(0)
-#else
-    #define SW3538_LOG(msg)
-    #define SW3538_LOG_VAL(msg, val)
+// ADC转换时间（选择通道后到数据有效）
+#define SW3538_ADC_CONVERT_MS       5
+
+// ADC过采样：readAllData()每通道连续转换4^k次，整数均值抽取后比原始值多k位（0关闭）
+#ifndef SW3538_OVERSAMPLE_BITS
+#define SW3538_OVERSAMPLE_BITS      0
+#endif
+#define SW3538_OVERSAMPLE_MAX_BITS  4           // 每通道256次
+
+// 读取校验：可疑字段（读失败、不合理或带毛刺特征）单独重读的最多轮数，0只标记不重读
+// 重读一次与首次一致即接受；无可疑字段时不重读
+#ifndef SW3538_REREAD_PASSES
+#define SW3538_REREAD_PASSES        1
+#endif
+
+// 两次读取视为一致的最大差值（ADC原始LSB），一致的不合理读数按真实值接受
+#ifndef SW3538_REREAD_TOLERANCE_LSB
+#define SW3538_REREAD_TOLERANCE_LSB 8
+#endif
+
+// 合理性检查限值
+#define SW3538_VIN_MAX_MV           32000   // 超出量程即判定读数错误
+#define SW3538_VOUT_MAX_MV          21500
+#define SW3538_CURRENT_MAX_MA       6500
+#define SW3538_IDLE_CURRENT_MA      200     // 降压关闭时通路电流上限
+#define SW3538_VOUT_MARGIN_MV       1000    // 协议最高档位之上的余量
+
+// 调试开关 - 默认关闭，设置为1时驱动默认日志策略切换为串口输出
+#ifndef SW3538_DEBUG
+#define SW3538_DEBUG 0
 #endif
 
 // 快充协议枚举
@@ -61,14 +91,24 @@ enum SW3538_FastChargeProtocol {
     SW3538_FC_TFCP = 15
 };
 
+// 字段有效位 - SW3538_Data_t.validMask第n位对应原始帧槽位n（SW3538_Source）
+#define SW3538_VALID(source)        ((uint16_t)(1U << (source)))
+#define SW3538_VALID_ALL            ((uint16_t)((1U << SW3538_SRC_COUNT) - 1))
+#define SW3538_VALID_CURRENTS       (SW3538_VALID(SW3538_SRC_ADC_IBUS1) | SW3538_VALID(SW3538_SRC_ADC_IBUS2))
+#define SW3538_VALID_STATUS         (SW3538_VALID(SW3538_SRC_VERSION) | SW3538_VALID(SW3538_SRC_MAX_POWER) | \
+                                     SW3538_VALID(SW3538_SRC_FAST_CHARGE) | SW3538_VALID(SW3538_SRC_STATUS0) | \
+                                     SW3538_VALID(SW3538_SRC_STATUS1))
+
 // 数据结构 - 优化字段顺序以减少内存对齐开销
 typedef struct {
+    uint32_t timeMs;            // 采样时间（millis），解码录制帧时为0
     uint16_t inputVoltagemV;
     uint16_t outputVoltagemV;
     int16_t currentPath1mA;
     int16_t currentPath2mA;
     int16_t ntcTemperatureC;
     uint16_t maxPowerW;
+    uint16_t validMask;         // 本次读取有效的槽位（SW3538_VALID），无效槽位保持上次的有效值
     uint8_t chipVersion;
     uint8_t pdVersion;
     SW3538_FastChargeProtocol fastChargeProtocol;
@@ -79,25 +119,233 @@ typedef struct {
     bool path2BuckStatus;
 } SW3538_Data_t;
 
-// 协议名称查找表 - 无String实现
-class SW3538 {
+// readAllData()读取校验统计（单位：字段）
+typedef struct {
+    uint32_t reads;         // readAllData()次数
+    uint32_t readErrors;    // 总线失败
+    uint32_t implausible;   // 读到但不合理或带毛刺特征
+    uint32_t rereads;       // 重读
+    uint32_t recovered;     // 重读后有效
+    uint32_t confirmed;     // 可疑（不合理或带毛刺特征）但重读一致，按真实值接受
+    uint32_t held;          // 最终无效，保持上次的有效值
+} SW3538_ReadStats;
+
+// 原始帧中ADC槽位（按readAllData()读取顺序）
+#define SW3538_RAW_IBUS1            0
+#define SW3538_RAW_IBUS2            1
+#define SW3538_RAW_VIN              2
+#define SW3538_RAW_VOUT             3
+#define SW3538_RAW_NTC              4
+#define SW3538_RAW_ADC_COUNT        5
+
+// 一次readAllData()读到的原始寄存器值 - 可录制后脱离硬件重新解码
+typedef struct {
+    uint8_t version;        // REG_VERSION
+    uint8_t maxPower;       // REG_MAX_POWER
+    uint8_t fastCharge;     // REG_FAST_CHARGE_IND
+    uint8_t status0;        // REG_SYS_STATUS0
+    uint8_t status1;        // REG_SYS_STATUS1
+    uint8_t ntcState;       // REG_NTC_CURRENT_STATE
+    uint16_t adc[SW3538_RAW_ADC_COUNT];  // 合并后的ADC原始值
+} SW3538_RawFrame;
+
+// 一个ADC槽位的过采样结果
+typedef struct {
+    uint32_t value;         // 抽取结果，比原始值多getOversampleBits()位
+    uint16_t samples;       // 实际参与平均的转换次数（失败的读取被丢弃）
+    uint16_t noiseQ8;       // 单次转换噪声标准差，单位1/256 LSB
+} SW3538_Oversample;
+
+// 按槽位（SW3538_Source）访问原始帧
+inline uint16_t sw3538RawGet(const SW3538_RawFrame& raw, uint8_t source) {
+    switch (source) {
+        case SW3538_SRC_VERSION:     return raw.version;
+        case SW3538_SRC_MAX_POWER:   return raw.maxPower;
+        case SW3538_SRC_FAST_CHARGE: return raw.fastCharge;
+        case SW3538_SRC_STATUS0:     return raw.status0;
+        case SW3538_SRC_STATUS1:     return raw.status1;
+        case SW3538_SRC_NTC_STATE:   return raw.ntcState;
+        default:                     return raw.adc[source - SW3538_SRC_ADC_FIRST];
+    }
+}
+
+inline void sw3538RawSet(SW3538_RawFrame& raw, uint8_t source, uint16_t value) {
+    switch (source) {
+        case SW3538_SRC_VERSION:     raw.version = value; break;
+        case SW3538_SRC_MAX_POWER:   raw.maxPower = value; break;
+        case SW3538_SRC_FAST_CHARGE: raw.fastCharge = value; break;
+        case SW3538_SRC_STATUS0:     raw.status0 = value; break;
+        case SW3538_SRC_STATUS1:     raw.status1 = value; break;
+        case SW3538_SRC_NTC_STATE:   raw.ntcState = value; break;
+        default:                     raw.adc[source - SW3538_SRC_ADC_FIRST] = value; break;
+    }
+}
+
+// ===== 编译期策略 =====
+// 驱动以模板参数组合策略，未使用的功能（日志、重试）在编译期消除
+
+// 日志策略：串口输出
+struct SW3538SerialLogger {
+    static constexpr bool enabled = true;     // 调用点据此跳过只为日志准备的格式化
+    static void mute(bool m) { muted() = m; } // 运行时静音（如快速启动的首帧之前）
+    static void log(const char* msg) { if (!muted()) Serial.println(msg); }
+    template<typename T>
+    static void logVal(const char* msg, T val) { if (!muted()) { Serial.print(msg); Serial.println(val); } }
+private:
+    static bool& muted() { static bool m = false; return m; }
+};
+
+// 日志策略：空实现，调用点全部内联消除
+struct SW3538NullLogger {
+    static constexpr bool enabled = false;
+    static void mute(bool) {}
+    static void log(const char*) {}
+    template<typename T>
+    static void logVal(const char*, T) {}
+};
+
+// 重试策略：最多Attempts次，读失败后等待BaseMs<<k（指数退避），写失败后等待BaseMs
+template<uint8_t Attempts, uint8_t BaseMs>
+struct SW3538BackoffRetry {
+    static constexpr uint8_t attempts = Attempts;
+    static void waitRead(uint8_t attempt) { delay((uint32_t)BaseMs << attempt); }
+    static void waitWrite(uint8_t) { delay(BaseMs); }
+};
+
+// 重试策略：单次尝试，无等待
+struct SW3538NoRetry {
+    static constexpr uint8_t attempts = 1;
+    static void waitRead(uint8_t) {}
+    static void waitWrite(uint8_t) {}
+};
+
+// 芯片型号策略：寄存器字段描述表，ADC位宽/使能位/换算系数均由表在编译期查出
+// 描述表结构体提供fieldCount和field(i)，SW3538VariantT<表>在其上补出驱动所需的查询；
+// 新型号只需提供自己的描述表结构体
+template<class Table>
+struct SW3538VariantT : Table {
+    // 读数所需的全部ADC强制使能位
+    static constexpr uint8_t adcEnableMask = sw3538AdcEnableMask<Table>();
+    
+    // ADC高字节有效位：由字段位宽决定（SW3538的VOUT为15位，其余12位）
+    static constexpr uint8_t adcHighMask(uint8_t channel) {
+        return sw3538AdcFieldIndex<Table>(channel) < Table::fieldCount
+             ? (uint8_t)((1 << (Table::field(sw3538AdcFieldIndex<Table>(channel)).width - 8)) - 1) : 0x0F;
+    }
+    
+    // ADC通道号 → 强制使能位
+    static constexpr uint8_t adcEnableBit(uint8_t channel) {
+        return sw3538AdcFieldIndex<Table>(channel) < Table::fieldCount
+             ? Table::field(sw3538AdcFieldIndex<Table>(channel)).adcEnableBit : channel;
+    }
+    
+    // ADC原始值换算系数（mA/bit或mV/bit）
+    static constexpr float adcScale(uint8_t channel) {
+        return sw3538AdcFieldIndex<Table>(channel) < Table::fieldCount
+             ? Table::field(sw3538AdcFieldIndex<Table>(channel)).scale : 1.0f;
+    }
+};
+
+template<class Table>
+constexpr uint8_t SW3538VariantT<Table>::adcEnableMask;
+
+// SW3538描述表（sw3538_regs.h）
+struct SW3538Fields {
+    static constexpr uint8_t fieldCount = SW3538_FIELD_COUNT;
+    static constexpr const SW3538_FieldDesc& field(uint8_t i) { return SW3538_FIELDS[i]; }
+};
+
+typedef SW3538VariantT<SW3538Fields> SW3538Variant;
+
+// 总线策略：提供TwoWire接口的类型；默认构造时使用的总线实例
+template<class Bus>
+struct SW3538DefaultBus {
+    static Bus* get() { return nullptr; }
+};
+
+template<>
+struct SW3538DefaultBus<TwoWire> {
+    static TwoWire* get() { return &Wire; }
+};
+
+/**
+ * @class SW3538T
+ * @brief 按策略组合的SW3538驱动
+ * 
+ * @tparam Bus 总线类型，需提供TwoWire的begin/setClock/beginTransmission/
+ *             write/endTransmission/requestFrom/read接口
+ * @tparam Logger 日志策略（SW3538SerialLogger/SW3538NullLogger）
+ * @tparam Retry 重试策略（SW3538BackoffRetry/SW3538NoRetry）
+ * @tparam Variant 芯片型号策略（SW3538VariantT<描述表>，如SW3538Variant）
+ * 
+ * 成员函数定义在SW3538.cpp，使用的组合需在其中显式实例化
+ */
+template<class Bus, class Logger, class Retry, class Variant>
+class SW3538T {
 public:
     // 构造函数
-    SW3538(uint8_t address = SW3538_DEFAULT_ADDRESS);
-    SW3538(uint8_t address, int sdaPin, int sclPin);
+    SW3538T(uint8_t address = SW3538_DEFAULT_ADDRESS);
+    SW3538T(uint8_t address, int sdaPin, int sclPin);
+    SW3538T(uint8_t address, Bus& wire);      // 总线由调用者初始化
     
     // 基本功能
     void begin();
     bool testI2CAddress(uint8_t address);
-    void scanI2CAddresses();
+    bool isPresent();                          // 静默探测本实例地址
+    uint8_t scanI2CAddresses();               // 返回应答的设备数
     bool readAllData();
+    bool startConversion();                    // 预先使能ADC并选通第一个通道，readAllData()只等剩余转换时间；失败时不留ADC使能
     void printAllData(Print& serial);
+    void dumpRegisters(Print& serial);        // 按字段描述表读取并逐字段打印
+    
+    // 原始帧 - readAllData()先读寄存器到原始帧，再解码到data
+    const SW3538_RawFrame& getRawFrame() const { return _raw; }
+    static bool decodeRawFrame(const SW3538_RawFrame& raw, SW3538_Data_t& out);  // 通信失败帧返回false
+    
+    // 读取校验 - 读失败或不合理的槽位单独重读，仍无效的保持上次的有效值并清除data.validMask中的位
+    static uint16_t checkPlausibility(const SW3538_RawFrame& raw);  // 返回不合理的槽位（SW3538_VALID）
+    static uint16_t checkPlausibility(const SW3538_RawFrame& raw, uint16_t& outOfRange);  // 另给出超出量程的槽位
+    
+    // 最近一次readAllData()校验前的读数（含重读），供录制；getRawFrame()为校验后的值
+    const SW3538_RawFrame& getReadFrame() const { return _fresh; }
+    uint16_t getReadMask() const { return _readMask; }    // 读到的槽位，其余为上次的值
+    uint16_t getValidMask() const { return _validMask; }  // 通过校验的槽位，通信失败时为0
+    uint32_t getFieldTimeMs(uint8_t source) const { return _fieldMs[source]; }  // 槽位最近一次有效读取的时间
+    void setRereadPasses(uint8_t passes) { _rereadPasses = passes; }
+    const SW3538_ReadStats& getReadStats() const { return _stats; }
+    void resetReadStats() { _stats = SW3538_ReadStats(); }
     
     // 设置功能
     bool setNTC(uint8_t current_state); // 0:20uA, 1:40uA
+    
+    // 以下两个寄存器（0x107/0x10D）在第1页，驱动不支持翻页，调用总是返回false且不解锁写保护
+    __attribute__((deprecated("paged register 0x107 is not supported")))
     bool setMOSInternalResistance(uint8_t mos_setting); // 0-3
+    __attribute__((deprecated("paged register 0x10D is not supported")))
     bool setNTCOverTempThreshold(uint8_t threshold_setting); // 0-7
     
+    // 单通道快速读取 - 用于突发采集，解锁/使能/选通只做一次
+    bool beginFastRead(uint8_t channel);       // 选择通道并保持ADC使能
+    bool readFast(uint16_t& raw);              // 仅读数据寄存器，单次尝试，无延时；高字节毛刺按失败返回
+    void endFastRead();                        // 关闭该通道ADC
+    uint8_t getFastChannel() const { return _fastChannel; }  // readAllData()后失效
+    
+    // 快速读取通道的占用 - 突发采集和守护共用一个通道，同一时间只由占用者选通，避免互相重新选通
+    bool claimFastRead(const void* owner, bool preempt = false);  // 空闲或已占用时成功；preempt抢占并关闭原通道
+    void releaseFastRead(const void* owner);   // 占用者释放并关闭通道，非占用者调用无效
+    const void* getFastOwner() const { return _fastOwner; }  // 跨readAllData()保持
+    
+    // ADC过采样 - 选通后用单次读取连续取样，原始帧保存四舍五入后的均值
+    bool setOversampleBits(uint8_t bits);      // 0-SW3538_OVERSAMPLE_MAX_BITS，每通道4^bits次
+    uint8_t getOversampleBits() const { return _osBits; }
+    const SW3538_Oversample& getOversample(uint8_t slot) const { return _os[slot]; }  // slot为SW3538_RAW_*
+    float getEffectiveBits(uint8_t slot) const;  // 按实测噪声估计的有效分辨率（位）
+    
+    // ADC原始值换算（mA或mV）
+    static float adcToValue(uint8_t channel, uint16_t raw);
+    static int16_t ntcRawToCelsius(uint16_t raw, bool current40uA);  // 无效返回-999
+    bool isNtc40uA() const { return _ntc40uA; }  // 最近一次readAllData()读到的NTC电流档位
+    
     // 静态方法 - 获取协议名称（无String）
     static const char* getProtocolName(SW3538_FastChargeProtocol protocol) {
         static const char* names[] = {
@@ -111,6 +359,11 @@ public:
         return "UNKNOWN";
     }
     
+    void setBusClock(uint32_t hz);             // begin()前调用只记录，之后立即生效（仅自有总线）
+    
+    uint8_t getAddress() const { return _address; }
+    Bus& getWire() const { return *_wire; }
+    
     // 公共数据访问
     SW3538_Data_t data;
 
@@ -119,15 +372,56 @@ private:
     int _sdaPin;
     int _sclPin;
     bool _useCustomPins;
+    bool _ownsBus;       // false时begin()不初始化总线
+    bool _begun = false;
+    uint32_t _clockHz = 100000;
+    Bus* _wire;
     
     // 私有方法
     uint8_t readRegister(uint16_t reg);
+    bool readRegister(uint16_t reg, uint8_t& value);  // 重试后仍失败返回false
     bool writeRegister(uint16_t reg, uint8_t value);
     bool enableI2CWrite();
     bool enableForceOperationWrite();
-    bool enableADC(uint8_t adc_type);
-    bool disableADC(uint8_t adc_type);
-    uint16_t readADCData(uint8_t channel);
+    bool setADCEnable(uint8_t mask, bool enable);  // mask为FORCE_OP2中的使能位
+    bool updateRegister(uint16_t reg, uint8_t mask, uint8_t bits);  // 解锁后读改写mask内的位
+    bool readSource(const SW3538_FieldDesc& f, uint16_t& value, bool& adcEnabled);
+    static bool sameReading(const SW3538_FieldDesc& f, uint16_t a, uint16_t b);
+    bool readRegisterOnce(uint8_t reg, uint8_t& value);
+    bool readAdcOnce(uint8_t channel, uint16_t& raw);
+    bool readAdcBytes(uint8_t& low, uint8_t& high);  // 单次尝试
+    bool adcGlitch(uint8_t source, uint8_t low, uint8_t high, uint16_t value) const;
+    bool oversample(uint8_t channel, uint8_t slot, uint16_t& value);
+    static uint16_t combineADC(uint8_t channel, uint8_t low, uint8_t high);
+    
+    uint8_t _fastChannel = SW3538_ADC_CH_NONE;
+    const void* _fastOwner = nullptr;
+    uint8_t _convChannel = SW3538_ADC_CH_NONE;  // startConversion()已选通的通道
+    uint32_t _convStartMs = 0;
+    bool _ntc40uA = false;
+    uint8_t _osBits = SW3538_OVERSAMPLE_BITS;
+    SW3538_Oversample _os[SW3538_RAW_ADC_COUNT] = {};
+    SW3538_RawFrame _raw = {};
+    SW3538_RawFrame _fresh = {};
+    uint16_t _readMask = 0;
+    uint16_t _validMask = 0;
+    uint8_t _rereadPasses = SW3538_REREAD_PASSES;
+    bool _glitch = false;       // readSource()的读数带总线毛刺特征（见adcGlitch()），需重读确认
+    uint32_t _fieldMs[SW3538_SRC_COUNT] = {};
+    SW3538_ReadStats _stats = {};
 };
 
+
+#if SW3538_DEBUG
+typedef SW3538SerialLogger SW3538DefaultLogger;
+#else
+typedef SW3538NullLogger SW3538DefaultLogger;
+#endif
+
+typedef SW3538BackoffRetry<3, 5> SW3538DefaultRetry;
+
+// 默认驱动：TwoWire总线、SW3538_DEBUG决定日志、3次指数退避重试
+typedef SW3538T<TwoWire, SW3538DefaultLogger, SW3538DefaultRetry, SW3538Variant> SW3538;
+extern template class SW3538T<TwoWire, SW3538DefaultLogger, SW3538DefaultRetry, SW3538Variant>;
+
 #endif // SW3538_H
@@ -0,0 +1,786 @@
+/*
+ * SW3538_impl.h - SW3538T模板成员定义
+ *
+ * 只由显式实例化所在的源文件包含：SW3538.cpp实例化默认驱动（TwoWire），
+ * sim_bus.cpp实例化模拟总线驱动。其余源文件只包含SW3538.h，
+ * 通过extern template使用已实例化的版本，不重复编译驱动
+ */
+
+#ifndef SW3538_IMPL_H
+#define SW3538_IMPL_H
+
+#include <Arduino.h>
+#include "SW3538.h"
+#include <Wire.h>
+
+#define SW3538_TEMPLATE template<class Bus, class Logger, class Retry, class Variant>
+#define SW3538_CLASS    SW3538T<Bus, Logger, Retry, Variant>
+
+// 构造函数 - 只保存配置，不打印（管理器会批量构造/赋值），日志在begin()中输出
+SW3538_TEMPLATE
+SW3538_CLASS::SW3538T(uint8_t address) : _address(address), _sdaPin(-1), _sclPin(-1), _useCustomPins(false), _ownsBus(true), _wire(SW3538DefaultBus<Bus>::get()) {
+}
+
+// 指定I2C总线的构造函数 - 总线由调用者初始化，用于多芯片/多总线场景
+SW3538_TEMPLATE
+SW3538_CLASS::SW3538T(uint8_t address, Bus& wire) : _address(address), _sdaPin(-1), _sclPin(-1), _useCustomPins(false), _ownsBus(false), _wire(&wire) {
+}
+
+// 支持自定义I2C引脚的构造函数
+SW3538_TEMPLATE
+SW3538_CLASS::SW3538T(uint8_t address, int sdaPin, int sclPin) : _address(address), _sdaPin(sdaPin), _sclPin(sclPin), _useCustomPins(true), _ownsBus(true), _wire(SW3538DefaultBus<Bus>::get()) {
+}
+
+// 测试I2C地址 - 结果经日志策略输出，空日志策略下不做格式化
+SW3538_TEMPLATE
+bool SW3538_CLASS::testI2CAddress(uint8_t address) {
+    const char* result = "No response";
+    bool found = false;
+    
+    _wire->beginTransmission(address);
+    if (_wire->endTransmission() == 0) {
+        uint8_t testReg;
+        found = readRegister(SW3538_REG_VERSION, testReg) && testReg != 0xFF && testReg != 0x00;
+        result = found ? "OK SW3538 found" : "OK Invalid data";
+    }
+    
+    if (Logger::enabled) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "Testing addr 0x%02X... %s", address, result);
+        Logger::log(buf);
+    }
+    return found;
+}
+
+// 静默探测 - 不打印，仅检查应答和版本寄存器
+SW3538_TEMPLATE
+bool SW3538_CLASS::isPresent() {
+    _wire->beginTransmission(_address);
+    if (_wire->endTransmission() != 0) return false;
+    
+    uint8_t testReg = readRegister(SW3538_REG_VERSION);
+    return testReg != 0xFF && testReg != 0x00;
+}
+
+// 扫描I2C地址 - 简化输出，返回应答的设备数
+SW3538_TEMPLATE
+uint8_t SW3538_CLASS::scanI2CAddresses() {
+    Logger::log("I2C scan start");
+    Logger::log("Addr  Status");
+    
+    uint8_t found = 0;
+    for (uint8_t addr = 1; addr < 127; addr++) {
+        _wire->beginTransmission(addr);
+        if (_wire->endTransmission() == 0) {
+            if (Logger::enabled) {
+                char buf[16];
+                snprintf(buf, sizeof(buf), "0x%02X  FOUND", addr);
+                Logger::log(buf);
+            }
+            found++;
+        }
+    }
+    
+    Logger::logVal("Found devices: ", found);
+    return found;
+}
+
+// 初始化 - 简化实现
+SW3538_TEMPLATE
+void SW3538_CLASS::begin() {
+    if (Logger::enabled) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "SW3538 init addr: 0x%02X", _address);
+        Logger::log(buf);
+    }
+    
+    // 根据是否使用自定义引脚来初始化I2C
+    if (_useCustomPins) {
+        // 使用自定义SDA/SCL引脚
+        _wire->begin(_sdaPin, _sclPin);
+        Logger::logVal("I2C started with custom pins - SDA: ", _sdaPin);
+        Logger::logVal("SCL: ", _sclPin);
+    } else if (_ownsBus) {
+        // 使用默认引脚
+        _wire->begin();
+        Logger::log("I2C started with default pins");
+    }
+    
+    if (_ownsBus) {
+        _wire->setClock(_clockHz);
+    }
+    _begun = true;
+    
+    uint8_t version = readRegister(SW3538_REG_VERSION);
+    if (version == 0xFF || version == 0x00) {
+        Logger::log("Communication failed");
+    } else {
+        Logger::logVal("Chip version: ", version);
+    }
+}
+
+// 总线时钟 - 共享总线由调用者设置
+SW3538_TEMPLATE
+void SW3538_CLASS::setBusClock(uint32_t hz) {
+    _clockHz = hz;
+    if (_begun && _ownsBus) _wire->setClock(hz);
+}
+
+// 读取寄存器 - 失败返回0xFF，无法与寄存器真实值0xFF区分
+SW3538_TEMPLATE
+uint8_t SW3538_CLASS::readRegister(uint16_t reg) {
+    uint8_t value;
+    return readRegister(reg, value) ? value : 0xFF;
+}
+
+// 读取寄存器 - 优化重试机制
+SW3538_TEMPLATE
+bool SW3538_CLASS::readRegister(uint16_t reg, uint8_t& value) {
+    // 0x100以上需翻页，截断成低8位会读到另一个寄存器
+    if (SW3538_REG_PAGE(reg) != 0) {
+        Logger::logVal("Paged register unsupported: 0x", reg);
+        return false;
+    }
+    uint8_t reg_addr = SW3538_REG_OFFSET(reg);
+    
+    for (uint8_t retry = 0; retry < Retry::attempts; retry++) {
+        if (retry > 0) Retry::waitRead(retry - 1);  // 退避策略由Retry决定
+        
+        _wire->beginTransmission(_address);
+        _wire->write(reg_addr);
+        
+        if (_wire->endTransmission(false) != 0) {
+            continue;
+        }
+        
+        if (_wire->requestFrom(_address, (uint8_t)1) == 1) {
+            value = _wire->read();
+            return true;
+        }
+    }
+    
+    return false;  // 通信失败
+}
+
+// 写入寄存器 - 简化实现
+SW3538_TEMPLATE
+bool SW3538_CLASS::writeRegister(uint16_t reg, uint8_t value) {
+    if (SW3538_REG_PAGE(reg) != 0) {
+        Logger::logVal("Paged register unsupported: 0x", reg);
+        return false;
+    }
+    uint8_t reg_addr = SW3538_REG_OFFSET(reg);
+    
+    for (uint8_t retry = 0; retry < Retry::attempts; retry++) {
+        if (retry > 0) Retry::waitWrite(retry - 1);
+        
+        _wire->beginTransmission(_address);
+        _wire->write(reg_addr);
+        _wire->write(value);
+        
+        if (_wire->endTransmission() == 0) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+// 启用I2C写操作 - 简化序列
+SW3538_TEMPLATE
+bool SW3538_CLASS::enableI2CWrite() {
+    return writeRegister(SW3538_REG_I2C_ENABLE, 0x20) &&
+           writeRegister(SW3538_REG_I2C_ENABLE, 0x40) &&
+           writeRegister(SW3538_REG_I2C_ENABLE, 0x80);
+}
+
+// 启用强制操作写 - 简化序列
+SW3538_TEMPLATE
+bool SW3538_CLASS::enableForceOperationWrite() {
+    return writeRegister(SW3538_REG_FORCE_OP_ENABLE, 0x20) &&
+           writeRegister(SW3538_REG_FORCE_OP_ENABLE, 0x40) &&
+           writeRegister(SW3538_REG_FORCE_OP_ENABLE, 0x80);
+}
+
+// ADC控制 - 一次解锁、一次读改写完成多个通道的使能/关闭
+// 使能位都在FORCE_OP2中，关闭时同样写回FORCE_OP2（原先误写到下一个寄存器）
+// 读失败时不写：0xFF会把无关的强制控制位一起打开
+SW3538_TEMPLATE
+bool SW3538_CLASS::setADCEnable(uint8_t mask, bool enable) {
+    if (!enableForceOperationWrite()) return false;
+    
+    uint8_t reg_val;
+    if (!readRegister(SW3538_REG_FORCE_OP2, reg_val)) return false;
+    reg_val = enable ? (reg_val | mask) : (reg_val & ~mask);
+    return writeRegister(SW3538_REG_FORCE_OP2, reg_val);
+}
+
+SW3538_TEMPLATE
+uint16_t SW3538_CLASS::combineADC(uint8_t channel, uint8_t low, uint8_t high) {
+    // VOUT 15位（高字节掩码0x7F），其余12位，由芯片变体的字段表给出
+    return ((uint16_t)(high & Variant::adcHighMask(channel)) << 8) | low;
+}
+
+SW3538_TEMPLATE
+float SW3538_CLASS::adcToValue(uint8_t channel, uint16_t raw) {
+    return raw * Variant::adcScale(channel);
+}
+
+// NTC温度换算 - B值公式，结果超出NTC可测范围时返回-999
+SW3538_TEMPLATE
+int16_t SW3538_CLASS::ntcRawToCelsius(uint16_t raw, bool current40uA) {
+    if (raw == 0) return -999;  // 开路/短路，log无意义
+    
+    constexpr float ntc_scale = Variant::adcScale(SW3538_ADC_CH_NTC);  // 编译期查表
+    float ntc_voltage = raw * ntc_scale;                      // 1.2mV/bit
+    float ntc_current = current40uA ? 40.0f : 20.0f;          // uA
+    float ntc_resistance = ntc_voltage / ntc_current;         // kOhm
+    
+    // 温度计算 - 使用更精确的公式
+    const float B = 3950.0f;
+    const float T0 = 298.15f;
+    const float R0 = 10.0f;
+    
+    float temp_k = 1.0f / (1.0f/T0 + (1.0f/B) * log(ntc_resistance/R0));
+    float temp_c = temp_k - 273.15f;
+    
+    // 数据有效性检查 - 保留100°C以上读数，过温保护需要看到真实值
+    if (temp_c < -40.0f || temp_c > 150.0f) {
+        return -999;  // 无效值
+    }
+    return (int16_t)temp_c;
+}
+
+// 单次读取 - 不重试不退避，失败由调用者丢弃该样本
+SW3538_TEMPLATE
+bool SW3538_CLASS::readRegisterOnce(uint8_t reg, uint8_t& value) {
+    _wire->beginTransmission(_address);
+    _wire->write(reg);
+    if (_wire->endTransmission(false) != 0) return false;
+    if (_wire->requestFrom(_address, (uint8_t)1) != 1) return false;
+    value = _wire->read();
+    return true;
+}
+
+// 快速读取准备 - 写解锁、使能ADC、选择通道各一次
+SW3538_TEMPLATE
+bool SW3538_CLASS::beginFastRead(uint8_t channel) {
+    if (_fastChannel == channel) return true;
+    if (_fastChannel != SW3538_ADC_CH_NONE) endFastRead();
+    
+    if (!setADCEnable(1 << Variant::adcEnableBit(channel), true)) return false;
+    if (!writeRegister(SW3538_REG_ADC_CONFIG, channel)) return false;
+    
+    delay(SW3538_ADC_CONVERT_MS);  // 首次转换时间
+    _fastChannel = channel;
+    _convChannel = SW3538_ADC_CH_NONE;
+    return true;
+}
+
+SW3538_TEMPLATE
+bool SW3538_CLASS::readFast(uint16_t& raw) {
+    if (_fastChannel == SW3538_ADC_CH_NONE) return false;
+    return readAdcOnce(_fastChannel, raw);
+}
+
+// 只读数据寄存器（通道已选通），单次尝试
+// 高字节0xFF必为毛刺（见adcGlitch()），按读失败处理；低字节0xFF可能是真实值，由调用者确认
+SW3538_TEMPLATE
+bool SW3538_CLASS::readAdcOnce(uint8_t channel, uint16_t& raw) {
+    uint8_t low, high;
+    if (!readAdcBytes(low, high) || high == 0xFF) return false;
+    raw = combineADC(channel, low, high);
+    return true;
+}
+
+SW3538_TEMPLATE
+bool SW3538_CLASS::readAdcBytes(uint8_t& low, uint8_t& high) {
+    return readRegisterOnce(SW3538_REG_ADC_DATA_LOW, low) &&
+           readRegisterOnce(SW3538_REG_ADC_DATA_HIGH, high);
+}
+
+// ADC读数的总线毛刺特征（SDA被拉高读到0xFF）：
+// 高字节0xFF超出任何通道的位宽，必为毛刺；低字节0xFF是合法读数（如0x1FF），
+// 只有相对上次有效值跳变超过容差时才可疑
+SW3538_TEMPLATE
+bool SW3538_CLASS::adcGlitch(uint8_t source, uint8_t low, uint8_t high, uint16_t value) const {
+    if (high == 0xFF) return true;
+    if (low != 0xFF) return false;
+    uint16_t last = sw3538RawGet(_raw, source);
+    return (value > last ? value - last : last - value) > SW3538_REREAD_TOLERANCE_LSB;
+}
+
+SW3538_TEMPLATE
+bool SW3538_CLASS::setOversampleBits(uint8_t bits) {
+    if (bits > SW3538_OVERSAMPLE_MAX_BITS) return false;
+    _osBits = bits;
+    return true;
+}
+
+// 整数平方根（向下取整）
+static uint32_t isqrt64(uint64_t v) {
+    uint64_t r = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > v) bit >>= 2;
+    while (bit != 0) {
+        if (v >= r + bit) {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)r;
+}
+
+// 过采样 - 通道已选通，4^k次只读数据寄存器（不再解锁/使能/选通）
+// boxcar抽取：有效子样本之和除以个数，扩展结果保留k位小数；全部为整数运算
+// 读失败或带毛刺特征的子样本丢弃，不参与平均；全部丢弃时该槽位读失败
+SW3538_TEMPLATE
+bool SW3538_CLASS::oversample(uint8_t channel, uint8_t slot, uint16_t& value) {
+    uint8_t source = SW3538_SRC_ADC_FIRST + slot;
+    uint16_t target = (uint16_t)1 << (2 * _osBits);
+    uint32_t sum = 0;
+    uint64_t sumSq = 0;
+    uint16_t n = 0;
+    for (uint16_t i = 0; i < target; i++) {
+        uint8_t low, high;
+        if (!readAdcBytes(low, high)) continue;
+        uint16_t raw = combineADC(channel, low, high);
+        if (adcGlitch(source, low, high, raw)) continue;
+        sum += raw;
+        sumSq += (uint32_t)raw * raw;
+        n++;
+    }
+    
+    SW3538_Oversample& os = _os[slot];
+    os.samples = n;
+    if (n == 0) {
+        os.value = 0;
+        os.noiseQ8 = 0;
+        return false;
+    }
+    os.value = ((sum << _osBits) + n / 2) / n;
+    // 方差×n² = nΣx² - (Σx)²，标准差换算到1/256 LSB
+    uint64_t varN2 = (uint64_t)n * sumSq - (uint64_t)sum * sum;
+    uint32_t sigmaQ8 = isqrt64((varN2 << 16) / ((uint32_t)n * n));
+    os.noiseQ8 = sigmaQ8 > 0xFFFF ? 0xFFFF : sigmaQ8;
+    value = (uint16_t)((sum + n / 2) / n);
+    return true;
+}
+
+// 有效分辨率 = 原始位宽 - log2(输出噪声)，输出噪声 = 单次噪声/√n，不低于输出量化步长
+// 噪声不足0.5 LSB时平均无法分辨LSB以下的变化（缺少抖动），按原始位宽计
+SW3538_TEMPLATE
+float SW3538_CLASS::getEffectiveBits(uint8_t slot) const {
+    uint8_t native = 0;
+    for (uint8_t i = 0; i < Variant::fieldCount; i++) {
+        if (Variant::field(i).source == SW3538_SRC_ADC_FIRST + slot) native = Variant::field(i).width;
+    }
+    
+    const SW3538_Oversample& os = _os[slot];
+    float sigma = os.noiseQ8 / 256.0f;
+    if (os.samples <= 1 || sigma < 0.5f) return native;
+    
+    float sigmaOut = sigma / sqrtf(os.samples);
+    float step = 1.0f / (1 << _osBits);
+    return native - log2f(sigmaOut > step ? sigmaOut : step);
+}
+
+SW3538_TEMPLATE
+void SW3538_CLASS::endFastRead() {
+    if (_fastChannel == SW3538_ADC_CH_NONE) return;
+    setADCEnable(1 << Variant::adcEnableBit(_fastChannel), false);
+    _fastChannel = SW3538_ADC_CH_NONE;
+}
+
+SW3538_TEMPLATE
+bool SW3538_CLASS::claimFastRead(const void* owner, bool preempt) {
+    if (_fastOwner != nullptr && _fastOwner != owner) {
+        if (!preempt) return false;
+        endFastRead();
+    }
+    _fastOwner = owner;
+    return true;
+}
+
+SW3538_TEMPLATE
+void SW3538_CLASS::releaseFastRead(const void* owner) {
+    if (_fastOwner != owner) return;
+    endFastRead();
+    _fastOwner = nullptr;
+}
+
+// 预先启动转换 - 使能全部ADC通道并选通表中第一个ADC字段，不等待
+// 调用者可在转换期间做其他事（如初始化OLED），随后readAllData()跳过该通道的选通和等待
+SW3538_TEMPLATE
+bool SW3538_CLASS::startConversion() {
+    uint8_t channel = SW3538_ADC_CH_NONE;
+    for (uint8_t i = 0; i < Variant::fieldCount && channel == SW3538_ADC_CH_NONE; i++) {
+        channel = Variant::field(i).adcChannel;
+    }
+    if (channel == SW3538_ADC_CH_NONE) return false;
+    
+    if (!setADCEnable(Variant::adcEnableMask, true)) return false;
+    if (!writeRegister(SW3538_REG_ADC_CONFIG, channel)) {
+        setADCEnable(Variant::adcEnableMask, false);
+        return false;
+    }
+    _fastChannel = SW3538_ADC_CH_NONE;
+    _convChannel = channel;
+    _convStartMs = millis();
+    return true;
+}
+
+// 读取一个槽位 - 寄存器字段读一次；ADC字段选通、等待转换后读取（按设置过采样）
+// 过采样槽位只要有一个有效子样本即读取成功
+SW3538_TEMPLATE
+bool SW3538_CLASS::readSource(const SW3538_FieldDesc& f, uint16_t& value, bool& adcEnabled) {
+    _glitch = false;
+    if (f.adcChannel == SW3538_ADC_CH_NONE) {
+        uint8_t reg;
+        if (!readRegister(f.reg, reg)) return false;
+        value = reg;
+        _glitch = reg == 0xFF;  // 寄存器读到0xFF需重读确认（也可能是真实值）
+        return true;
+    }
+    
+    if (!adcEnabled) {
+        if (_convChannel == SW3538_ADC_CH_NONE) setADCEnable(Variant::adcEnableMask, true);
+        adcEnabled = true;
+    }
+    
+    uint8_t slot = f.source - SW3538_SRC_ADC_FIRST;
+    if (f.adcChannel == _convChannel) {
+        // 已由startConversion()选通，只等待剩余转换时间
+        uint32_t elapsed = millis() - _convStartMs;
+        if (elapsed < SW3538_ADC_CONVERT_MS) delay(SW3538_ADC_CONVERT_MS - elapsed);
+        _convChannel = SW3538_ADC_CH_NONE;
+    } else {
+        if (!writeRegister(SW3538_REG_ADC_CONFIG, f.adcChannel)) return false;
+        delay(SW3538_ADC_CONVERT_MS);  // ADC转换时间
+    }
+    
+    if (_osBits > 0) return oversample(f.adcChannel, slot, value);
+    
+    uint8_t low, high;
+    if (!readRegister(SW3538_REG_ADC_DATA_LOW, low) || !readRegister(SW3538_REG_ADC_DATA_HIGH, high)) {
+        return false;
+    }
+    value = combineADC(f.adcChannel, low, high);
+    _glitch = adcGlitch(f.source, low, high, value);
+    _os[slot].value = value;
+    _os[slot].samples = 1;
+    _os[slot].noiseQ8 = 0;
+    return true;
+}
+
+// 两次读取是否一致：寄存器须相同，ADC允许转换噪声
+SW3538_TEMPLATE
+bool SW3538_CLASS::sameReading(const SW3538_FieldDesc& f, uint16_t a, uint16_t b) {
+    if (f.adcChannel == SW3538_ADC_CH_NONE) return a == b;
+    return (a > b ? a - b : b - a) <= SW3538_REREAD_TOLERANCE_LSB;
+}
+
+// 读取所有数据 - 按字段描述表采集原始帧，再解码
+// 同一寄存器的字段共用一次读取，ADC通道一次性使能/关闭
+// 读失败、不合理或带毛刺特征（总线毛刺读到0xFF，量程内的错误只能这样发现，见adcGlitch()）的槽位单独重读，
+// 不重读整帧；重读一次与首次一致即接受，仍无效的槽位保持上次的有效值，
+// 下游（自适应扫描、事件、显示）不会看到总线错误产生的跳变
+// 过采样的ADC槽位在子样本层面筛除失败和毛刺，不整槽重读
+SW3538_TEMPLATE
+bool SW3538_CLASS::readAllData() {
+    bool adcEnabled = false;
+    SW3538_RawFrame& fresh = _fresh;  // 本次读数，读失败的槽位为上次的值
+    fresh = _raw;
+    uint16_t readMask = 0;          // 本次读到的槽位
+    uint16_t glitched = 0;          // 读数带毛刺特征的槽位
+    uint16_t averaged = 0;          // 过采样的ADC槽位
+    _stats.reads++;
+    
+    for (uint8_t i = 0; i < Variant::fieldCount; i++) {
+        const SW3538_FieldDesc& f = Variant::field(i);
+        if (i > 0 && Variant::field(i - 1).source == f.source) continue;  // 已读过
+        
+        if (_osBits > 0 && f.adcChannel != SW3538_ADC_CH_NONE) averaged |= SW3538_VALID(f.source);
+        
+        uint16_t value;
+        if (readSource(f, value, adcEnabled)) {
+            sw3538RawSet(fresh, f.source, value);
+            readMask |= SW3538_VALID(f.source);
+            if (_glitch) glitched |= SW3538_VALID(f.source);
+        }
+        
+        // 检查通信状态：版本和最大功率都读不到，不再读后面的字段
+        if (f.source == SW3538_SRC_MAX_POWER &&
+            !(readMask & (SW3538_VALID(SW3538_SRC_VERSION) | SW3538_VALID(SW3538_SRC_MAX_POWER)))) {
+            Logger::log("I2C communication failed");
+            // startConversion()已使能的ADC同样关闭，不留在常开状态
+            if (adcEnabled || _convChannel != SW3538_ADC_CH_NONE) {
+                setADCEnable(Variant::adcEnableMask, false);
+            }
+            _convChannel = SW3538_ADC_CH_NONE;
+            _stats.readErrors += 2;
+            _readMask = readMask;
+            _validMask = 0;
+            return false;
+        }
+    }
+    
+    // 可疑槽位：读失败、不合理或超出量程
+    // 过采样槽位的子样本已逐个筛除，均值按已确认处理（仍受量程限制）；
+    // 整槽重读要再做4^k次转换，过采样槽位不重读，全部子样本失败时保持上次的值
+    uint16_t failed = SW3538_VALID_ALL & ~readMask;
+    uint16_t outOfRange;
+    uint16_t flagged = glitched | checkPlausibility(fresh, outOfRange);
+    uint16_t confirmed = averaged & readMask;  // 可疑但重读一致，或为过采样均值
+    uint16_t suspect = failed | (flagged & ~confirmed) | outOfRange;
+    uint16_t firstSuspect = suspect;
+    _stats.readErrors += __builtin_popcount(failed);
+    _stats.implausible += __builtin_popcount(flagged & ~failed);
+    
+    for (uint8_t pass = 0; pass < _rereadPasses && (suspect & ~averaged) != 0; pass++) {
+        for (uint8_t i = 0; i < Variant::fieldCount; i++) {
+            const SW3538_FieldDesc& f = Variant::field(i);
+            uint16_t bit = SW3538_VALID(f.source);
+            if ((i > 0 && Variant::field(i - 1).source == f.source) || !(suspect & bit) || (averaged & bit)) continue;
+            
+            uint16_t value;
+            _stats.rereads++;
+            if (!readSource(f, value, adcEnabled)) continue;
+            if (!(failed & bit) && sameReading(f, sw3538RawGet(fresh, f.source), value)) confirmed |= bit;
+            failed &= ~bit;
+            glitched = _glitch ? (glitched | bit) : (glitched & ~bit);
+            sw3538RawSet(fresh, f.source, value);
+        }
+        // 一致的读数按真实值接受；超出量程的即使一致也不接受（如总线卡死连续读到全1）
+        uint16_t implausible = checkPlausibility(fresh, outOfRange);
+        suspect = failed | ((implausible | glitched) & ~confirmed) | outOfRange;
+    }
+    
+    if (adcEnabled) {
+        setADCEnable(Variant::adcEnableMask, false);
+    }
+    
+    // 通道选择和ADC使能已改变，快速读取需重新准备
+    _fastChannel = SW3538_ADC_CH_NONE;
+    
+    // 有效槽位写入原始帧并记录时间，其余保持上次的有效值
+    uint16_t valid = SW3538_VALID_ALL & ~suspect;
+    uint32_t now = millis();
+    for (uint8_t s = 0; s < SW3538_SRC_COUNT; s++) {
+        if (!(valid & SW3538_VALID(s))) continue;
+        sw3538RawSet(_raw, s, sw3538RawGet(fresh, s));
+        _fieldMs[s] = now;
+    }
+    _stats.recovered += __builtin_popcount(firstSuspect & valid);
+    _stats.confirmed += __builtin_popcount(confirmed & flagged & valid);
+    _stats.held += __builtin_popcount(suspect);
+    _readMask = SW3538_VALID_ALL & ~failed;
+    _validMask = valid;
+    
+    if (!(valid & (SW3538_VALID(SW3538_SRC_VERSION) | SW3538_VALID(SW3538_SRC_MAX_POWER)))) {
+        Logger::log("I2C communication failed");
+        return false;
+    }
+    
+    _ntc40uA = (_raw.ntcState & 0x80) != 0;
+    if (!decodeRawFrame(_raw, data)) return false;
+    data.validMask = valid;
+    data.timeMs = now;
+    return true;
+}
+
+// 各协议的最高输出电压（mV），QC按Class B，PD/PPS等按20V
+static uint16_t protocolMaxMv(uint8_t protocol) {
+    switch (protocol) {
+        case SW3538_FC_NONE:
+        case SW3538_FC_VOOC1_0:
+        case SW3538_FC_VOOC4_0: return 5000;
+        case SW3538_FC_SCP:     return 10000;
+        case SW3538_FC_FCP:
+        case SW3538_FC_AFC:
+        case SW3538_FC_SFCP:
+        case SW3538_FC_PE1_1:   return 12000;
+        default:                return 20000;
+    }
+}
+
+SW3538_TEMPLATE
+uint16_t SW3538_CLASS::checkPlausibility(const SW3538_RawFrame& raw) {
+    uint16_t outOfRange;
+    return checkPlausibility(raw, outOfRange);
+}
+
+// 合理性检查 - 纯函数，录制帧同样适用
+// outOfRange为超出芯片量程的槽位；关联检查（电压与协议、电流与降压状态）同时标记双方，
+// 由重读判断是哪一方读错
+SW3538_TEMPLATE
+uint16_t SW3538_CLASS::checkPlausibility(const SW3538_RawFrame& raw, uint16_t& outOfRange) {
+    outOfRange = 0;
+    if (raw.version == 0xFF && raw.maxPower == 0xFF) {
+        outOfRange = SW3538_VALID(SW3538_SRC_VERSION) | SW3538_VALID(SW3538_SRC_MAX_POWER);
+        return outOfRange;
+    }
+    
+    SW3538_Data_t d = {};   // 型号描述表中没有的字段为0
+    decodeRawFrame(raw, d);
+    if (d.inputVoltagemV > SW3538_VIN_MAX_MV)    outOfRange |= SW3538_VALID(SW3538_SRC_ADC_VIN);
+    if (d.outputVoltagemV > SW3538_VOUT_MAX_MV)  outOfRange |= SW3538_VALID(SW3538_SRC_ADC_VOUT);
+    if (d.currentPath1mA > SW3538_CURRENT_MAX_MA) outOfRange |= SW3538_VALID(SW3538_SRC_ADC_IBUS1);
+    if (d.currentPath2mA > SW3538_CURRENT_MAX_MA) outOfRange |= SW3538_VALID(SW3538_SRC_ADC_IBUS2);
+    
+    uint16_t suspect = outOfRange;
+    // 降压关闭的通路不应有负载电流
+    if (!d.path1BuckStatus && d.currentPath1mA > SW3538_IDLE_CURRENT_MA) {
+        suspect |= SW3538_VALID(SW3538_SRC_ADC_IBUS1) | SW3538_VALID(SW3538_SRC_STATUS0);
+    }
+    if (!d.path2BuckStatus && d.currentPath2mA > SW3538_IDLE_CURRENT_MA) {
+        suspect |= SW3538_VALID(SW3538_SRC_ADC_IBUS2) | SW3538_VALID(SW3538_SRC_STATUS0);
+    }
+    // 输出电压不应高于当前协议的最高档位
+    if (d.outputVoltagemV > protocolMaxMv(d.fastChargeProtocol) + SW3538_VOUT_MARGIN_MV) {
+        suspect |= SW3538_VALID(SW3538_SRC_ADC_VOUT) | SW3538_VALID(SW3538_SRC_FAST_CHARGE);
+    }
+    return suspect;
+}
+
+// 原始帧解码 - 纯函数，不访问总线，录制回放与实时读取共用
+// 描述表为编译期常量，循环展开后每个字段只剩一次移位、掩码和存储；表中没有的字段不写入
+SW3538_TEMPLATE
+bool SW3538_CLASS::decodeRawFrame(const SW3538_RawFrame& raw, SW3538_Data_t& out) {
+    if (raw.version == 0xFF && raw.maxPower == 0xFF) return false;
+    
+    // 有效位和采样时间由调用者（readAllData）覆盖
+    out.validMask = SW3538_VALID_ALL;
+    out.timeMs = 0;
+    
+    bool ntc40uA = false;
+#pragma GCC unroll 32
+    for (uint8_t i = 0; i < Variant::fieldCount; i++) {
+        const SW3538_FieldDesc& f = Variant::field(i);
+        int32_t v = sw3538ExtractField(sw3538RawGet(raw, f.source), f);
+        
+        switch (f.target) {
+            case SW3538_T_CHIP_VERSION: out.chipVersion = v; break;
+            case SW3538_T_MAX_POWER:    out.maxPowerW = v; break;
+            case SW3538_T_FAST_CHARGE:  out.fastChargeStatus = v != 0; break;
+            case SW3538_T_PD_VERSION:   out.pdVersion = v; break;
+            case SW3538_T_PROTOCOL:     out.fastChargeProtocol = (SW3538_FastChargeProtocol)v; break;
+            case SW3538_T_BUCK1:        out.path1BuckStatus = v != 0; break;
+            case SW3538_T_BUCK2:        out.path2BuckStatus = v != 0; break;
+            case SW3538_T_ONLINE1:      out.path1Online = v != 0; break;
+            case SW3538_T_ONLINE2:      out.path2Online = v != 0; break;
+            case SW3538_T_NTC_40UA:     ntc40uA = v != 0; break;
+            case SW3538_T_CURRENT1:     out.currentPath1mA = v * f.scale; break;
+            case SW3538_T_CURRENT2:     out.currentPath2mA = v * f.scale; break;
+            case SW3538_T_VIN:          out.inputVoltagemV = v * f.scale; break;
+            case SW3538_T_VOUT:         out.outputVoltagemV = v * f.scale; break;
+            case SW3538_T_NTC_TEMP:     out.ntcTemperatureC = ntcRawToCelsius(v, ntc40uA); break;
+        }
+    }
+    
+    return true;
+}
+
+// 寄存器转储 - 逐字段输出地址、位范围、原始值和换算值
+SW3538_TEMPLATE
+void SW3538_CLASS::dumpRegisters(Print& serial) {
+    if (!readAllData()) {
+        serial.println("[RegDump] read failed");
+        return;
+    }
+    
+    char buf[80];
+    snprintf(buf, sizeof(buf), "[RegDump] addr 0x%02X", _address);
+    serial.println(buf);
+    for (uint8_t i = 0; i < Variant::fieldCount; i++) {
+        const SW3538_FieldDesc& f = Variant::field(i);
+        uint16_t regVal = sw3538RawGet(_raw, f.source);
+        int32_t v = sw3538ExtractField(regVal, f);
+        int len;
+        if (f.adcChannel == SW3538_ADC_CH_NONE) {
+            len = snprintf(buf, sizeof(buf), "0x%03X [%2u:%-2u] %-14s reg=0x%02X val=%ld",
+                           f.reg, f.lsb + f.width - 1, f.lsb, f.name, regVal, (long)v);
+        } else {
+            len = snprintf(buf, sizeof(buf), "ADC%-2u [%2u:%-2u] %-14s raw=%-5u val=%.1f",
+                           f.adcChannel, f.lsb + f.width - 1, f.lsb, f.name, regVal, v * f.scale);
+            if (_osBits > 0) {
+                uint8_t slot = f.source - SW3538_SRC_ADC_FIRST;
+                len += snprintf(buf + len, sizeof(buf) - len, " n=%u eff=%.1fb",
+                                _os[slot].samples, getEffectiveBits(slot));
+            }
+        }
+        // 本次无效的槽位显示的是上次的有效值
+        if (!(data.validMask & SW3538_VALID(f.source)) && len < (int)sizeof(buf)) {
+            snprintf(buf + len, sizeof(buf) - len, " stale %lums",
+                     (unsigned long)(data.timeMs - _fieldMs[f.source]));
+        }
+        serial.println(buf);
+    }
+}
+
+// 打印所有数据 - 使用固定格式
+SW3538_TEMPLATE
+void SW3538_CLASS::printAllData(Print& serial) {
+    serial.println("--- SW3538 ---");
+    serial.print("Version: "); serial.println(data.chipVersion);
+    serial.print("MaxPower: "); serial.print(data.maxPowerW); serial.println("W");
+    serial.print("FastCharger: "); serial.println(data.fastChargeStatus ? "ON" : "OFF");
+    serial.print("Protocol: "); serial.println(getProtocolName(data.fastChargeProtocol));
+    serial.print("PD_Version: "); serial.println(data.pdVersion == 1 ? "2.0" : (data.pdVersion == 2 ? "3.0" : "RSV"));
+    serial.print("Path1 Link: "); serial.print(data.path1Online ? "ON" : "OFF");
+    serial.print(" Path1 Buck:"); serial.println(data.path1BuckStatus ? "ON" : "OFF");
+    serial.print("Path2 Link: "); serial.print(data.path2Online ? "ON" : "OFF");
+    serial.print(" Path2 Buck:"); serial.println(data.path2BuckStatus ? "ON" : "OFF");
+    serial.print("Path1 Current: "); serial.print(data.currentPath1mA); serial.println("mA");
+    serial.print("Path2 Current: "); serial.print(data.currentPath2mA); serial.println("mA");
+    serial.print("Input Voltage: "); serial.print(data.inputVoltagemV); serial.println("mV");
+    serial.print("Output Voltage: "); serial.print(data.outputVoltagemV); serial.println("mV");
+    serial.print("Temperature: "); 
+    if (data.ntcTemperatureC == -999) {
+        serial.println("N/A");
+    } else {
+        serial.print(data.ntcTemperatureC); serial.println("C");
+    }
+    serial.println("--------------");
+}
+
+// 设置函数 - 解锁后读改写
+// 翻页寄存器在解锁前拒绝，不留写保护解除的状态；读失败时不写入
+SW3538_TEMPLATE
+bool SW3538_CLASS::updateRegister(uint16_t reg, uint8_t mask, uint8_t bits) {
+    if (SW3538_REG_PAGE(reg) != 0) {
+        Logger::logVal("Paged register unsupported: 0x", reg);
+        return false;
+    }
+    if (!enableI2CWrite()) return false;
+    
+    uint8_t reg_val;
+    if (!readRegister(reg, reg_val)) return false;
+    return writeRegister(reg, (reg_val & ~mask) | (bits & mask));
+}
+
+SW3538_TEMPLATE
+bool SW3538_CLASS::setNTC(uint8_t current_state) {
+    if (current_state > 1) return false;
+    return updateRegister(SW3538_REG_NTC_CURRENT_STATE, 0x80, current_state << 7);
+}
+
+SW3538_TEMPLATE
+bool SW3538_CLASS::setMOSInternalResistance(uint8_t mos_setting) {
+    if (mos_setting > 3) return false;
+    return updateRegister(SW3538_REG_MOS_SETTING, 0xC0, mos_setting << 6);
+}
+
+SW3538_TEMPLATE
+bool SW3538_CLASS::setNTCOverTempThreshold(uint8_t threshold_setting) {
+    if (threshold_setting > 7) return false;
+    return updateRegister(SW3538_REG_TEMP_SETTING, 0x38, threshold_setting << 3);
+}
+
+#undef SW3538_TEMPLATE
+#undef SW3538_CLASS
+
+#endif // SW3538_IMPL_H
@@ -9,7 +9,7 @@
  * - 上次电流值：0mA（初始状态）
  */
 void AdaptiveScan::begin() {
-    _interval  = 200;          // 上电先 200 ms，确保快速响应
+    _interval  = _minInterval; // 上电先高速扫描（默认200ms），确保快速响应
     _lastTick  = millis();     // 记录初始化时间
     _stableCnt = 0;            // 稳定状态计数器清零
     _lastI = 0.0f;             // 初始电流设为0
@@ -26,13 +26,17 @@ void AdaptiveScan::begin() {
  * @return false 继续等待
  */// 检查是否应该执行扫描
 bool AdaptiveScan::tick() {
-    if (millis() - _lastTick < _interval) return false;
-    _lastTick = millis();  // 更新时间戳
+    uint32_t now = millis();
+    if (!isDue(now)) return false;
+    _lateMs = now - (_lastTick + _interval);  // 相对计划时间的延迟
+    markScanned(now);  // 更新时间戳
     
+#if ADAPTIVE_SCAN_DEBUG
     // 打印当前刷新间隔（调试信息）
     Serial.print("[AdaptiveScan] Current interval: ");
     Serial.print(_interval);
     Serial.println("ms");
+#endif
     return true;
 }
 
@@ -47,7 +51,7 @@ bool AdaptiveScan::tick() {
  * 将扫描间隔重置为200ms，确保快速响应
  */
 void AdaptiveScan::notifyChange() {
-    _interval  = 200;          // 立即回到高速扫描（200ms间隔）
+    _interval  = _minInterval; // 立即回到高速扫描（默认200ms间隔）
     _stableCnt = 0;            // 重置稳定计数器，重新开始计数
 }
 
@@ -70,13 +74,13 @@ void AdaptiveScan::updateCurrent(float i_ma) {
         notifyChange();  // 电流变化超过阈值，立即恢复高速扫描
     } 
     // 阶段2：稳定状态检测
-    else if (++_stableCnt >= 5) {  // 连续5次稳定后考虑减速
+    else if (++_stableCnt >= _stableTarget) {  // 连续稳定（默认5次）后考虑减速
         // 指数退避算法：每次乘以退避系数（默认2倍）
         uint32_t newInterval = (uint32_t)(_interval * _backoff);
         
         // 边界保护：限制扫描间隔范围
-        if (newInterval < 200) newInterval = 200;    // 最小200ms（快速响应）
-        if (newInterval > 5000) newInterval = 5000;    // 最大5秒（节能模式）
+        if (newInterval < _minInterval) newInterval = _minInterval;  // 最小间隔（快速响应）
+        if (newInterval > _maxInterval) newInterval = _maxInterval;  // 最大间隔（节能模式）
         
         _interval = newInterval;  // 应用新的扫描间隔
         _stableCnt = 0;          // 重置计数器，重新开始检测
@@ -86,42 +90,15 @@ void AdaptiveScan::updateCurrent(float i_ma) {
 }
 
 /**
- * @brief 多维状态变化检测
+ * @brief 事件总线回调
  * 
- * 监控除电流外的其他关键状态：
- * - 快充协议状态（PD/QC等协议建立）
- * - 通路连接状态（设备插入/拔出）
- * - 充电状态变化（开始/停止充电）
+ * 快充协议状态变化、设备插入/拔出由SW3538EventBus统一检测，
+ * 这里只负责切换到高速扫描，确保及时响应
  * 
- * 任何状态变化都会触发高速扫描，确保及时响应
- * 
- * @param fastChargeStatus 快充状态（true=快充协议已建立）
- * @param path1Online 第一通路连接状态（true=设备已连接）
- * @param path2Online 第二通路连接状态（true=设备已连接）
+ * @param evt 事件内容（未使用）
+ * @param ctx AdaptiveScan实例
  */
-void AdaptiveScan::updateState(bool fastChargeStatus, bool path1Online, bool path2Online) {
-    // 初始化状态变化标志
-    bool stateChanged = false;
-    
-    // 检测1：快充协议状态变化
-    // 当设备开始快充或退出快充时，需要快速响应
-    if (fastChargeStatus != _lastFastChargeStatus) {
-        stateChanged = true;
-    }
-    
-    // 检测2：设备连接状态变化
-    // 当设备插入或拔出时，需要立即调整扫描频率
-    if (path1Online != _lastPath1Online || path2Online != _lastPath2Online) {
-        stateChanged = true;
-    }
-    
-    // 触发高速扫描
-    if (stateChanged) {
-        notifyChange();  // 立即切换到高速扫描模式
-    }
-    
-    // 更新状态缓存，为下次检测做准备
-    _lastFastChargeStatus = fastChargeStatus;
-    _lastPath1Online = path1Online;
-    _lastPath2Online = path2Online;
-}
\ No newline at end of file
+void AdaptiveScan::onEvent(const SW3538_Event& evt, void* ctx) {
+    (void)evt;
+    static_cast<AdaptiveScan*>(ctx)->notifyChange();
+}
@@ -2,13 +2,19 @@
 #define ADAPTIVE_SCAN_H
 
 #include <Arduino.h>
+#include "sw3538_events.h"
+
+// 调试开关 - 置1时tick()每次扫描打印当前间隔（默认关闭，避免每次扫描都有串口输出）
+#ifndef ADAPTIVE_SCAN_DEBUG
+#define ADAPTIVE_SCAN_DEBUG 0
+#endif
 
 /**
  * @class AdaptiveScan
  * @brief 自适应扫描频率控制器
  * 
  * 实现原理：
- * 1. 变化检测：监控电流、快充状态、设备连接等多维度变化
+ * 1. 变化检测：监控电流变化，快充状态、设备连接变化由事件总线通知
  * 2. 频率调整：根据变化幅度动态调整扫描频率（200ms-5s）
  * 3. 指数退避：稳定状态下逐步降低频率，变化时立即提速
  * 
@@ -36,6 +42,34 @@ public:
      */
     bool tick();
     
+    /**
+     * @brief 检查在给定时刻是否到达扫描时间（无串口输出）
+     * 
+     * 供多设备轮询使用，由调用者提供统一时间戳
+     * 
+     * @param now 当前时间，单位ms
+     * @return true 已到扫描时间
+     */
+    bool isDue(uint32_t now) const { return now - _lastTick >= _interval; }
+    
+    /**
+     * @brief 记录一次已执行的扫描
+     * 
+     * @param now 扫描开始时间，单位ms
+     */
+    void markScanned(uint32_t now) { _lastTick = now; }
+    
+    /**
+     * @brief 获取距下次扫描的剩余时间
+     * 
+     * @param now 当前时间，单位ms
+     * @return 剩余时间，单位ms（已到期返回0）
+     */
+    uint32_t getTimeUntilDue(uint32_t now) const {
+        uint32_t elapsed = now - _lastTick;
+        return elapsed >= _interval ? 0 : _interval - elapsed;
+    }
+    
     /**
      * @brief 强制切换到高速扫描模式
      * 
@@ -64,28 +98,45 @@ public:
      */
     void setMaxInterval(uint32_t ms) { _maxInterval = ms; }
     
+    /**
+     * @brief 设置最小扫描间隔（高速扫描间隔）
+     * 
+     * @param ms 最小间隔时间，单位ms，默认200ms
+     */
+    void setMinInterval(uint32_t ms) { _minInterval = ms; }
+    
+    /**
+     * @brief 设置降频前需要的连续稳定次数
+     * 
+     * @param n 连续稳定次数，默认5
+     */
+    void setStableCount(uint8_t n) { _stableTarget = n; }
+    
     /**
      * @brief 基于电流变化调整扫描频率
      * 
      * 核心算法：
      * - 电流变化超过阈值 → 立即提速到200ms
      * - 连续5次稳定 → 逐步增加间隔（×退避系数）
-     * - 限制范围：200ms-5000ms
+     * - 限制范围：最小间隔-最大间隔（默认200ms-5000ms）
      * 
      * @param i_ma 当前总电流值，单位mA
      */
     void updateCurrent(float i_ma);
     
     /**
-     * @brief 多维状态变化检测
+     * @brief 需要触发高速扫描的事件掩码
      * 
-     * 监控快充协议和设备连接状态变化
+     * 快充协议建立/退出、设备插入/拔出
+     */
+    static const uint32_t EVENT_MASK = SW3538_EVT_MASK_PATH | SW3538_EVT_MASK_FAST;
+    
+    /**
+     * @brief 事件总线回调
      * 
-     * @param fastChargeStatus 快充协议状态（true=已建立快充）
-     * @param path1Online 第一通路连接状态（true=设备已连接）
-     * @param path2Online 第二通路连接状态（true=设备已连接）
+     * 以EVENT_MASK订阅，ctx为AdaptiveScan实例，收到事件即切换到高速扫描
      */
-    void updateState(bool fastChargeStatus, bool path1Online, bool path2Online);
+    static void onEvent(const SW3538_Event& evt, void* ctx);
     
     // ===== 调试和状态获取函数 =====
     
@@ -112,11 +163,18 @@ public:
      * @return 最大扫描间隔，单位ms
      */
     uint32_t getMaxInterval() const { return _maxInterval; }
+    
+    /**
+     * @brief 获取最近一次tick()扫描相对计划时间的延迟
+     * @return 延迟，单位ms
+     */
+    uint32_t getLastLatenessMs() const { return _lateMs; }
 
 private:
     // ===== 核心控制参数 =====
     uint32_t _interval;      // 当前扫描间隔，动态调整
     uint32_t _lastTick;      // 上次扫描时间戳
+    uint32_t _lateMs = 0;    // 最近一次扫描的延迟
     float    _lastI = 0.0f;  // 上次记录的电流值（mA）
     
     // ===== 算法参数 =====
@@ -124,11 +182,8 @@ private:
     uint8_t  _stableCnt = 0;   // 连续稳定计数器
     uint8_t  _backoff = 2;     // 退避系数，稳定后×2
     uint32_t _maxInterval = 5000;  // 最大扫描间隔，默认5000ms（5秒）
-    
-    // ===== 状态跟踪变量 =====
-    bool _lastFastChargeStatus = false;  // 上次快充状态
-    bool _lastPath1Online = false;     // 上次第一通路状态
-    bool _lastPath2Online = false;     // 上次第二通路状态
+    uint32_t _minInterval = 200;   // 最小扫描间隔，默认200ms
+    uint8_t  _stableTarget = 5;    // 降频前需要的连续稳定次数
 };
 
 #endif
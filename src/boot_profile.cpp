@@ -0,0 +1,78 @@
+/*
+ * boot_profile.cpp - 快速启动：分阶段计时与启动影子实现
+ */
+
+#include "boot_profile.h"
+
+#ifdef ARDUINO
+#include <Preferences.h>
+#endif
+
+#define BOOT_NVS_NAMESPACE  "boot"
+#define BOOT_NVS_KEY        "shadow"
+
+BootProfiler bootProfiler;
+
+static const char* const PHASE_NAMES[BOOT_PHASE_COUNT] = {
+    "shadow", "driver", "oled", "first-read", "first-frame", "services", "diag"
+};
+
+void BootProfiler::begin() {
+    _startUs = micros();
+    _lastUs = _startUs;
+}
+
+void BootProfiler::mark(BootPhase phase) {
+    uint32_t now = micros();
+    _phaseUs[phase] += now - _lastUs;
+    _lastUs = now;
+    if (phase == BOOT_FIRST_FRAME) _firstFrameUs = now;
+}
+
+void BootProfiler::printReport(Print& serial) const {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "[Boot] setup entry at %luus", (unsigned long)_startUs);
+    serial.println(buf);
+    for (uint8_t p = 0; p < BOOT_PHASE_COUNT; p++) {
+        snprintf(buf, sizeof(buf), "[Boot] %-11s %8luus", PHASE_NAMES[p], (unsigned long)_phaseUs[p]);
+        serial.println(buf);
+    }
+    if (_firstFrameUs == 0) {
+        serial.println("[Boot] no first frame");   // 首帧读取失败
+        return;
+    }
+    snprintf(buf, sizeof(buf), "[Boot] first frame at %luus (%luus after setup entry)",
+             (unsigned long)_firstFrameUs, (unsigned long)(_firstFrameUs - _startUs));
+    serial.println(buf);
+}
+
+bool loadBootShadow(BootShadow& shadow) {
+#ifdef ARDUINO
+    Preferences prefs;
+    if (!prefs.begin(BOOT_NVS_NAMESPACE, true)) return false;
+    bool ok = prefs.getBytesLength(BOOT_NVS_KEY) == sizeof(shadow) &&
+              prefs.getBytes(BOOT_NVS_KEY, &shadow, sizeof(shadow)) == sizeof(shadow);
+    prefs.end();
+    return ok && shadow.magic == BOOT_SHADOW_MAGIC;
+#else
+    (void)shadow;
+    return false;
+#endif
+}
+
+bool saveBootShadow(const BootShadow& shadow) {
+#ifdef ARDUINO
+    BootShadow stored;
+    if (loadBootShadow(stored) && memcmp(&stored, &shadow, sizeof(shadow)) == 0) {
+        return true;  // 未变化，不写Flash
+    }
+    Preferences prefs;
+    if (!prefs.begin(BOOT_NVS_NAMESPACE, false)) return false;
+    size_t n = prefs.putBytes(BOOT_NVS_KEY, &shadow, sizeof(shadow));
+    prefs.end();
+    return n == sizeof(shadow);
+#else
+    (void)shadow;
+    return false;
+#endif
+}
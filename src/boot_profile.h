@@ -0,0 +1,94 @@
+/*
+ * boot_profile.h - 快速启动：分阶段计时与启动影子
+ *
+ * 设计说明：
+ * 1. 启动过程按阶段打点（micros()），首帧显示后统一输出各阶段耗时，
+ *    打点本身不产生串口输出，不影响被测时间
+ * 2. FAST_BOOT下首帧之前不做testI2CAddress()探测，也不输出驱动日志（静音到首帧显示），
+ *    直接读取首帧；首帧失败再回退到探测和扫描。启动影子保存在NVS，只含上次通信成功的
+ *    芯片地址和版本，用于决定首帧之后是否补做一次探测：影子缺失或地址/版本不一致时探测并更新。
+ *    扫描、过采样、I2C时钟等配置不在影子中，由参数注册表（params.applyAll()）
+ *    在sw3538.begin()之前从NVS恢复
+ * 3. 影子只在内容变化时写入，且推迟到首帧显示之后
+ *
+ * FAST_BOOT=0恢复原有的顺序启动流程（先打印系统信息、启动画面、探测，再读首帧）
+ */
+
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <Arduino.h>
+
+#ifndef FAST_BOOT
+#define FAST_BOOT 1
+#endif
+
+enum BootPhase : uint8_t {
+    BOOT_SHADOW = 0,      // 读取运行时参数和启动影子
+    BOOT_DRIVER,          // I2C初始化、启动首次ADC转换
+    BOOT_OLED,            // OLED初始化（与ADC转换重叠）
+    BOOT_FIRST_READ,      // 首次readAllData()
+    BOOT_FIRST_FRAME,     // 发布快照并显示首帧
+    BOOT_SERVICES,        // 能量、日志、事件、守护等模块初始化
+    BOOT_DIAG,            // 推迟的诊断输出、影子保存
+    BOOT_PHASE_COUNT
+};
+
+/**
+ * @brief 启动影子：只记录探测结果，不含运行配置
+ */
+struct BootShadow {
+    uint16_t magic;
+    uint8_t address;      // 通信成功的I2C地址
+    uint8_t chipVersion;
+};
+
+#define BOOT_SHADOW_MAGIC  0x5342   // "SB"
+
+/**
+ * @class BootProfiler
+ * @brief 启动阶段计时
+ */
+class BootProfiler {
+public:
+    BootProfiler() : _startUs(0), _lastUs(0) { memset(_phaseUs, 0, sizeof(_phaseUs)); }
+
+    /**
+     * @brief setup()入口调用，记录起点
+     */
+    void begin();
+
+    /**
+     * @brief 记录一个阶段结束，耗时为距上次打点的时间
+     */
+    void mark(BootPhase phase);
+
+    /**
+     * @brief 程序启动到首帧显示的时间（us），未显示首帧时为0
+     */
+    uint32_t firstFrameUs() const { return _firstFrameUs; }
+
+    void printReport(Print& serial) const;
+
+private:
+    uint32_t _startUs;        // setup()入口时刻（程序启动后）
+    uint32_t _lastUs;
+    uint32_t _firstFrameUs = 0;
+    uint32_t _phaseUs[BOOT_PHASE_COUNT];
+};
+
+/**
+ * @brief 读取启动影子
+ *
+ * @return 影子存在且有效
+ */
+bool loadBootShadow(BootShadow& shadow);
+
+/**
+ * @brief 写入启动影子（与已存内容相同时不写）
+ */
+bool saveBootShadow(const BootShadow& shadow);
+
+extern BootProfiler bootProfiler;
+
+#endif // BOOT_PROFILE_H
@@ -0,0 +1,126 @@
+/*
+ * burst_capture.cpp - 触发式高速突发采集实现
+ */
+
+#include "burst_capture.h"
+
+BurstCapture::BurstCapture()
+    : _driver(nullptr), _state(BURST_IDLE), _channel(SW3538_ADC_CH_NONE),
+      _triggerMask(BURST_DEFAULT_TRIGGER), _prePeriodUs(2000), _lastPreUs(0), _triggerUs(0),
+      _preHead(0), _preCount(0), _postCount(0), _errors(0) {
+}
+
+void BurstCapture::begin(SW3538& driver, SW3538EventBus& bus) {
+    _driver = &driver;
+    bus.subscribe(SW3538_EVT_MASK_ALL, onEvent, this);
+}
+
+void BurstCapture::arm(uint8_t channel, uint32_t triggerMask, uint32_t prePeriodUs) {
+    if (_driver == nullptr) return;
+    _channel = channel;
+    _triggerMask = triggerMask;
+    _prePeriodUs = prePeriodUs;
+    _preHead = 0;
+    _preCount = 0;
+    _postCount = 0;
+    _errors = 0;
+    _lastPreUs = micros() - prePeriodUs;
+    _state = BURST_ARMED;
+}
+
+void BurstCapture::disarm() {
+    if (_driver) _driver->releaseFastRead(this);
+    _state = BURST_IDLE;
+}
+
+void BurstCapture::trigger() {
+    if (_state == BURST_ARMED) {
+        _state = BURST_TRIGGERED;
+    }
+}
+
+void BurstCapture::onEvent(const SW3538_Event& evt, void* ctx) {
+    BurstCapture* self = static_cast<BurstCapture*>(ctx);
+    if (self->_state == BURST_ARMED && (self->_triggerMask & SW3538_EVT_MASK(evt.type))) {
+        self->_state = BURST_TRIGGERED;
+    }
+}
+
+void BurstCapture::service() {
+    if (_state != BURST_ARMED && _state != BURST_TRIGGERED) return;
+
+    // 通道被守护占用时暂停；readAllData()会改变通道选择，需要时重新准备
+    if (!_driver->claimFastRead(this)) return;
+    if (_driver->getFastChannel() != _channel && !_driver->beginFastRead(_channel)) {
+        return;
+    }
+
+    if (_state == BURST_TRIGGERED) {
+        capturePost();
+        return;
+    }
+
+    uint32_t now = micros();
+    if (now - _lastPreUs < _prePeriodUs) return;
+    _lastPreUs = now;
+
+    uint16_t raw;
+    if (!_driver->readFast(raw)) {
+        _errors++;
+        return;
+    }
+    _preRaw[_preHead] = raw;
+    _preUs[_preHead] = now;
+    _preHead = (_preHead + 1) % BURST_PRE_SAMPLES;
+    if (_preCount < BURST_PRE_SAMPLES) _preCount++;
+}
+
+// 阻塞采集：仅两次单字节读，无解锁、无延时
+// 放弃条件只计触发后的读失败，预触发窗口内的失败不缩短后触发采集
+void BurstCapture::capturePost() {
+    _triggerUs = micros();
+    _postCount = 0;
+    uint16_t postErrors = 0;
+    while (_postCount < BURST_POST_SAMPLES) {
+        uint16_t raw;
+        if (!_driver->readFast(raw)) {
+            _errors++;
+            if (++postErrors > BURST_POST_SAMPLES) break;  // 总线故障，放弃
+            continue;
+        }
+        _postRaw[_postCount] = raw;
+        _postUs[_postCount] = micros();
+        _postCount++;
+    }
+    _driver->releaseFastRead(this);
+    _state = BURST_DONE;
+}
+
+uint32_t BurstCapture::getPostPeriodUs() const {
+    if (_postCount < 2) return 0;
+    return (_postUs[_postCount - 1] - _postUs[0]) / (_postCount - 1);
+}
+
+void BurstCapture::dump(Print& serial) {
+    if (_state != BURST_DONE) return;
+
+    char buf[40];
+    snprintf(buf, sizeof(buf), "# burst ch:%u pre:%u post:%u err:%u",
+             _channel, _preCount, _postCount, _errors);
+    serial.println(buf);
+    serial.println("t_us,raw,value");
+
+    uint16_t first = (_preHead + BURST_PRE_SAMPLES - _preCount) % BURST_PRE_SAMPLES;
+    for (uint16_t i = 0; i < _preCount; i++) {
+        uint16_t idx = (first + i) % BURST_PRE_SAMPLES;
+        snprintf(buf, sizeof(buf), "%ld,%u,%.1f", (long)(_preUs[idx] - _triggerUs), _preRaw[idx],
+                 SW3538::adcToValue(_channel, _preRaw[idx]));
+        serial.println(buf);
+    }
+    for (uint16_t i = 0; i < _postCount; i++) {
+        snprintf(buf, sizeof(buf), "%ld,%u,%.1f", (long)(_postUs[i] - _triggerUs), _postRaw[i],
+                 SW3538::adcToValue(_channel, _postRaw[i]));
+        serial.println(buf);
+    }
+    _state = BURST_IDLE;
+}
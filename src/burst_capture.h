@@ -0,0 +1,126 @@
+/*
+ * burst_capture.h - 触发式高速突发采集
+ *
+ * 设计说明：
+ * 1. 协议握手（QC3步进、PPS调压）和插入冲击电流远快于200ms扫描周期
+ * 2. 布防后在主循环空闲时持续快速采样单个ADC通道，写入预触发环形缓冲区
+ * 3. 事件总线触发（接入、协议变化、电流越限）后，以总线允许的最快速度
+ *    阻塞采集后触发样本，完成后可导出
+ * 4. 缓冲区全部预分配
+ *
+ * 布防期间持续占用I2C总线，readAllData()之间会重新选通通道。快速读取通道经驱动的
+ * claimFastRead()仲裁：ProtectionGuard守护期间抢占通道，突发采集暂停（已触发的采集推迟到守护结束），
+ * 两者不会互相重新选通
+ */
+
+#ifndef BURST_CAPTURE_H
+#define BURST_CAPTURE_H
+
+#include <Arduino.h>
+#include "SW3538.h"
+#include "sw3538_events.h"
+
+// 预触发样本数
+#ifndef BURST_PRE_SAMPLES
+#define BURST_PRE_SAMPLES    128
+#endif
+
+// 后触发样本数
+#ifndef BURST_POST_SAMPLES
+#define BURST_POST_SAMPLES   512
+#endif
+
+// 默认触发事件
+#define BURST_DEFAULT_TRIGGER (SW3538_EVT_MASK(SW3538_EVT_PATH_ONLINE) | \
+                               SW3538_EVT_MASK(SW3538_EVT_PROTOCOL_CHANGE) | \
+                               SW3538_EVT_MASK(SW3538_EVT_CURRENT_ABOVE))
+
+enum BurstState : uint8_t {
+    BURST_IDLE = 0,       // 未布防
+    BURST_ARMED,          // 预触发采样中
+    BURST_TRIGGERED,      // 已触发，等待service()采集
+    BURST_DONE            // 采集完成，等待导出
+};
+
+/**
+ * @class BurstCapture
+ * @brief 单通道突发采集器
+ */
+class BurstCapture {
+public:
+    BurstCapture();
+
+    /**
+     * @brief 关联驱动并订阅事件总线
+     */
+    void begin(SW3538& driver, SW3538EventBus& bus);
+
+    /**
+     * @brief 布防
+     *
+     * @param channel ADC通道（SW3538_ADC_CH_*）
+     * @param triggerMask 触发事件掩码
+     * @param prePeriodUs 预触发采样最小间隔，单位us
+     */
+    void arm(uint8_t channel, uint32_t triggerMask = BURST_DEFAULT_TRIGGER, uint32_t prePeriodUs = 2000);
+
+    /**
+     * @brief 撤防并释放通道
+     */
+    void disarm();
+
+    /**
+     * @brief 手动触发
+     */
+    void trigger();
+
+    /**
+     * @brief 主循环中调用
+     *
+     * ARMED：按预触发间隔取一个样本；TRIGGERED：阻塞采集全部后触发样本
+     */
+    void service();
+
+    BurstState getState() const { return _state; }
+    bool isDone() const { return _state == BURST_DONE; }
+
+    /**
+     * @brief 以CSV导出（t_us,raw,value），t=0为触发时刻；导出后回到IDLE
+     */
+    void dump(Print& serial);
+
+    /**
+     * @brief 后触发平均采样间隔，单位us
+     */
+    uint32_t getPostPeriodUs() const;
+
+    uint16_t getPostCount() const { return _postCount; }
+    uint16_t getErrors() const { return _errors; }
+
+    static void onEvent(const SW3538_Event& evt, void* ctx);
+
+private:
+    SW3538* _driver;
+    volatile BurstState _state;
+    uint8_t _channel;
+    uint32_t _triggerMask;
+    uint32_t _prePeriodUs;
+    uint32_t _lastPreUs;
+    uint32_t _triggerUs;
+
+    // 预触发环形缓冲区
+    uint16_t _preRaw[BURST_PRE_SAMPLES];
+    uint32_t _preUs[BURST_PRE_SAMPLES];
+    uint16_t _preHead;
+    uint16_t _preCount;
+
+    // 后触发线性缓冲区
+    uint16_t _postRaw[BURST_POST_SAMPLES];
+    uint32_t _postUs[BURST_POST_SAMPLES];
+    uint16_t _postCount;
+    uint16_t _errors;         // 预触发和后触发的读失败合计
+
+    void capturePost();
+};
+
+#endif // BURST_CAPTURE_H
@@ -0,0 +1,177 @@
+/*
+ * channel_stats.cpp - 各测量通道的流式统计实现
+ */
+
+#include "channel_stats.h"
+
+// ===== P2Quantile =====
+
+void P2Quantile::reset(float p) {
+    _p = p;
+    _count = 0;
+    for (uint8_t i = 0; i < 5; i++) {
+        _q[i] = 0.0f;
+        _n[i] = i;
+    }
+    _np[0] = 0.0f;
+    _np[1] = 2.0f * p;
+    _np[2] = 4.0f * p;
+    _np[3] = 2.0f + 2.0f * p;
+    _np[4] = 4.0f;
+    _dn[0] = 0.0f;
+    _dn[1] = p / 2.0f;
+    _dn[2] = p;
+    _dn[3] = (1.0f + p) / 2.0f;
+    _dn[4] = 1.0f;
+}
+
+void P2Quantile::add(float x) {
+    // 前5个样本：插入排序
+    if (_count < 5) {
+        uint8_t i = _count++;
+        while (i > 0 && _q[i - 1] > x) {
+            _q[i] = _q[i - 1];
+            i--;
+        }
+        _q[i] = x;
+        return;
+    }
+    _count++;
+
+    // 定位所在区间并更新端点
+    uint8_t k;
+    if (x < _q[0]) {
+        _q[0] = x;
+        k = 0;
+    } else if (x < _q[1]) {
+        k = 0;
+    } else if (x < _q[2]) {
+        k = 1;
+    } else if (x < _q[3]) {
+        k = 2;
+    } else if (x <= _q[4]) {
+        k = 3;
+    } else {
+        _q[4] = x;
+        k = 3;
+    }
+
+    for (uint8_t i = k + 1; i < 5; i++) _n[i]++;
+    for (uint8_t i = 0; i < 5; i++) _np[i] += _dn[i];
+
+    // 调整中间3个标记
+    for (uint8_t i = 1; i < 4; i++) {
+        float d = _np[i] - _n[i];
+        if ((d >= 1.0f && _n[i + 1] - _n[i] > 1) || (d <= -1.0f && _n[i - 1] - _n[i] < -1)) {
+            int32_t s = d >= 0 ? 1 : -1;
+            float qi = _q[i];
+            float qp = qi + (float)s / (_n[i + 1] - _n[i - 1]) *
+                       ((_n[i] - _n[i - 1] + s) * (_q[i + 1] - qi) / (_n[i + 1] - _n[i]) +
+                        (_n[i + 1] - _n[i] - s) * (qi - _q[i - 1]) / (_n[i] - _n[i - 1]));
+            if (_q[i - 1] < qp && qp < _q[i + 1]) {
+                _q[i] = qp;           // 抛物线插值
+            } else {
+                _q[i] = qi + s * (_q[i + s] - qi) / (_n[i + s] - _n[i]);   // 线性插值
+            }
+            _n[i] += s;
+        }
+    }
+}
+
+float P2Quantile::value() const {
+    if (_count == 0) return 0.0f;
+    if (_count < 5) {
+        // 样本不足时直接取有序样本
+        uint8_t idx = (uint8_t)(_p * (_count - 1) + 0.5f);
+        return _q[idx];
+    }
+    return _q[2];
+}
+
+// ===== ChannelStats =====
+
+void ChannelStats::reset() {
+    _count = 0;
+    _mean = 0.0f;
+    _m2 = 0.0f;
+    _min = 0.0f;
+    _max = 0.0f;
+    _q50.reset(0.50f);
+    _q95.reset(0.95f);
+    _q99.reset(0.99f);
+}
+
+void ChannelStats::add(float x) {
+    _count++;
+    if (_count == 1) {
+        _min = _max = x;
+    } else {
+        if (x < _min) _min = x;
+        if (x > _max) _max = x;
+    }
+
+    float delta = x - _mean;
+    _mean += delta / _count;
+    _m2 += delta * (x - _mean);
+
+    _q50.add(x);
+    _q95.add(x);
+    _q99.add(x);
+}
+
+// ===== StreamingStats =====
+
+StreamingStats::StreamingStats() : _windowMs(60000), _windowStart(0), _started(false) {
+    for (uint8_t c = 0; c < STATS_CH_COUNT; c++) {
+        _current[c].reset();
+        _completed[c].reset();
+    }
+}
+
+bool StreamingStats::update(uint32_t timeMs, const SW3538_Data_t& data) {
+    bool rolled = false;
+
+    if (!_started) {
+        _windowStart = timeMs;
+        _started = true;
+    } else if (timeMs - _windowStart >= _windowMs) {
+        for (uint8_t c = 0; c < STATS_CH_COUNT; c++) {
+            _completed[c] = _current[c];
+            _current[c].reset();
+        }
+        _windowStart = timeMs;
+        rolled = true;
+    }
+
+    _current[STATS_CH_CURRENT1].add(data.currentPath1mA);
+    _current[STATS_CH_CURRENT2].add(data.currentPath2mA);
+    _current[STATS_CH_VOUT].add(data.outputVoltagemV);
+    _current[STATS_CH_VIN].add(data.inputVoltagemV);
+    if (data.ntcTemperatureC != -999) {
+        _current[STATS_CH_TEMP].add(data.ntcTemperatureC);
+    }
+
+    return rolled;
+}
+
+const ChannelStats& StreamingStats::get(StatsChannel ch, bool completed) const {
+    return completed ? _completed[ch] : _current[ch];
+}
+
+const char* StreamingStats::getChannelName(StatsChannel ch) {
+    static const char* names[] = { "I1(mA)", "I2(mA)", "Vout(mV)", "Vin(mV)", "Temp(C)" };
+    return ch < STATS_CH_COUNT ? names[ch] : "UNKNOWN";
+}
+
+void StreamingStats::printStats(Print& serial) const {
+    char buf[96];
+    serial.println("--- Channel Stats ---");
+    for (uint8_t c = 0; c < STATS_CH_COUNT; c++) {
+        const ChannelStats& s = _completed[c];
+        snprintf(buf, sizeof(buf), "%-8s n:%lu min:%.0f max:%.0f mean:%.1f sd:%.1f p50:%.0f p95:%.0f p99:%.0f",
+                 getChannelName((StatsChannel)c), (unsigned long)s.count(),
+                 s.min(), s.max(), s.mean(), s.stddev(), s.p50(), s.p95(), s.p99());
+        serial.println(buf);
+    }
+    serial.println("---------------------");
+}
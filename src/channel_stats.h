@@ -0,0 +1,120 @@
+/*
+ * channel_stats.h - 各测量通道的流式统计
+ *
+ * 设计说明：
+ * 1. Welford算法计算均值/方差，数值稳定，单次更新O(1)
+ * 2. P²算法（Jain & Chlamtac）估计p50/p95/p99，每个分位数仅5个标记点
+ * 3. 滚动窗口采用翻转方式：当前窗口累计，到期后整体移入"上一窗口"
+ * 4. 全部固定内存，无排序、无缓冲区
+ */
+
+#ifndef CHANNEL_STATS_H
+#define CHANNEL_STATS_H
+
+#include <Arduino.h>
+#include "SW3538.h"
+
+// 统计通道
+enum StatsChannel : uint8_t {
+    STATS_CH_CURRENT1 = 0,   // 通路1电流 mA
+    STATS_CH_CURRENT2,       // 通路2电流 mA
+    STATS_CH_VOUT,           // 输出电压 mV
+    STATS_CH_VIN,            // 输入电压 mV
+    STATS_CH_TEMP,           // 温度 °C
+    STATS_CH_COUNT
+};
+
+/**
+ * @class P2Quantile
+ * @brief P²单分位数估计器
+ */
+class P2Quantile {
+public:
+    void reset(float p);
+    void add(float x);
+    float value() const;
+
+private:
+    float _p;
+    uint32_t _count;
+    float _q[5];      // 标记高度
+    int32_t _n[5];    // 标记位置
+    float _np[5];     // 期望位置
+    float _dn[5];     // 期望位置增量
+};
+
+/**
+ * @brief 单通道统计
+ */
+class ChannelStats {
+public:
+    void reset();
+    void add(float x);
+
+    uint32_t count() const { return _count; }
+    float mean() const { return _mean; }
+    float variance() const { return _count > 1 ? _m2 / (_count - 1) : 0.0f; }
+    float stddev() const { return sqrtf(variance()); }
+    float min() const { return _min; }
+    float max() const { return _max; }
+    float p50() const { return _q50.value(); }
+    float p95() const { return _q95.value(); }
+    float p99() const { return _q99.value(); }
+
+private:
+    uint32_t _count;
+    float _mean;
+    float _m2;
+    float _min;
+    float _max;
+    P2Quantile _q50;
+    P2Quantile _q95;
+    P2Quantile _q99;
+};
+
+/**
+ * @class StreamingStats
+ * @brief 全部通道的窗口化流式统计
+ */
+class StreamingStats {
+public:
+    StreamingStats();
+
+    /**
+     * @brief 设置窗口长度
+     *
+     * @param ms 窗口时长，单位ms，默认60s
+     */
+    void setWindow(uint32_t ms) { _windowMs = ms; }
+
+    /**
+     * @brief 输入一次采样
+     *
+     * @return true 本次采样前完成了一个窗口（上一窗口统计已更新）
+     */
+    bool update(uint32_t timeMs, const SW3538_Data_t& data);
+
+    /**
+     * @brief 获取通道统计
+     *
+     * @param ch 通道
+     * @param completed true返回上一完整窗口，false返回当前进行中的窗口
+     */
+    const ChannelStats& get(StatsChannel ch, bool completed = true) const;
+
+    /**
+     * @brief 打印上一完整窗口的统计
+     */
+    void printStats(Print& serial) const;
+
+    static const char* getChannelName(StatsChannel ch);
+
+private:
+    ChannelStats _current[STATS_CH_COUNT];
+    ChannelStats _completed[STATS_CH_COUNT];
+    uint32_t _windowMs;
+    uint32_t _windowStart;
+    bool _started;
+};
+
+#endif // CHANNEL_STATS_H
@@ -0,0 +1,148 @@
+/*
+ * charge_session.cpp - 充电会话检测与统计实现
+ */
+
+#include "charge_session.h"
+
+#define SESSION_EVENT_MASK (SW3538_EVT_MASK_PATH | \
+                            SW3538_EVT_MASK(SW3538_EVT_PROTOCOL_CHANGE) | \
+                            SW3538_EVT_MASK(SW3538_EVT_PD_VERSION_CHANGE))
+
+float ChargeSession::averagePowerW() const {
+    uint32_t ms = durationMs();
+    if (ms == 0) return 0.0f;
+    // energy2nJ / 2 / ms = uW
+    return (float)((double)energy2nJ / 2.0 / ms / 1e6);
+}
+
+ChargeSessionTracker::ChargeSessionTracker()
+    : _head(0), _count(0), _meter(nullptr), _lastTimeMs(0), _lastFastCharge(false) {
+    _active[0] = _active[1] = -1;
+    _startEnergy[0] = _startEnergy[1] = 0;
+}
+
+void ChargeSessionTracker::begin(SW3538EventBus& bus, const EnergyMeter& meter) {
+    _meter = &meter;
+    bus.subscribe(SESSION_EVENT_MASK, onEvent, this);
+}
+
+int64_t ChargeSessionTracker::meterEnergy(uint8_t path) const {
+    return _meter ? _meter->getCounter(path, false).energy2nJ : 0;
+}
+
+const ChargeSession& ChargeSessionTracker::get(size_t index) const {
+    size_t first = (_head + CHARGE_SESSION_MAX - _count) % CHARGE_SESSION_MAX;
+    return _sessions[(first + index) % CHARGE_SESSION_MAX];
+}
+
+const ChargeSession* ChargeSessionTracker::getActive(uint8_t path) const {
+    int8_t idx = _active[path == 2 ? 1 : 0];
+    return idx < 0 ? nullptr : &_sessions[idx];
+}
+
+void ChargeSessionTracker::markProtocol(ChargeSession& s, uint32_t timeMs, const SW3538_Data_t& data) {
+    uint32_t offset = timeMs - s.startMs;
+    uint8_t slot;
+    if (s.timelineCount > 0 && s.timeline[s.timelineCount - 1].offsetMs == offset) {
+        slot = s.timelineCount - 1;     // 同一次采样的协议和PD版本变化合并为一条
+    } else {
+        slot = s.timelineCount < CHARGE_SESSION_TIMELINE ? s.timelineCount++ : CHARGE_SESSION_TIMELINE - 1;
+    }
+    s.timeline[slot].offsetMs = offset;
+    s.timeline[slot].protocol = data.fastChargeProtocol;
+    s.timeline[slot].pdVersion = data.pdVersion;
+}
+
+void ChargeSessionTracker::startSession(uint8_t path, uint32_t timeMs, const SW3538_Data_t& data) {
+    uint8_t p = path - 1;
+    if (_active[p] >= 0) endSession(path, timeMs);
+
+    // 覆盖最旧会话时，若其仍在进行则一并失效
+    for (uint8_t i = 0; i < 2; i++) {
+        if (_active[i] == _head) _active[i] = -1;
+    }
+
+    ChargeSession& s = _sessions[_head];
+    memset(&s, 0, sizeof(s));
+    s.startMs = timeMs;
+    s.endMs = timeMs;
+    s.path = path;
+    s.active = true;
+    markProtocol(s, timeMs, data);
+
+    _active[p] = _head;
+    _startEnergy[p] = meterEnergy(path);
+    _head = (_head + 1) % CHARGE_SESSION_MAX;
+    if (_count < CHARGE_SESSION_MAX) _count++;
+}
+
+void ChargeSessionTracker::endSession(uint8_t path, uint32_t timeMs) {
+    uint8_t p = path - 1;
+    if (_active[p] < 0) return;
+    ChargeSession& s = _sessions[_active[p]];
+    s.endMs = timeMs;
+    s.energy2nJ = meterEnergy(path) - _startEnergy[p];
+    s.active = false;
+    _active[p] = -1;
+}
+
+void ChargeSessionTracker::onEvent(const SW3538_Event& evt, void* ctx) {
+    ChargeSessionTracker* self = static_cast<ChargeSessionTracker*>(ctx);
+
+    switch (evt.type) {
+        case SW3538_EVT_PATH_ONLINE:
+            self->startSession(evt.path, evt.timeMs, *evt.sample);
+            break;
+        case SW3538_EVT_PATH_OFFLINE:
+            self->endSession(evt.path, evt.timeMs);
+            break;
+        case SW3538_EVT_PROTOCOL_CHANGE:
+        case SW3538_EVT_PD_VERSION_CHANGE:
+            for (uint8_t p = 0; p < 2; p++) {
+                if (self->_active[p] >= 0) {
+                    markProtocol(self->_sessions[self->_active[p]], evt.timeMs, *evt.sample);
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void ChargeSessionTracker::update(uint32_t timeMs, const SW3538_Data_t& data) {
+    const int32_t current[2] = { data.currentPath1mA, data.currentPath2mA };
+    uint32_t dt = timeMs - _lastTimeMs;
+
+    for (uint8_t p = 0; p < 2; p++) {
+        if (_active[p] < 0) continue;
+        ChargeSession& s = _sessions[_active[p]];
+
+        uint32_t powermW = current[p] > 0 ? (uint32_t)data.outputVoltagemV * (uint32_t)current[p] / 1000 : 0;
+        if (powermW > s.peakPowermW) s.peakPowermW = powermW;
+        if (_lastFastCharge && s.samples > 0) s.fastChargeMs += dt;
+
+        s.samples++;
+        s.endMs = timeMs;
+        s.energy2nJ = meterEnergy(p + 1) - _startEnergy[p];
+    }
+
+    _lastTimeMs = timeMs;
+    _lastFastCharge = data.fastChargeStatus;
+}
+
+void ChargeSessionTracker::printSessions(Print& serial) const {
+    char buf[80];
+    serial.println("--- Charge Sessions ---");
+    for (size_t i = 0; i < _count; i++) {
+        const ChargeSession& s = get(i);
+        const ProtocolMark& last = s.timeline[s.timelineCount ? s.timelineCount - 1 : 0];
+        snprintf(buf, sizeof(buf), "P%u %s %lus peak:%.1fW avg:%.1fW %.1fmWh fast:%lus %s",
+                 s.path, s.active ? "*" : " ",
+                 (unsigned long)(s.durationMs() / 1000),
+                 s.peakPowermW / 1000.0f, s.averagePowerW(), s.energymWh(),
+                 (unsigned long)(s.fastChargeMs / 1000),
+                 SW3538::getProtocolName(last.protocol));
+        serial.println(buf);
+    }
+    serial.println("-----------------------");
+}
@@ -0,0 +1,114 @@
+/*
+ * charge_session.h - 充电会话检测与统计
+ *
+ * 设计说明：
+ * 1. 会话起止由事件总线的通路接入/拔出事件驱动，不重复比较采样
+ * 2. 每次采样只做O(1)累加：峰值功率、快充时长、能量（取EnergyMeter差值）
+ * 3. 固定容量会话表（环形），满时覆盖最旧会话
+ * 4. 协议/PD版本变化记录在每个进行中会话的时间线上（容量有限，超出后只保留最后一次）
+ */
+
+#ifndef CHARGE_SESSION_H
+#define CHARGE_SESSION_H
+
+#include <Arduino.h>
+#include "SW3538.h"
+#include "sw3538_events.h"
+#include "energy_meter.h"
+
+#ifndef CHARGE_SESSION_MAX
+#define CHARGE_SESSION_MAX        16
+#endif
+
+#ifndef CHARGE_SESSION_TIMELINE
+#define CHARGE_SESSION_TIMELINE   6
+#endif
+
+/**
+ * @brief 协议时间线条目
+ */
+struct ProtocolMark {
+    uint32_t offsetMs;                      // 相对会话开始的时间
+    SW3538_FastChargeProtocol protocol;
+    uint8_t pdVersion;
+};
+
+/**
+ * @brief 单次充电会话
+ */
+struct ChargeSession {
+    uint32_t startMs;
+    uint32_t endMs;                         // 进行中时为最近一次采样时间
+    uint8_t path;                           // 1或2
+    bool active;
+    uint8_t timelineCount;
+    ProtocolMark timeline[CHARGE_SESSION_TIMELINE];
+    uint32_t peakPowermW;
+    uint32_t fastChargeMs;                  // 快充状态累计时长
+    uint32_t samples;
+    int64_t energy2nJ;                      // 会话能量（EnergyMeter定点单位）
+
+    uint32_t durationMs() const { return endMs - startMs; }
+    float energymWh() const { return EnergyMeter::toMilliwattHours(energy2nJ); }
+    float averagePowerW() const;
+};
+
+/**
+ * @class ChargeSessionTracker
+ * @brief 会话跟踪器
+ *
+ * 使用方式：
+ * 1. begin()时关联事件总线和能量计
+ * 2. 每次采样在事件分发后调用update()
+ */
+class ChargeSessionTracker {
+public:
+    ChargeSessionTracker();
+
+    /**
+     * @brief 订阅事件并关联能量计
+     */
+    void begin(SW3538EventBus& bus, const EnergyMeter& meter);
+
+    /**
+     * @brief 每次采样调用，O(1)
+     */
+    void update(uint32_t timeMs, const SW3538_Data_t& data);
+
+    /**
+     * @brief 会话表中的会话数
+     */
+    size_t count() const { return _count; }
+
+    /**
+     * @brief 按时间顺序获取会话（0为最旧）
+     */
+    const ChargeSession& get(size_t index) const;
+
+    /**
+     * @brief 获取通路当前进行中的会话，无则返回nullptr
+     */
+    const ChargeSession* getActive(uint8_t path) const;
+
+    void printSessions(Print& serial) const;
+
+    static void onEvent(const SW3538_Event& evt, void* ctx);
+
+private:
+    ChargeSession _sessions[CHARGE_SESSION_MAX];
+    uint8_t _head;                  // 下一个写入位置
+    uint8_t _count;
+    int8_t _active[2];              // 各通路进行中会话的下标，-1表示无
+
+    const EnergyMeter* _meter;
+    int64_t _startEnergy[2];        // 会话开始时能量计累计值
+    uint32_t _lastTimeMs;
+    bool _lastFastCharge;
+
+    int64_t meterEnergy(uint8_t path) const;
+    void startSession(uint8_t path, uint32_t timeMs, const SW3538_Data_t& data);
+    void endSession(uint8_t path, uint32_t timeMs);
+    static void markProtocol(ChargeSession& s, uint32_t timeMs, const SW3538_Data_t& data);
+};
+
+#endif // CHARGE_SESSION_H
@@ -6,108 +6,322 @@
  * 2. 使用char数组和snprintf进行格式化
  * 3. 优化内存使用，减少栈消耗
  * 4. 保持原有显示效果不变
+ * 5. OLED_PAGE_MODE选择全缓冲或页模式，布局每帧只计算一次
  */
 
 #include "display.h"
 #include "SW3538.h"
 #include "global_data.h"
+#include "history_graph.h"
 
 // 初始化OLED实例
-U8G2_SSD1306_128X64_NONAME_F_SW_I2C u8g2(U8G2_R0, /* clock=*/ 3, /* data=*/ 4, /* reset=*/ U8X8_PIN_NONE);
-
-// OLED显示变量
-static int yPosition = 10;
-const int Y_INCREMENT = 10;
+OledDriver u8g2(U8G2_R0, /* clock=*/ 3, /* data=*/ 4, /* reset=*/ U8X8_PIN_NONE);
 
 // 防烧屏功能变量
 static bool oledStatus = true;
 static unsigned long lastAccessTime = 0;
 const unsigned long SCREEN_OFF_TIMEOUT = 30000;
-static bool lastPath1Online = false;
-static bool lastPath2Online = false;
+static unsigned long screenOffTimeout = SCREEN_OFF_TIMEOUT;
+
+// 上次渲染的快照版本，版本未变化时跳过重绘
+static const uint32_t RENDER_INVALID = 0xFFFFFFFFUL;
+static uint32_t renderedVersion = RENDER_INVALID;
+
+// 当前屏幕，按钮切换
+static DisplayScreen currentScreen = SCREEN_DATA;
+
+// ===== 布局 =====
+// 每帧先计算一次布局（格式化、测宽、定位），再按缓冲模式绘制：
+// 全缓冲绘制一遍后整屏发送，页模式逐页重放同一布局，格式化不随页数重复
+//
+// 全缓冲模式下分两层：静态层（中线）只在整屏刷新时绘制，帧缓冲区本身即其缓存；
+// 动态字段各占固定槽位，与上次显示的文本和位置比较，只清除并重绘变化字段的包围盒，
+// 再用updateDisplayArea()发送覆盖这些包围盒的8x8块
+
+enum LayoutField : uint8_t {
+    LF_ONLINE1 = 0, LF_BUCK1, LF_FAST, LF_POWER1, LF_VOLT1, LF_CURR1,
+    LF_ONLINE2, LF_BUCK2, LF_PROTOCOL, LF_POWER2, LF_VOLT2, LF_CURR2,
+    LF_COUNT
+};
+
+struct LayoutBox {
+    int16_t x, y;
+    int16_t w, h;
+};
+
+struct LayoutItem {
+    const uint8_t* font;
+    int16_t x;
+    int16_t y;
+    LayoutBox box;            // 文本包围盒（含1像素边距），空文本时w为0
+    char text[16];            // 空串表示不显示
+};
+
+struct DisplayLayout {
+    bool midLine;
+    LayoutItem items[LF_COUNT];
+};
+
+static const int16_t MID_LINE_Y = 32;
+
+// 屏幕上当前显示的布局（全缓冲增量刷新的比较基准）
+#if !OLED_PAGE_MODE
+static DisplayLayout shownLayout;
+static bool shownValid = false;
+#endif
+static uint16_t lastUpdateBytes = 0;
+
+static void layoutBegin(DisplayLayout& l) {
+    l.midLine = false;
+    for (uint8_t i = 0; i < LF_COUNT; i++) {
+        l.items[i].text[0] = '\0';
+        l.items[i].box.w = 0;
+    }
+}
+
+// 设置字段文本并计算包围盒；alignRight时x为右边界
+static void layoutSet(DisplayLayout& l, LayoutField field, const uint8_t* font, int16_t x, int16_t y,
+                      const char* text, bool alignRight = false) {
+    LayoutItem& item = l.items[field];
+    strncpy(item.text, text, sizeof(item.text) - 1);
+    item.text[sizeof(item.text) - 1] = '\0';
+    item.font = font;
+    
+    u8g2.setFont(font);
+    int16_t width = u8g2.getStrWidth(item.text);
+    if (alignRight) x -= width;
+    item.x = x;
+    item.y = y;
+    
+    int16_t ascent = u8g2.getAscent();
+    int16_t descent = u8g2.getDescent();  // 负值
+    item.box.x = x - 1;
+    item.box.y = y - ascent - 1;
+    item.box.w = width + 2;
+    item.box.h = ascent - descent + 2;
+}
+
+static bool boxIntersects(const LayoutBox& a, const LayoutBox& b) {
+    return a.w > 0 && b.w > 0 &&
+           a.x < b.x + b.w && b.x < a.x + a.w &&
+           a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+static void drawItem(const LayoutItem& item) {
+    u8g2.setFont(item.font);  // 字体未变时U8g2直接返回
+    u8g2.drawStr(item.x, item.y, item.text);
+}
+
+static void layoutDraw(const DisplayLayout& l) {
+    if (l.midLine) u8g2.drawLine(0, MID_LINE_Y, 127, MID_LINE_Y);  // 中线
+    for (uint8_t i = 0; i < LF_COUNT; i++) {
+        if (l.items[i].text[0]) drawItem(l.items[i]);
+    }
+}
+
+// 绘制并发送整屏
+static void layoutFlush(const DisplayLayout& l) {
+#if OLED_PAGE_MODE
+    u8g2.firstPage();
+    do {
+        layoutDraw(l);
+    } while (u8g2.nextPage());
+#else
+    u8g2.clearBuffer();
+    layoutDraw(l);
+    u8g2.sendBuffer();
+    shownLayout = l;
+    shownValid = true;
+#endif
+    lastUpdateBytes = 1024;
+}
+
+#if !OLED_PAGE_MODE
+static LayoutBox boxUnion(const LayoutBox& a, const LayoutBox& b) {
+    if (a.w == 0) return b;
+    if (b.w == 0) return a;
+    int16_t x0 = min(a.x, b.x), y0 = min(a.y, b.y);
+    int16_t x1 = max(a.x + a.w, b.x + b.w), y1 = max(a.y + a.h, b.y + b.h);
+    LayoutBox u = { x0, y0, (int16_t)(x1 - x0), (int16_t)(y1 - y0) };
+    return u;
+}
+
+// 包围盒裁剪到屏幕后标记覆盖的8x8块（每行16块）
+static void markBoxTiles(const LayoutBox& b, uint16_t tiles[8]) {
+    int16_t x0 = b.x < 0 ? 0 : b.x;
+    int16_t y0 = b.y < 0 ? 0 : b.y;
+    int16_t x1 = b.x + b.w > 128 ? 128 : b.x + b.w;
+    int16_t y1 = b.y + b.h > 64 ? 64 : b.y + b.h;
+    if (x1 <= x0 || y1 <= y0) return;
+    
+    uint16_t cols = 0;
+    for (int16_t tx = x0 / 8; tx < (x1 + 7) / 8; tx++) cols |= 1U << tx;
+    for (int16_t ty = y0 / 8; ty < (y1 + 7) / 8; ty++) tiles[ty] |= cols;
+}
+
+// 按行发送连续的已标记块，每块只发送一次
+static uint16_t sendTiles(const uint16_t tiles[8]) {
+    uint16_t bytes = 0;
+    for (uint8_t ty = 0; ty < 8; ty++) {
+        uint8_t tx = 0;
+        while (tx < 16) {
+            if (!(tiles[ty] & (1U << tx))) { tx++; continue; }
+            uint8_t start = tx;
+            while (tx < 16 && (tiles[ty] & (1U << tx))) tx++;
+            u8g2.updateDisplayArea(start, ty, tx - start, 1);
+            bytes += (tx - start) * 8;
+        }
+    }
+    return bytes;
+}
+
+// 增量刷新：只清除、重绘并发送变化字段的包围盒
+static void layoutUpdate(const DisplayLayout& l) {
+    if (!shownValid || l.midLine != shownLayout.midLine) {
+        layoutFlush(l);
+        return;
+    }
+    
+    // 变化字段的脏区域 = 旧包围盒 ∪ 新包围盒
+    LayoutBox dirty[LF_COUNT];
+    uint8_t dirtyCount = 0;
+    for (uint8_t i = 0; i < LF_COUNT; i++) {
+        const LayoutItem& now = l.items[i];
+        const LayoutItem& old = shownLayout.items[i];
+        if (strcmp(now.text, old.text) == 0 && now.x == old.x && now.y == old.y) continue;
+        dirty[dirtyCount++] = boxUnion(old.box, now.box);
+    }
+    
+    lastUpdateBytes = 0;
+    if (dirtyCount == 0) return;
+    
+    u8g2.setDrawColor(0);
+    for (uint8_t d = 0; d < dirtyCount; d++) {
+        u8g2.drawBox(dirty[d].x, dirty[d].y, dirty[d].w, dirty[d].h);
+    }
+    u8g2.setDrawColor(1);
+    
+    // 重绘与脏区域相交的全部内容（包括未变化的相邻字段和中线）
+    static const LayoutBox MID_LINE_BOX = { 0, MID_LINE_Y, 128, 1 };
+    bool midLineHit = false;
+    for (uint8_t d = 0; d < dirtyCount && !midLineHit; d++) {
+        midLineHit = boxIntersects(dirty[d], MID_LINE_BOX);
+    }
+    if (l.midLine && midLineHit) u8g2.drawLine(0, MID_LINE_Y, 127, MID_LINE_Y);
+    
+    for (uint8_t i = 0; i < LF_COUNT; i++) {
+        const LayoutItem& item = l.items[i];
+        if (!item.text[0]) continue;
+        for (uint8_t d = 0; d < dirtyCount; d++) {
+            if (boxIntersects(item.box, dirty[d])) {
+                drawItem(item);
+                break;
+            }
+        }
+    }
+    
+    uint16_t tiles[8] = {0};
+    for (uint8_t d = 0; d < dirtyCount; d++) {
+        markBoxTiles(dirty[d], tiles);
+    }
+    lastUpdateBytes = sendTiles(tiles);
+    shownLayout = l;
+}
+#endif
+
+static void buildDataLayout(const SW3538Snapshot& snap, DisplayLayout& l) {
+    const SW3538_Data_t& sw3538Data = snap.data;
+    const DisplayData& displayData = snap.display;
+    char buf[16];
+    
+    layoutBegin(l);
+    l.midLine = true;
+    
+    // 第一通路显示
+    if (sw3538Data.path1Online) layoutSet(l, LF_ONLINE1, u8g2_font_helvR08_tr, 2, 18, "L");
+    if (sw3538Data.path1BuckStatus) layoutSet(l, LF_BUCK1, u8g2_font_helvR08_tr, 2, 30, "B");
+    
+    // 快充状态
+    if (sw3538Data.fastChargeStatus) layoutSet(l, LF_FAST, u8g2_font_heisans_tr, 12, 30, "Fast");
+    
+    // 第一通路功率
+    snprintf(buf, sizeof(buf), "%.1fW", displayData.current1 * displayData.outputVoltage);
+    layoutSet(l, LF_POWER1, u8g2_font_helvR14_tr, 88, 24, buf, true);
+    
+    // 第一通路电压电流
+    snprintf(buf, sizeof(buf), "%.2fV", displayData.outputVoltage);
+    layoutSet(l, LF_VOLT1, u8g2_font_helvR08_tr, 126, 18, buf, true);
+    snprintf(buf, sizeof(buf), "%.2fA", displayData.current1);
+    layoutSet(l, LF_CURR1, u8g2_font_helvR08_tr, 126, 30, buf, true);
+    
+    // 第二通路显示
+    if (sw3538Data.path2Online) layoutSet(l, LF_ONLINE2, u8g2_font_helvR08_tr, 2, 50, "L");
+    if (sw3538Data.path2BuckStatus) layoutSet(l, LF_BUCK2, u8g2_font_helvR08_tr, 2, 62, "B");
+    
+    // 快充协议
+    layoutSet(l, LF_PROTOCOL, u8g2_font_heisans_tr, 12, 62, SW3538::getProtocolName(sw3538Data.fastChargeProtocol));
+    
+    // 第二通路功率
+    snprintf(buf, sizeof(buf), "%.1fW", displayData.current2 * displayData.outputVoltage);
+    layoutSet(l, LF_POWER2, u8g2_font_helvR14_tr, 88, 56, buf, true);
+    
+    // 第二通路电压电流
+    snprintf(buf, sizeof(buf), "%.2fV", displayData.outputVoltage);
+    layoutSet(l, LF_VOLT2, u8g2_font_helvR08_tr, 126, 50, buf, true);
+    snprintf(buf, sizeof(buf), "%.2fA", displayData.current2);
+    layoutSet(l, LF_CURR2, u8g2_font_helvR08_tr, 126, 62, buf, true);
+}
 
 // 初始化OLED
 void initOled() {
     u8g2.begin();
     initButton();
-    u8g2.clearBuffer();
-    u8g2.setFont(u8g2_font_helvR08_tr);
-    u8g2.drawStr(0, 10, "Initializing...");
-    u8g2.sendBuffer();
+    DisplayLayout layout;
+    layoutBegin(layout);
+    layoutSet(layout, LF_POWER1, u8g2_font_helvR08_tr, 0, 10, "Initializing...");  // 借用一个槽位
+    layoutFlush(layout);
 }
 
-// 显示SW3538数据 - 使用预计算的全局显示数据
+// 快速初始化 - 只发送控制器初始化序列并开屏，不清屏、不显示启动画面
+// 首帧整屏刷新覆盖显存，省去两次1KB的软件I2C传输
+void initOledFast() {
+    u8g2.initDisplay();
+    u8g2.setPowerSave(0);
+    initButton();
+}
+
+// 显示SW3538数据 - 使用一致快照，版本未变化时不重绘
 void displaySw3538Data() {
-    // 实时获取最新的通路状态和buck状态
-    bool path1Online = sw3538Data.path1Online;
-    bool path2Online = sw3538Data.path2Online;
-    bool path1BuckStatus = sw3538Data.path1BuckStatus;
-    bool path2BuckStatus = sw3538Data.path2BuckStatus;
+    if (!oledStatus) return;
+    if (!hasSnapshotChanged(renderedVersion)) return;
     
-    if (oledStatus) {
-        u8g2.clearBuffer();
-        u8g2.drawLine(0, 32, 127, 32);  // 中线
-        
-        char buf[16];
-        
-        // 第一通路显示
-        u8g2.setFont(u8g2_font_helvR08_tr);
-        if (path1Online) u8g2.drawStr(2, 18, "L");
-        if (path1BuckStatus) u8g2.drawStr(2, 30, "B");
-        
-        // 快充状态
-        u8g2.setFont(u8g2_font_heisans_tr);
-        if (sw3538Data.fastChargeStatus) {
-            u8g2.drawStr(12, 30, "Fast");
-        } else {
-            u8g2.drawStr(12, 30, "  ");
-        }
-        
-        // 第一通路功率
-        u8g2.setFont(u8g2_font_helvR14_tr);
-        float power1 = displayData.current1 * displayData.outputVoltage;
-        snprintf(buf, sizeof(buf), "%.1fW", power1);
-        int width = u8g2.getStrWidth(buf);
-        u8g2.drawStr(88 - width, 24, buf);
-        
-        // 第一通路电压电流
-        u8g2.setFont(u8g2_font_helvR08_tr);
-        snprintf(buf, sizeof(buf), "%.2fV", displayData.outputVoltage);
-        width = u8g2.getStrWidth(buf);
-        u8g2.drawStr(126 - width, 18, buf);
-        
-        snprintf(buf, sizeof(buf), "%.2fA", displayData.current1);
-        width = u8g2.getStrWidth(buf);
-        u8g2.drawStr(126 - width, 30, buf);
-        
-        // 第二通路显示
-        u8g2.setFont(u8g2_font_helvR08_tr);
-        if (path2Online) u8g2.drawStr(2, 50, "L");
-        if (path2BuckStatus) u8g2.drawStr(2, 62, "B");
-        
-        // 快充协议
-        u8g2.setFont(u8g2_font_heisans_tr);
-        u8g2.drawStr(12, 62, SW3538::getProtocolName(sw3538Data.fastChargeProtocol));
-        
-        // 第二通路功率
-        u8g2.setFont(u8g2_font_helvR14_tr);
-        float power2 = displayData.current2 * displayData.outputVoltage;
-        snprintf(buf, sizeof(buf), "%.1fW", power2);
-        width = u8g2.getStrWidth(buf);
-        u8g2.drawStr(88 - width, 56, buf);
-        
-        // 第二通路电压电流
-        u8g2.setFont(u8g2_font_helvR08_tr);
-        snprintf(buf, sizeof(buf), "%.2fV", displayData.outputVoltage);
-        width = u8g2.getStrWidth(buf);
-        u8g2.drawStr(126 - width, 50, buf);
-        
-        snprintf(buf, sizeof(buf), "%.2fA", displayData.current2);
-        width = u8g2.getStrWidth(buf);
-        u8g2.drawStr(126 - width, 62, buf);
-        
-        u8g2.sendBuffer();
+    if (currentScreen == SCREEN_GRAPH) {
+        renderedVersion = getSnapshotVersion();
+        lastUpdateBytes = historyGraph.render();
+        return;
     }
+    
+    SW3538Snapshot snap;
+    readSnapshot(snap);
+    renderedVersion = snap.version;
+    
+    DisplayLayout layout;  // 约400字节，仅在绘制期间占用栈
+    buildDataLayout(snap, layout);
+#if OLED_PAGE_MODE
+    layoutFlush(layout);
+#else
+    layoutUpdate(layout);
+#endif
+}
+
+// 绘制到帧缓冲区 - 不访问屏幕，回放时可脱离硬件测量渲染开销
+void renderSw3538Data(const SW3538Snapshot& snap) {
+    DisplayLayout layout;
+    buildDataLayout(snap, layout);
+#if !OLED_PAGE_MODE
+    u8g2.clearBuffer();
+#endif
+    layoutDraw(layout);
 }
 
 // OLED控制函数 - 保持简单
@@ -115,8 +329,12 @@ void turnOnOled() {
     if (!oledStatus) {
         u8g2.setPowerSave(0);
         oledStatus = true;
-        u8g2.clearBuffer();
-        u8g2.sendBuffer();
+        u8g2.clearDisplay();
+#if !OLED_PAGE_MODE
+        shownValid = false;                // 屏幕已清空，下次整屏刷新
+#endif
+        historyGraph.invalidate();         // 曲线屏不能在已清空的显存上增量滚动
+        renderedVersion = RENDER_INVALID;  // 强制重绘
         displaySw3538Data();
         Serial.println("[Debug]Turn on the OLED");
     }
@@ -124,14 +342,32 @@ void turnOnOled() {
 
 void turnOffOled() {
     if (oledStatus) {
-        u8g2.clearBuffer();
-        u8g2.sendBuffer();
+        u8g2.clearDisplay();
         u8g2.setPowerSave(1);
         oledStatus = false;
         Serial.println("[Debug]Turn off the OLED");
     }
 }
 
+// 切换屏幕 - 新屏幕整屏重绘
+void nextScreen() {
+    currentScreen = (DisplayScreen)((currentScreen + 1) % SCREEN_COUNT);
+#if !OLED_PAGE_MODE
+    shownValid = false;
+#endif
+    historyGraph.invalidate();
+    renderedVersion = RENDER_INVALID;
+    displaySw3538Data();
+}
+
+DisplayScreen getCurrentScreen() {
+    return currentScreen;
+}
+
+uint16_t getLastDisplayUpdateBytes() {
+    return lastUpdateBytes;
+}
+
 bool isOledOn() {
     return oledStatus;
 }
@@ -166,6 +402,8 @@ void checkButtonState() {
             if (!isOledOn()) {
                 turnOnOled();
                 Serial.println("[Debug]Button press-Turn on the OLED");
+            } else {
+                nextScreen();  // 屏幕已亮时切换数据/曲线屏
             }
         } else if (currentButtonState == !LOW) {
             // 按钮释放，重置确认状态
@@ -176,28 +414,22 @@ void checkButtonState() {
     lastButtonState = currentButtonState;
 }
 
+void setScreenOffTimeout(unsigned long ms) {
+    screenOffTimeout = ms;
+}
+
 void checkOledTimeout() {
-    if (oledStatus && (millis() - lastAccessTime > SCREEN_OFF_TIMEOUT)) {
+    if (oledStatus && (millis() - lastAccessTime > screenOffTimeout)) {
         turnOffOled();
         Serial.println("[Debug]Timeout-Turn off the OLED");
     }
 }
-void pluginCheck() {
-    // 实时获取最新的通路状态
-    bool currentPath1Online = sw3538Data.path1Online;
-    bool currentPath2Online = sw3538Data.path2Online;
-    
-    // 检查通路状态是否发生变化
-    bool pathStatusChanged = (currentPath1Online != lastPath1Online) || 
-                            (currentPath2Online != lastPath2Online);
-    
-    if (pathStatusChanged && !isOledOn()) {
+void onPluginEvent(const SW3538_Event& evt, void* ctx) {
+    (void)evt;
+    (void)ctx;
+    if (!isOledOn()) {
         turnOnOled();
         updateLastAccessTime();
         Serial.println("[Debug]Plugin check-Turn on the OLED");
     }
-    
-    // 更新上一次的状态记录
-    lastPath1Online = currentPath1Online;
-    lastPath2Online = currentPath2Online;
-}
\ No newline at end of file
+}
@@ -12,28 +12,83 @@
 
 #include <U8g2lib.h>
 #include "SW3538.h"
+#include "sw3538_events.h"
+#include "global_data.h"
+
+// 帧缓冲模式：0为全缓冲（1024字节），1/2为页模式（128/256字节，每帧逐页重放布局）
+#ifndef OLED_PAGE_MODE
+#define OLED_PAGE_MODE 0
+#endif
+
+#if OLED_PAGE_MODE == 1
+typedef U8G2_SSD1306_128X64_NONAME_1_SW_I2C OledDriver;
+#elif OLED_PAGE_MODE == 2
+typedef U8G2_SSD1306_128X64_NONAME_2_SW_I2C OledDriver;
+#else
+typedef U8G2_SSD1306_128X64_NONAME_F_SW_I2C OledDriver;
+#endif
 
 // OLED实例声明
-extern U8G2_SSD1306_128X64_NONAME_F_SW_I2C u8g2;
+extern OledDriver u8g2;
 
 // 按钮定义
 #define BUTTON_PIN 0
 
+// 屏幕（屏幕已亮时按钮依次切换）
+enum DisplayScreen : uint8_t {
+    SCREEN_DATA = 0,      // 电压、电流、功率数值
+    SCREEN_GRAPH,         // 分通路功率曲线
+    SCREEN_COUNT
+};
+
 // 函数声明 - 保持接口不变
 void initButton();
 void checkButtonState();
 void initOled();
+/**
+ * @brief 快速启动用的OLED初始化
+ * 
+ * 不清屏、不绘制启动画面，调用后应尽快显示首帧
+ */
+void initOledFast();
 /**
  * @brief 显示SW3538数据
  * 
- * 使用预计算的全局显示数据刷新OLED显示
+ * 读取一致的数据快照刷新OLED显示，快照版本未变化时直接返回
  * 显示内容包括电压、电流、功率、快充状态等信息
  */
 void displaySw3538Data();
+/**
+ * @brief 将快照绘制到帧缓冲区，不发送到屏幕
+ * 
+ * displaySw3538Data()的绘制部分（计算布局+绘制一遍），原始帧回放时用于测量渲染开销
+ * 页模式下只绘制到当前页
+ */
+void renderSw3538Data(const SW3538Snapshot& snap);
+/**
+ * @brief 切换到下一个屏幕并整屏重绘
+ */
+void nextScreen();
+DisplayScreen getCurrentScreen();
+/**
+ * @brief 最近一次displaySw3538Data()发送到屏幕的字节数
+ * 
+ * 整屏刷新为1024，增量刷新为变化字段覆盖的8x8块数×8，无变化为0
+ */
+uint16_t getLastDisplayUpdateBytes();
 void turnOnOled();
 void turnOffOled();
 bool isOledOn();
 void updateLastAccessTime();
 void checkOledTimeout();
-void pluginCheck();
+/**
+ * @brief 设置无操作熄屏时间（默认30s）
+ */
+void setScreenOffTimeout(unsigned long ms);
+/**
+ * @brief 事件总线回调：设备插入/拔出时点亮OLED
+ * 
+ * 以SW3538_EVT_MASK_PATH订阅
+ */
+void onPluginEvent(const SW3538_Event& evt, void* ctx);
 #endif // DISPLAY_H
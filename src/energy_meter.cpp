@@ -0,0 +1,115 @@
+/*
+ * energy_meter.cpp - 分通路能量/电量累计实现
+ */
+
+#include "energy_meter.h"
+
+#ifdef ARDUINO
+#include <Preferences.h>
+#endif
+
+#define ENERGY_NVS_NAMESPACE  "energy"
+#define ENERGY_NVS_KEY        "total"
+
+EnergyMeter::EnergyMeter()
+    : _hasLast(false), _lastTimeMs(0),
+      _maxGapMs(30000), _checkpointMs(600000), _lastCheckpointMs(0), _skippedGaps(0) {
+    memset(_total, 0, sizeof(_total));
+    memset(_session, 0, sizeof(_session));
+    memset(_lastPowerUW, 0, sizeof(_lastPowerUW));
+    memset(_lastCurrentMA, 0, sizeof(_lastCurrentMA));
+}
+
+void EnergyMeter::begin() {
+#ifdef ARDUINO
+    Preferences prefs;
+    if (prefs.begin(ENERGY_NVS_NAMESPACE, true)) {
+        if (prefs.getBytesLength(ENERGY_NVS_KEY) == sizeof(_total)) {
+            prefs.getBytes(ENERGY_NVS_KEY, _total, sizeof(_total));
+        }
+        prefs.end();
+    }
+#endif
+    _hasLast = false;
+    _lastCheckpointMs = millis();
+}
+
+void EnergyMeter::update(uint32_t timeMs, const SW3538_Data_t& data) {
+    int32_t current[2] = { data.currentPath1mA, data.currentPath2mA };
+    int32_t power[2];
+    for (uint8_t p = 0; p < 2; p++) {
+        if (current[p] < 0) current[p] = 0;
+        power[p] = (int32_t)data.outputVoltagemV * current[p];
+    }
+
+    if (_hasLast) {
+        uint32_t dt = timeMs - _lastTimeMs;
+        if (dt > _maxGapMs) {
+            _skippedGaps++;
+        } else {
+            for (uint8_t p = 0; p < 2; p++) {
+                int64_t e = ((int64_t)_lastPowerUW[p] + power[p]) * dt;
+                int64_t q = ((int64_t)_lastCurrentMA[p] + current[p]) * dt;
+                _total[p].energy2nJ += e;
+                _total[p].charge2uC += q;
+                _session[p].energy2nJ += e;
+                _session[p].charge2uC += q;
+            }
+        }
+    }
+
+    _hasLast = true;
+    _lastTimeMs = timeMs;
+    for (uint8_t p = 0; p < 2; p++) {
+        _lastPowerUW[p] = power[p];
+        _lastCurrentMA[p] = current[p];
+    }
+
+    if (_checkpointMs > 0 && timeMs - _lastCheckpointMs >= _checkpointMs) {
+        checkpoint();
+        _lastCheckpointMs = timeMs;
+    }
+}
+
+const EnergyCounter& EnergyMeter::getCounter(uint8_t path, bool session) const {
+    uint8_t idx = (path == 2) ? 1 : 0;
+    return session ? _session[idx] : _total[idx];
+}
+
+float EnergyMeter::getEnergymWh(uint8_t path, bool session) const {
+    return toMilliwattHours(getCounter(path, session).energy2nJ);
+}
+
+float EnergyMeter::getChargemAh(uint8_t path, bool session) const {
+    return toMilliampHours(getCounter(path, session).charge2uC);
+}
+
+void EnergyMeter::resetSession(uint8_t path) {
+    for (uint8_t p = 0; p < 2; p++) {
+        if (path == 0 || path == p + 1) {
+            _session[p].energy2nJ = 0;
+            _session[p].charge2uC = 0;
+        }
+    }
+}
+
+bool EnergyMeter::checkpoint() {
+#ifdef ARDUINO
+    Preferences prefs;
+    if (!prefs.begin(ENERGY_NVS_NAMESPACE, false)) return false;
+    size_t n = prefs.putBytes(ENERGY_NVS_KEY, _total, sizeof(_total));
+    prefs.end();
+    return n == sizeof(_total);
+#else
+    return false;
+#endif
+}
+
+void EnergyMeter::printEnergy(Print& serial) const {
+    char buf[64];
+    for (uint8_t path = 1; path <= 2; path++) {
+        snprintf(buf, sizeof(buf), "Path%u: %.2fmWh %.2fmAh (total %.1fmWh)",
+                 path, getEnergymWh(path), getChargemAh(path), getEnergymWh(path, false));
+        serial.println(buf);
+    }
+}
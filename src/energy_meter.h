@@ -0,0 +1,114 @@
+/*
+ * energy_meter.h - 分通路能量/电量累计
+ *
+ * 设计说明：
+ * 1. 使用实际采样时间戳做梯形积分，适应AdaptiveScan 200ms-5s的可变间隔
+ * 2. 64位整数定点累加，无浮点误差累积：
+ *    - 能量：(P0+P1)×dt，单位 mV·mA·ms = nJ，累加值为2倍
+ *    - 电量：(I0+I1)×dt，单位 mA·ms = uC，累加值为2倍
+ * 3. 两级计数：累计总量（断电保存）和可清零的会话计数
+ * 4. 采样间隔超过最大间隔（读取失败、长时间阻塞）时跳过该段，不做外推
+ */
+
+#ifndef ENERGY_METER_H
+#define ENERGY_METER_H
+
+#include <Arduino.h>
+#include "SW3538.h"
+
+/**
+ * @brief 单通路计数器（定点，2倍值）
+ */
+struct EnergyCounter {
+    int64_t energy2nJ;     // 2 × nJ
+    int64_t charge2uC;     // 2 × uC（mA·ms）
+};
+
+/**
+ * @class EnergyMeter
+ * @brief 梯形积分能量计
+ */
+class EnergyMeter {
+public:
+    EnergyMeter();
+
+    /**
+     * @brief 初始化并从检查点恢复累计总量
+     */
+    void begin();
+
+    /**
+     * @brief 输入一次采样
+     *
+     * @param timeMs 采样时间（millis()）
+     * @param data 采样数据
+     */
+    void update(uint32_t timeMs, const SW3538_Data_t& data);
+
+    /**
+     * @brief 获取能量，单位mWh
+     *
+     * @param path 通路（1或2）
+     * @param session true返回会话计数，false返回累计总量
+     */
+    float getEnergymWh(uint8_t path, bool session = true) const;
+
+    /**
+     * @brief 获取电量，单位mAh
+     */
+    float getChargemAh(uint8_t path, bool session = true) const;
+
+    /**
+     * @brief 获取原始定点计数器
+     */
+    const EnergyCounter& getCounter(uint8_t path, bool session = true) const;
+
+    /**
+     * @brief 清零会话计数
+     *
+     * @param path 通路（1或2），0表示全部
+     */
+    void resetSession(uint8_t path = 0);
+
+    /**
+     * @brief 设置最大积分间隔，超过时跳过该段
+     */
+    void setMaxGap(uint32_t ms) { _maxGapMs = ms; }
+
+    /**
+     * @brief 设置检查点周期，0表示关闭自动保存
+     */
+    void setCheckpointInterval(uint32_t ms) { _checkpointMs = ms; }
+
+    /**
+     * @brief 立即保存累计总量
+     */
+    bool checkpoint();
+
+    /**
+     * @brief 获取因间隔过长而跳过的段数
+     */
+    uint32_t getSkippedGaps() const { return _skippedGaps; }
+
+    void printEnergy(Print& serial) const;
+
+    // 单位换算
+    static float toMilliwattHours(int64_t energy2nJ) { return (float)((double)energy2nJ / 7.2e9); }
+    static float toMilliampHours(int64_t charge2uC) { return (float)((double)charge2uC / 7.2e6); }
+
+private:
+    EnergyCounter _total[2];
+    EnergyCounter _session[2];
+
+    bool _hasLast;
+    uint32_t _lastTimeMs;
+    int32_t _lastPowerUW[2];    // mV × mA = uW
+    int32_t _lastCurrentMA[2];
+
+    uint32_t _maxGapMs;
+    uint32_t _checkpointMs;
+    uint32_t _lastCheckpointMs;
+    uint32_t _skippedGaps;
+};
+
+#endif // ENERGY_METER_H
@@ -0,0 +1,57 @@
+/*
+ * flash_fs.cpp - 共享的LittleFS挂载实现
+ */
+
+#include "flash_fs.h"
+
+#ifdef ARDUINO
+#include <LittleFS.h>
+#include <esp_partition.h>
+
+#define FLASH_FS_LABEL      "spiffs"    // LittleFS.begin()默认的分区标签
+#define FLASH_FS_BLOCK      4096
+
+static bool mounted = false;
+
+// LittleFS超级块位于块0或块1，偏移8处为"littlefs"
+static bool hasSuperblock() {
+    const esp_partition_t* part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                                           FLASH_FS_LABEL);
+    if (part == nullptr) return true;   // 找不到分区时不格式化
+    char magic[8];
+    for (uint32_t block = 0; block < 2; block++) {
+        if (esp_partition_read(part, block * FLASH_FS_BLOCK + 8, magic, sizeof(magic)) != ESP_OK) return true;
+        if (memcmp(magic, "littlefs", sizeof(magic)) == 0) return true;
+    }
+    return false;
+}
+
+bool flashFsMount() {
+    if (mounted) return true;
+    if (LittleFS.begin(false)) return mounted = true;
+    if (hasSuperblock()) return false;
+    
+    Serial.println("[FS] no filesystem, formatting");
+    return flashFsFormat();
+}
+
+bool flashFsFormat() {
+    if (mounted) {
+        LittleFS.end();
+        mounted = false;
+    }
+    if (!LittleFS.format()) return false;
+    return mounted = LittleFS.begin(false);
+}
+
+#else
+
+bool flashFsMount() {
+    return true;
+}
+
+bool flashFsFormat() {
+    return true;
+}
+
+#endif
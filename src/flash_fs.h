@@ -0,0 +1,29 @@
+/*
+ * flash_fs.h - 共享的LittleFS挂载
+ *
+ * 设计说明：
+ * 1. 采样日志和原始帧录制共用一个文件系统，挂载只做一次
+ * 2. 挂载失败时只在分区上没有LittleFS超级块（从未格式化）时才格式化；
+ *    已有文件系统但挂载失败可能是暂时性的，格式化会清空已有日志，只报告失败，
+ *    由用户确认后用串口命令format手动格式化
+ * 3. Linux下日志写到普通文件，挂载总是成功
+ */
+
+#ifndef FLASH_FS_H
+#define FLASH_FS_H
+
+#include <Arduino.h>
+
+/**
+ * @brief 挂载文件系统，从未格式化的分区先格式化
+ *
+ * @return false 已有文件系统但挂载失败，或格式化失败
+ */
+bool flashFsMount();
+
+/**
+ * @brief 格式化并重新挂载（清空全部日志和录制）
+ */
+bool flashFsFormat();
+
+#endif // FLASH_FS_H
@@ -1,39 +1,92 @@
 #include "global_data.h"
 #include <Arduino.h>  // 用于max函数和Serial
+#include <atomic>
 
 /**
- * @brief SW3538数据全局实例
+ * @brief 双缓冲快照存储
  * 
- * 此变量存储SW3538芯片的所有数据，包括电压、电流、功率等信息
- * 应通过getSW3538Data()函数访问，避免直接操作
+ * 序列号约定：稳定时为2k（版本k位于槽k&1），写入版本k+1期间为2k+1。
+ * 版本j写入槽j&1，因此读者正在读的槽k&1只会在写版本k+2时
+ * （序列号到达2k+3）被改写。
  */
-SW3538_Data_t sw3538Data;
+static SW3538Snapshot snapshotSlots[2];
+static std::atomic<uint32_t> snapshotSeq(0);
 
 /**
- * @brief 显示数据全局实例
+ * @brief 发布新采样的实现
  * 
- * 此变量存储计算后的显示数据，避免重复计算
+ * @param data SW3538原始数据
+ * @note 单一写者，无锁
+ */
+void publishSW3538Data(const SW3538_Data_t& data) {
+    uint32_t seq = snapshotSeq.load(std::memory_order_relaxed);
+    uint32_t next = (seq >> 1) + 1;
+    
+    // 标记写入开始（奇数），此时前台槽仍然有效
+    snapshotSeq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    
+    SW3538Snapshot& back = snapshotSlots[next & 1];
+    back.data = data;
+    computeDisplayData(data, back.display);
+    back.version = next;
+    
+    // 切换前台槽（偶数）
+    snapshotSeq.store(next << 1, std::memory_order_release);
+}
+
+/**
+ * @brief 读取一致快照的实现
+ * 
+ * @param out 输出快照
+ * @return bool 已有发布数据返回true
  */
-DisplayData displayData = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+bool readSnapshot(SW3538Snapshot& out) {
+    for (;;) {
+        uint32_t s1 = snapshotSeq.load(std::memory_order_acquire);
+        uint32_t version = s1 >> 1;
+        out = snapshotSlots[version & 1];
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint32_t s2 = snapshotSeq.load(std::memory_order_relaxed);
+        
+        // 复制期间写者尚未开始改写本槽
+        if (s2 - (version << 1) < 3) {
+            out.version = version;
+            return version != 0;
+        }
+    }
+}
+
+/**
+ * @brief 获取当前发布版本号的实现
+ */
+uint32_t getSnapshotVersion() {
+    return snapshotSeq.load(std::memory_order_acquire) >> 1;
+}
+
+/**
+ * @brief 检查是否有新数据的实现
+ */
+bool hasSnapshotChanged(uint32_t sinceVersion) {
+    return getSnapshotVersion() != sinceVersion;
+}
 
 /**
  * @brief 获取SW3538数据的实现
  * 
- * @return const SW3538_Data_t& 返回SW3538数据的常量引用
- * @note 此函数提供了对全局数据的只读访问，确保数据一致性
+ * @return const SW3538_Data_t& 返回前台缓冲区数据的常量引用
  */
 const SW3538_Data_t& getSW3538Data() {
-    return sw3538Data;
+    return snapshotSlots[getSnapshotVersion() & 1].data;
 }
 
 /**
  * @brief 获取显示数据的实现
  * 
- * @return const DisplayData& 返回显示数据的常量引用
- * @note 此函数提供了对计算后数据的只读访问
+ * @return const DisplayData& 返回前台缓冲区显示数据的常量引用
  */
 const DisplayData& getDisplayData() {
-    return displayData;
+    return snapshotSlots[getSnapshotVersion() & 1].display;
 }
 
 /**
@@ -41,34 +94,36 @@ const DisplayData& getDisplayData() {
  * 
  * @return bool 如果数据有效返回true，否则返回false
  * @details 有效性检查规则：
- *          1. 芯片版本必须小于等于3
- *          2. 最大功率必须小于等于65W
+ *          1. 状态寄存器本次读取有效（validMask，驱动已做重读和合理性检查）
+ *          2. 芯片版本必须小于等于3
+ *          3. 最大功率必须小于等于65W
  * @note 这些规则基于SW3538芯片的规格参数制定
  */
 bool isSW3538DataValid() {
-    return (sw3538Data.chipVersion <= 3) && (sw3538Data.maxPowerW <= 65);
+    const SW3538_Data_t& data = getSW3538Data();
+    return ((data.validMask & SW3538_VALID_STATUS) == SW3538_VALID_STATUS) &&
+           (data.chipVersion <= 3) && (data.maxPowerW <= 65);
 }
 
 /**
- * @brief 更新显示数据
+ * @brief 计算显示数据
  * 
  * 从SW3538原始数据计算显示所需的各种参数
  * @param data SW3538原始数据
- * @note 此函数会自动更新全局displayData变量
+ * @param out 输出的显示数据
  */
-void updateDisplayData(const SW3538_Data_t& data) {
+void computeDisplayData(const SW3538_Data_t& data, DisplayData& out) {
     // 计算电压（单位：V）
-    displayData.inputVoltage = data.inputVoltagemV / 1000.0f;
-    displayData.outputVoltage = data.outputVoltagemV / 1000.0f;
+    out.inputVoltage = data.inputVoltagemV / 1000.0f;
+    out.outputVoltage = data.outputVoltagemV / 1000.0f;
     
     // 计算电流（单位：A）
-    displayData.current1 = data.currentPath1mA / 1000.0f;
-    displayData.current2 = data.currentPath2mA / 1000.0f;
-    displayData.totalCurrent = displayData.current1 + displayData.current2;
+    out.current1 = data.currentPath1mA / 1000.0f;
+    out.current2 = data.currentPath2mA / 1000.0f;
+    out.totalCurrent = out.current1 + out.current2;
     
     // 计算功率（单位：W），防止负值或异常值
-    displayData.power = max(0.0f, displayData.outputVoltage * displayData.totalCurrent);
-    
+    out.power = max(0.0f, out.outputVoltage * out.totalCurrent);
 }
 
 /**
@@ -77,6 +132,7 @@ void updateDisplayData(const SW3538_Data_t& data) {
  * 用于调试和验证显示数据的正确性
  */
 void printDisplayData() {
+    const DisplayData& displayData = getDisplayData();
     Serial.println("=== 显示数据 ===");
     Serial.print("输入电压: ");
     Serial.print(displayData.inputVoltage);
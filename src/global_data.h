@@ -26,34 +26,64 @@ struct DisplayData {
 };
 
 /**
- * @brief 存储SW3538芯片的全局数据
+ * @brief 一致的数据快照
  * 
- * 此变量用于存储从SW3538芯片读取的数据，供系统各模块使用
- * 建议通过getSW3538Data()函数访问，而不是直接访问此变量
+ * 原始数据与对应的显示数据成对发布，读者总是得到同一次采样的两部分
  */
-extern SW3538_Data_t sw3538Data;
+struct SW3538Snapshot {
+    SW3538_Data_t data;    // SW3538原始数据
+    DisplayData display;   // 由data计算得到的显示数据
+    uint32_t version;      // 发布版本号，0表示尚未发布数据
+};
+
+/**
+ * @brief 发布一次新的采样数据
+ * 
+ * 计算显示数据并写入后台缓冲区，然后原子地切换版本号
+ * @param data SW3538原始数据
+ * @note 只允许单一写者（采集任务/中断），读者无需加锁
+ */
+void publishSW3538Data(const SW3538_Data_t& data);
 
 /**
- * @brief 存储计算后的显示数据
+ * @brief 读取一致的数据快照
  * 
- * 此变量存储从SW3538数据计算得到的显示用数据
- * 避免每次显示时重复计算
+ * 双缓冲+序列锁实现：写者只改写后台缓冲区，读者仅在
+ * 复制期间写者连续发布两次时才重试，正常情况下一次完成
+ * @param out 输出快照
+ * @return bool 已有发布数据返回true
  */
-extern DisplayData displayData;
+bool readSnapshot(SW3538Snapshot& out);
+
+/**
+ * @brief 获取当前发布版本号
+ * 
+ * @return uint32_t 每次publishSW3538Data()后加1
+ */
+uint32_t getSnapshotVersion();
+
+/**
+ * @brief 检查自某版本以来是否有新数据
+ * 
+ * @param sinceVersion 上次读取时的版本号
+ * @return bool 有新数据返回true
+ */
+bool hasSnapshotChanged(uint32_t sinceVersion);
 
 /**
  * @brief 获取SW3538数据的接口函数
  * 
- * @return const SW3538_Data_t& 返回SW3538数据的常量引用
- * @note 此函数提供了对全局数据的只读访问，确保数据不被意外修改
+ * @return const SW3538_Data_t& 返回最新发布数据的常量引用
+ * @note 引用指向前台缓冲区，仅适用于与写者同一上下文的调用；
+ *       跨任务/中断请使用readSnapshot()
  */
 const SW3538_Data_t& getSW3538Data();
 
 /**
  * @brief 获取显示数据的接口函数
  * 
- * @return const DisplayData& 返回显示数据的常量引用
- * @note 此函数提供了对计算后数据的只读访问
+ * @return const DisplayData& 返回最新发布显示数据的常量引用
+ * @note 同getSW3538Data()，跨上下文请使用readSnapshot()
  */
 const DisplayData& getDisplayData();
 
@@ -61,18 +91,19 @@ const DisplayData& getDisplayData();
  * @brief 检查SW3538数据是否有效
  * 
  * @return bool 如果数据有效返回true，否则返回false
- * @note 数据有效性检查基于芯片版本和最大功率参数
+ * @note 状态寄存器（版本、最大功率、快充、通路状态）本次读取均有效，且芯片版本和最大功率在规格范围内
  */
 bool isSW3538DataValid();
 
 /**
- * @brief 更新显示数据
+ * @brief 计算显示数据
  * 
  * 从SW3538原始数据计算显示所需的各种参数
  * @param data SW3538原始数据
- * @note 此函数会自动更新全局displayData变量
+ * @param out 输出的显示数据
  */
-void updateDisplayData(const SW3538_Data_t& data);
+void computeDisplayData(const SW3538_Data_t& data, DisplayData& out);
+
 /**
  * @brief 打印显示数据到串口（调试用途）
  * 
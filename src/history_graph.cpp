@@ -0,0 +1,194 @@
+/*
+ * history_graph.cpp - OLED分通路功率曲线屏实现
+ */
+
+#include "history_graph.h"
+#include "display.h"
+
+HistoryGraph historyGraph;
+
+// 屏幕布局：上半屏通路1，下半屏通路2，中线y=32
+#define GRAPH_PLOT_HEIGHT   30
+#define GRAPH_TEXT_X        104     // 文字区起点，8像素对齐
+#define GRAPH_PLOT_TILES    ((GRAPH_COLUMNS + 7) / 8)
+
+static const int16_t PLOT_BOTTOM[2] = { 31, 63 };
+// 文字基线：每行文字恰好占一个8行块（基线≡6 mod 8），变化时只发送该块行
+static const int16_t TEXT_Y[2][2] = { { 6, 22 }, { 46, 62 } };
+
+HistoryGraph::HistoryGraph() {
+    clear();
+}
+
+void HistoryGraph::clear() {
+    memset(_samples, 0, sizeof(_samples));
+    memset(_text, 0, sizeof(_text));
+    _head = 0;
+    _count = 0;
+    _pending = 0;
+    _scale[0] = _scale[1] = GRAPH_MIN_SCALE;
+    _max[0] = _max[1] = 0;
+    _fullRedraw = true;
+}
+
+// 不小于value的1/2/5×10^n档
+uint16_t HistoryGraph::niceScale(uint16_t value) {
+    uint32_t step = GRAPH_MIN_SCALE;
+    while (true) {
+        if (value <= step) return step;
+        if (value <= step * 2) return step * 2;
+        if (value <= step * 5) return step * 5;
+        step *= 10;
+        if (step > 10000) return 65000;
+    }
+}
+
+uint16_t HistoryGraph::sampleAt(uint8_t path, uint16_t age) const {
+    return _samples[path][(_head + GRAPH_COLUMNS - 1 - age) % GRAPH_COLUMNS];
+}
+
+void HistoryGraph::rescale(uint8_t path) {
+    uint16_t m = 0;
+    for (uint16_t i = 0; i < _count; i++) {
+        uint16_t v = sampleAt(path, i);
+        if (v > m) m = v;
+    }
+    _max[path] = m;
+}
+
+void HistoryGraph::push(const SW3538_Data_t& data) {
+    uint32_t vout = data.outputVoltagemV;
+    int32_t current[2] = { data.currentPath1mA, data.currentPath2mA };
+
+    for (uint8_t p = 0; p < 2; p++) {
+        uint32_t power = current[p] > 0 ? (uint32_t)current[p] * vout / 10000UL : 0;  // 10mW
+        uint16_t v = power > 65000 ? 65000 : power;
+        uint16_t evicted = _count == GRAPH_COLUMNS ? _samples[p][_head] : 0;
+        _samples[p][_head] = v;
+
+        if (v >= _max[p]) {
+            _max[p] = v;
+        } else if (evicted == _max[p]) {
+            rescale(p);  // 最大值滑出窗口，重新求最大值
+        }
+
+        // 放大立即生效；缩小要求新量程不足当前一半，避免来回抖动
+        uint16_t nice = niceScale(_max[p]);
+        if (nice > _scale[p] || nice * 2 < _scale[p]) {
+            _scale[p] = nice;
+            _fullRedraw = true;
+        }
+    }
+
+    _head = (_head + 1) % GRAPH_COLUMNS;
+    if (_count < GRAPH_COLUMNS) _count++;
+    if (_pending < GRAPH_COLUMNS) _pending++;
+}
+
+// 绘制单列：先清除该列曲线区，再画从底部向上的竖线
+void HistoryGraph::drawColumn(uint8_t path, int16_t x, uint16_t value) {
+    int16_t bottom = PLOT_BOTTOM[path];
+    u8g2.setDrawColor(0);
+    u8g2.drawVLine(x, bottom - GRAPH_PLOT_HEIGHT, GRAPH_PLOT_HEIGHT + 1);
+    u8g2.setDrawColor(1);
+
+    int16_t h = (int16_t)((uint32_t)value * GRAPH_PLOT_HEIGHT / _scale[path]);
+    if (h > GRAPH_PLOT_HEIGHT) h = GRAPH_PLOT_HEIGHT;
+    if (value > 0 && h == 0) h = 1;  // 非零值至少一个像素
+    if (h > 0) u8g2.drawVLine(x, bottom - h + 1, h);
+}
+
+// 更新一路的文字（当前功率、满量程），只重绘变化的行
+// 返回变化行的块行号掩码
+uint8_t HistoryGraph::updateText(uint8_t path, bool force) {
+    char lines[2][8];
+    uint16_t latest = _count ? sampleAt(path, 0) : 0;
+    snprintf(lines[0], sizeof(lines[0]), "%.1f", latest / 100.0f);
+    snprintf(lines[1], sizeof(lines[1]), "/%uW", _scale[path] / 100);
+
+    uint8_t rows = 0;
+    u8g2.setFont(u8g2_font_4x6_tr);
+    for (uint8_t i = 0; i < 2; i++) {
+        if (!force && strcmp(lines[i], _text[path][i]) == 0) continue;
+        strcpy(_text[path][i], lines[i]);
+
+        int16_t y = TEXT_Y[path][i];
+        u8g2.setDrawColor(0);
+        u8g2.drawBox(GRAPH_TEXT_X, y - 6, 128 - GRAPH_TEXT_X, 8);
+        u8g2.setDrawColor(1);
+        u8g2.drawStr(GRAPH_TEXT_X, y, lines[i]);
+        rows |= 1 << (y / 8);
+    }
+    return rows;
+}
+
+void HistoryGraph::drawAll() {
+    u8g2.drawLine(0, 32, 127, 32);  // 中线
+
+    // 最新采样在最右列
+    for (uint16_t age = 0; age < _count; age++) {
+        int16_t x = GRAPH_COLUMNS - 1 - age;
+        drawColumn(0, x, sampleAt(0, age));
+        drawColumn(1, x, sampleAt(1, age));
+    }
+
+    updateText(0, true);
+    updateText(1, true);
+}
+
+uint16_t HistoryGraph::renderFull() {
+#if OLED_PAGE_MODE
+    u8g2.firstPage();
+    do {
+        drawAll();
+    } while (u8g2.nextPage());
+#else
+    u8g2.clearBuffer();
+    drawAll();
+    u8g2.sendBuffer();
+#endif
+    _fullRedraw = false;
+    _pending = 0;
+    return 1024;
+}
+
+uint16_t HistoryGraph::render() {
+#if OLED_PAGE_MODE
+    if (!_fullRedraw && _pending == 0) return 0;
+    return renderFull();
+#else
+    if (_fullRedraw || _pending >= GRAPH_COLUMNS) return renderFull();
+    if (_pending == 0) return 0;
+
+    // 曲线区左移_pending列（SSD1306缓冲区按8行块存放，每块128字节，每字节一列8像素）
+    uint8_t* buf = u8g2.getBufferPtr();
+    uint16_t k = _pending;
+    for (uint8_t row = 0; row < 8; row++) {
+        uint8_t* line = buf + row * 128;
+        memmove(line, line + k, GRAPH_COLUMNS - k);
+    }
+
+    // 只绘制新增的列，中线在新列处补画
+    for (uint16_t age = 0; age < k; age++) {
+        int16_t x = GRAPH_COLUMNS - 1 - age;
+        drawColumn(0, x, sampleAt(0, age));
+        drawColumn(1, x, sampleAt(1, age));
+        u8g2.drawPixel(x, 32);
+    }
+    _pending = 0;
+
+    uint16_t bytes = GRAPH_PLOT_TILES * 8 * 8;
+    u8g2.updateDisplayArea(0, 0, GRAPH_PLOT_TILES, 8);
+
+    // 文字区只发送变化的块行
+    const uint8_t textTiles = (128 - GRAPH_TEXT_X) / 8;
+    uint8_t rows = updateText(0, false) | updateText(1, false);
+    for (uint8_t row = 0; row < 8; row++) {
+        if (rows & (1 << row)) {
+            u8g2.updateDisplayArea(GRAPH_TEXT_X / 8, row, textTiles, 1);
+            bytes += textTiles * 8;
+        }
+    }
+    return bytes;
+#endif
+}
@@ -0,0 +1,89 @@
+/*
+ * history_graph.h - OLED分通路功率曲线屏
+ *
+ * 设计说明：
+ * 1. 每次采样追加一列：通路1功率画在上半屏，通路2画在下半屏（中线与数据屏一致），
+ *    右侧文字区显示当前功率和满量程
+ * 2. 最近GRAPH_COLUMNS次采样保存在固定长度环形缓冲区，重绘时从中读取
+ * 3. 增量滚动（全缓冲模式）：帧缓冲区中曲线区左移k列（每个8行块一次memmove），
+ *    只绘制新增的k列，文字只重绘变化的行；发送曲线区和变化的文字块行
+ * 4. 量程懒调整：新值超过量程立即放大；最大值滑出窗口后，
+ *    按1/2/5档重新取整的量程不足当前一半时才缩小，两种情况都整屏重绘
+ * 5. 页模式下没有可滚动的帧缓冲区，每次整屏重绘
+ */
+
+#ifndef HISTORY_GRAPH_H
+#define HISTORY_GRAPH_H
+
+#include <Arduino.h>
+#include "SW3538.h"
+
+// 曲线区列数（每次采样一列）
+#ifndef GRAPH_COLUMNS
+#define GRAPH_COLUMNS    100
+#endif
+
+// 最小满量程，单位10mW（1W）
+#define GRAPH_MIN_SCALE  100
+
+/**
+ * @class HistoryGraph
+ * @brief 分通路功率曲线
+ */
+class HistoryGraph {
+public:
+    HistoryGraph();
+
+    /**
+     * @brief 清空采样并要求整屏重绘
+     */
+    void clear();
+
+    /**
+     * @brief 追加一次采样（不绘制）
+     */
+    void push(const SW3538_Data_t& data);
+
+    /**
+     * @brief 刷新屏幕：有待绘制的采样时增量滚动，必要时整屏重绘
+     *
+     * @return 发送到屏幕的字节数
+     */
+    uint16_t render();
+
+    /**
+     * @brief 整屏重绘（清空缓冲区、绘制全部列和文字并发送）
+     *
+     * 屏幕切换、量程变化时使用；也作为基准测试中朴素实现的对照
+     */
+    uint16_t renderFull();
+
+    /**
+     * @brief 下次render()时整屏重绘（屏幕被其他内容覆盖后调用）
+     */
+    void invalidate() { _fullRedraw = true; }
+
+    uint16_t getScale(uint8_t path) const { return _scale[path]; }
+
+private:
+    uint16_t _samples[2][GRAPH_COLUMNS];   // 两路功率，单位10mW
+    uint16_t _head;                         // 下一个写入位置
+    uint16_t _count;
+    uint16_t _pending;                      // 尚未绘制的采样数
+    uint16_t _scale[2];                     // 满量程，单位10mW
+    uint16_t _max[2];                       // 窗口内最大值
+    bool _fullRedraw;
+    char _text[2][2][8];                    // 已显示的文字：[通路][数值/量程]
+
+    uint16_t sampleAt(uint8_t path, uint16_t age) const;  // age=0为最新
+    void drawColumn(uint8_t path, int16_t x, uint16_t value);
+    void drawAll();
+    uint8_t updateText(uint8_t path, bool force);
+    void rescale(uint8_t path);
+
+    static uint16_t niceScale(uint16_t value);
+};
+
+extern HistoryGraph historyGraph;
+
+#endif // HISTORY_GRAPH_H
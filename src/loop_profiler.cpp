@@ -0,0 +1,87 @@
+/*
+ * loop_profiler.cpp - 主循环延迟与扫描抖动直方图实现
+ */
+
+#include "loop_profiler.h"
+
+#if LOOP_PROFILE
+
+LoopProfiler loopProfiler;
+
+static const char* const METRIC_NAMES[PROF_METRIC_COUNT] = {
+    "loop", "scan-late", "read", "render", "serial"
+};
+
+LoopProfiler::LoopProfiler() {
+    reset();
+}
+
+uint32_t LoopProfiler::cyclesPerUs() {
+#ifdef ARDUINO
+    return ESP.getCpuFreqMHz();
+#else
+    return 1;
+#endif
+}
+
+void LoopProfiler::recordUs(ProfMetric m, uint32_t us) {
+    uint32_t k = cyclesPerUs();
+    record(m, us > 0xFFFFFFFFUL / k ? 0xFFFFFFFFUL : us * k);
+}
+
+void LoopProfiler::reset() {
+    memset(_hist, 0, sizeof(_hist));
+}
+
+uint32_t LoopProfiler::count(ProfMetric m) const {
+    uint32_t n = 0;
+    for (uint8_t b = 0; b < PROF_BUCKETS; b++) n += _hist[m].counts[b];
+    return n;
+}
+
+uint32_t LoopProfiler::percentileUs(ProfMetric m, float p) const {
+    const Histogram& h = _hist[m];
+    uint32_t total = count(m);
+    if (total == 0) return 0;
+
+    // 第rank个样本所在桶内按均匀分布线性插值
+    uint32_t rank = (uint32_t)(p * (total - 1)) + 1;
+    uint32_t seen = 0;
+    for (uint8_t b = 0; b < PROF_BUCKETS; b++) {
+        if (seen + h.counts[b] >= rank) {
+            uint32_t lower = b == 0 ? 0 : 1UL << b;
+            uint32_t upper = b >= 31 ? 0xFFFFFFFFUL : (2UL << b) - 1;
+            if (upper > h.max) upper = h.max;
+            uint32_t value = lower + (uint32_t)((uint64_t)(upper - lower) * (rank - seen) / h.counts[b]);
+            return value / cyclesPerUs();
+        }
+        seen += h.counts[b];
+    }
+    return h.max / cyclesPerUs();
+}
+
+void LoopProfiler::printReport(Print& serial) const {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "[Profile] %-9s %6s %9s %9s %9s", "metric", "count", "p50us", "p99us", "maxus");
+    serial.println(buf);
+    for (uint8_t m = 0; m < PROF_METRIC_COUNT; m++) {
+        ProfMetric metric = (ProfMetric)m;
+        snprintf(buf, sizeof(buf), "[Profile] %-9s %6lu %9lu %9lu %9lu", METRIC_NAMES[m],
+                 (unsigned long)count(metric),
+                 (unsigned long)percentileUs(metric, 0.50f),
+                 (unsigned long)percentileUs(metric, 0.99f),
+                 (unsigned long)maxUs(metric));
+        serial.println(buf);
+    }
+}
+
+void LoopProfiler::handleCommand(char c, Print& serial) {
+    if (c == 'p') {
+        printReport(serial);
+    } else if (c == 'r') {
+        reset();
+        serial.println("[Profile] reset");
+    }
+}
+
+#endif // LOOP_PROFILE
@@ -0,0 +1,117 @@
+/*
+ * loop_profiler.h - 主循环延迟与扫描抖动直方图
+ *
+ * 设计说明：
+ * 1. 用CPU周期计数器计时，每次记录只做一次减法、一次前导零计数和两次自增
+ * 2. 按2的幂分桶（桶b覆盖[2^b, 2^(b+1))周期），固定32桶，无动态内存
+ * 3. 分位数在所在桶内线性插值（上界不超过实测最大值），误差不超过一个桶宽
+ * 4. 串口输入'p'打印报告，'r'清零
+ * 5. 编译时定义LOOP_PROFILE=0时所有PROF_*宏展开为空，不占用代码和内存
+ */
+
+#ifndef LOOP_PROFILER_H
+#define LOOP_PROFILER_H
+
+#include <Arduino.h>
+
+// 性能剖析开关 - 设置为0可完全移除
+#ifndef LOOP_PROFILE
+#define LOOP_PROFILE 1
+#endif
+
+#define PROF_BUCKETS 32
+
+enum ProfMetric : uint8_t {
+    PROF_LOOP = 0,        // 单次loop()耗时
+    PROF_SCAN_LATE,       // 扫描实际开始时间 - 计划时间
+    PROF_READ,            // readAllData()耗时
+    PROF_RENDER,          // displaySw3538Data()耗时
+    PROF_SERIAL,          // printAllData()串口输出耗时
+    PROF_METRIC_COUNT
+};
+
+#if LOOP_PROFILE
+
+/**
+ * @class LoopProfiler
+ * @brief 对数分桶的延迟直方图
+ */
+class LoopProfiler {
+public:
+    LoopProfiler();
+
+    /**
+     * @brief 读取周期计数器
+     */
+    static inline uint32_t now() {
+#ifdef ARDUINO
+        return ESP.getCycleCount();
+#else
+        return micros();
+#endif
+    }
+
+    /**
+     * @brief 记录一次耗时
+     *
+     * @param cycles 周期数（now()之差）
+     */
+    inline void record(ProfMetric m, uint32_t cycles) {
+        Histogram& h = _hist[m];
+        h.counts[cycles ? 31 - __builtin_clz(cycles) : 0]++;
+        if (cycles > h.max) h.max = cycles;
+    }
+
+    /**
+     * @brief 记录以微秒计的值（如毫秒级计划时间偏差）
+     */
+    void recordUs(ProfMetric m, uint32_t us);
+
+    /**
+     * @brief 获取分位数
+     *
+     * @param p 分位（0-1）
+     * @return 微秒，无样本返回0
+     */
+    uint32_t percentileUs(ProfMetric m, float p) const;
+
+    uint32_t maxUs(ProfMetric m) const { return _hist[m].max / cyclesPerUs(); }
+    uint32_t count(ProfMetric m) const;
+
+    void reset();
+
+    /**
+     * @brief 打印各指标的样本数、p50、p99、最大值（us）
+     */
+    void printReport(Print& serial) const;
+
+    /**
+     * @brief 处理串口单字符命令：'p'打印报告，'r'清零
+     */
+    void handleCommand(char c, Print& serial);
+
+private:
+    struct Histogram {
+        uint32_t counts[PROF_BUCKETS];
+        uint32_t max;
+    };
+    Histogram _hist[PROF_METRIC_COUNT];
+
+    static uint32_t cyclesPerUs();
+};
+
+extern LoopProfiler loopProfiler;
+
+#define PROF_START(var)             uint32_t var = LoopProfiler::now()
+#define PROF_STOP(metric, var)      loopProfiler.record(metric, LoopProfiler::now() - (var))
+#define PROF_RECORD_US(metric, us)  loopProfiler.recordUs(metric, us)
+
+#else
+
+#define PROF_START(var)
+#define PROF_STOP(metric, var)
+#define PROF_RECORD_US(metric, us)
+
+#endif // LOOP_PROFILE
+
+#endif // LOOP_PROFILER_H
@@ -4,40 +4,103 @@
 #include "global_data.h"
 #include "display.h"
 #include "adaptive_scan.h"
+#include "sw3538_events.h"
+#include "sample_history.h"
+#include "sample_log.h"
+#include "energy_meter.h"
+#include "charge_session.h"
+#include "channel_stats.h"
+#include "burst_capture.h"
+#include "protection_guard.h"
+#include "raw_record.h"
+#include "loop_profiler.h"
+#include "history_graph.h"
+#include "boot_profile.h"
+#include "report_builder.h"
+#include "param_registry.h"
+#include "flash_fs.h"
 
-// SW3538实例
-SW3538 sw3538;
+// SW3538实例 - 自定义I2C引脚
+SW3538 sw3538(0x3C, 2, 1);
 AdaptiveScan aScan;
+SW3538EventBus sw3538Events;
+SampleHistory sampleHistory;   // 多分辨率历史记录（静态分配）
+SampleLog sampleLog;           // Flash持久化采样日志
+EnergyMeter energyMeter;       // 分通路能量累计
+ChargeSessionTracker chargeSessions;  // 充电会话统计
+StreamingStats channelStats;   // 各通道窗口统计（默认60s窗口）
+BurstCapture burstCapture;     // 触发式突发采集
+ProtectionGuard protectionGuard;  // 软件过温/过流守护
+SW3538Report sw3538Report;     // 串口采样报告（增量格式化、单次写出）
+CommandLine commandLine;       // 串口命令行缓冲（非阻塞）
+#ifdef RAW_RECORD
+RawRecorder rawRecorder;       // 原始寄存器帧录制
+#endif
 
 // 函数声明
 void displaySerialData();
 void displaySystemInfo();
 unsigned long getNonBlockingDelay(unsigned long lastTime, unsigned long interval);
+void onGuardTrip(GuardChannel ch, float value, uint32_t latencyUs, void* ctx);
+void onParamChange(ParamId id, uint32_t value, void* ctx);
+void handleKeyCommand(char cmd);
+void formatStorage();
 
 void setup() {
     Serial.begin(115200);
+    bootProfiler.begin();
     
+    // 运行时参数：加载保存的值并写入各模块（I2C时钟需在sw3538.begin()之前）
+    params.begin();
+    params.setCallback(onParamChange);
+    params.applyAll();
+    
+#if FAST_BOOT
+    /**
+     * 快速启动：尽早显示首帧真实数据
+     * 1. 读取启动影子（地址和芯片版本），决定首帧之后是否补做探测；运行配置已由params恢复；
+     *    首帧之前不探测，驱动日志静音到首帧显示
+     * 2. 启动首次ADC转换后再初始化OLED，两者重叠
+     * 3. 首帧显示后才输出系统信息、诊断和各阶段耗时
+     * 首帧读取失败时readAllData()关闭startConversion()使能的ADC
+     */
+    BootShadow shadow;
+    bool shadowOk = loadBootShadow(shadow) && shadow.address == sw3538.getAddress();
+    bootProfiler.mark(BOOT_SHADOW);
+    
+    SW3538DefaultLogger::mute(true);
+    sw3538.begin();
+    sw3538.startConversion();
+    bootProfiler.mark(BOOT_DRIVER);
+    
+    initOledFast();
+    updateLastAccessTime(); // 设置初始访问时间
+    bootProfiler.mark(BOOT_OLED);
+    
+    bool firstOk = sw3538.readAllData();
+    bootProfiler.mark(BOOT_FIRST_READ);
+    
+    if (firstOk) {
+        publishSW3538Data(sw3538.data);
+        displaySw3538Data();
+    } else {
+        initOled();  // 无数据可显示，回退到启动画面
+    }
+    bootProfiler.mark(BOOT_FIRST_FRAME);
+    SW3538DefaultLogger::mute(false);
+#else
     // 初始化OLED
     initOled();
     // 初始化防烧屏功能
     updateLastAccessTime(); // 设置初始访问时间
+    bootProfiler.mark(BOOT_OLED);
     
-    // 系统信息
-    Serial.println("系统信息:");
-    Serial.print("MCU: ESP32-C3");
-    Serial.print(" 时钟频率: ");
-    Serial.print(ESP.getCpuFreqMHz());
-    Serial.println("MHz");
-    Serial.print("可用内存: ");
-    Serial.print(ESP.getFreeHeap());
-    Serial.println(" bytes");
-    Serial.println();
-
+    displaySystemInfo();
 
     // 初始化SW3538
     Serial.println("初始化SW3538...");
-    SW3538 sw3538(0x3C, 2, 1);    // 自定义I2C引脚
     sw3538.begin();
+    bootProfiler.mark(BOOT_DRIVER);
     
     // 测试通信
     Serial.println("测试SW3538通信...");
@@ -47,21 +110,26 @@ void setup() {
         // 读取初始数据
         if (sw3538.readAllData()) {
             Serial.println("初始数据读取成功");
-            // 初始化显示数据
-            sw3538Data = sw3538.data;
-            updateDisplayData(sw3538Data);
+            bootProfiler.mark(BOOT_FIRST_READ);
+            // 发布初始数据快照（含显示数据）
+            publishSW3538Data(sw3538.data);
+            displaySw3538Data();
+            bootProfiler.mark(BOOT_FIRST_FRAME);
         } else {
             Serial.println("初始数据读取失败");
         }
     }
+#endif
     /**
      * @brief 初始化自适应扫描系统
      * 
      * 配置参数说明：
      * - begin()：设置初始扫描间隔200ms，确保上电快速响应
-     * - setEpsilon(50)：设置电流变化阈值为50mA
-     *   - 当电流变化超过50mA时，立即切换到高速模式
+     * - 电流变化阈值（参数scan.eps，默认50mA）
+     *   - 当电流变化超过阈值时，立即切换到高速模式
      *   - 适用于手机充电等场景，既能检测充电开始，又避免微小波动干扰
+     *   - ADC过采样4^k次时噪声降为1/2^k，阈值同比缩小
+     * - 阈值、稳定次数、间隔范围、退避系数均来自参数注册表，由onParamChange()写入
      * 
      * 算法优势：
      * - 变化时快速响应（200ms），及时显示充电状态
@@ -69,13 +137,91 @@ void setup() {
      * - 自动适应不同充电场景（涓流、快充、满电）
      */
     aScan.begin();
-    aScan.setEpsilon(50);
+    
+    // 恢复能量累计检查点
+    energyMeter.begin();
+    
+    // 挂载采样日志（失败时仅关闭持久化，不影响显示）
+    if (!sampleLog.begin()) {
+        Serial.println("采样日志不可用");
+    }
+    
+    // 订阅变化事件：快充/连接变化触发高速扫描，插拔时点亮OLED
+    sw3538Events.subscribe(AdaptiveScan::EVENT_MASK, AdaptiveScan::onEvent, &aScan);
+    sw3538Events.subscribe(SW3538_EVT_MASK_PATH, onPluginEvent);
+    
+    // 会话跟踪：插拔/协议事件驱动，能量取自energyMeter
+    chargeSessions.begin(sw3538Events, energyMeter);
+    
+    // 突发采集：编译时定义BURST_CAPTURE_CHANNEL（如-DBURST_CAPTURE_CHANNEL=1）即上电布防
+    burstCapture.begin(sw3538, sw3538Events);
+#ifdef BURST_CAPTURE_CHANNEL
+    burstCapture.arm(BURST_CAPTURE_CHANNEL);
+#endif
+    
+    // 过温/过流守护：接近限值时切换到单通道10ms采样
+    protectionGuard.begin(sw3538);
+    protectionGuard.setCallback(onGuardTrip);
+    
+    // 原始帧回放：编译时定义RAW_REPLAY，上电后尽快回放上次录制并输出吞吐量
+#ifdef RAW_REPLAY
+    {
+        static RawReplay replay;
+        RawReplayResult result;
+        if (replay.run("/raw.bin", result)) {
+            RawReplay::printResult(result, Serial);
+        } else {
+            Serial.println("[Replay] no recording");
+        }
+    }
+#endif
+    
+    // 原始帧录制：编译时定义RAW_RECORD，每次扫描追加到/raw.bin（覆盖上次录制）
+#ifdef RAW_RECORD
+    if (!rawRecorder.begin("/raw.bin")) {
+        Serial.println("原始帧录制不可用");
+    }
+#endif
+    bootProfiler.mark(BOOT_SERVICES);
+    
+#if FAST_BOOT
+    // 推迟的诊断：首帧已显示，此时再输出系统信息并核对启动影子
+    displaySystemInfo();
+    if (firstOk) {
+        Serial.println("初始数据读取成功");
+        if (!shadowOk || shadow.chipVersion != sw3538.data.chipVersion) {
+            // 首次启动或芯片变化：补做一次探测并更新影子，以后启动跳过
+            sw3538.testI2CAddress(sw3538.getAddress());
+            BootShadow current = { BOOT_SHADOW_MAGIC, sw3538.getAddress(), sw3538.data.chipVersion };
+            saveBootShadow(current);
+        }
+    } else {
+        Serial.println("初始数据读取失败，探测SW3538...");
+        if (!sw3538.testI2CAddress(sw3538.getAddress())) {
+            sw3538.scanI2CAddresses();
+        }
+    }
+#endif
+    bootProfiler.mark(BOOT_DIAG);
+    bootProfiler.printReport(Serial);
 }
 
 void loop() {
+    PROF_START(loopStart);
+    
     // 检查按钮状态
     checkButtonState();
     checkOledTimeout();
+    
+    // 过温/过流守护：守护模式下按固定周期快速采样单通道
+    protectionGuard.service();
+    
+    // 突发采集：布防时在扫描间隙快速采样，触发后采集并导出
+    burstCapture.service();
+    if (burstCapture.isDone()) {
+        burstCapture.dump(Serial);
+    }
+    
     /**
      * @brief 自适应数据读取和显示主循环
      * 
@@ -84,7 +230,7 @@ void loop() {
      * 2. 读取设备数据：当tick()返回true时，读取SW3538寄存器数据
      * 3. 更新自适应算法：
      *    - updateCurrent()：基于总电流变化调整扫描频率
-     *    - updateState()：基于快充和设备连接状态调整扫描频率
+     *    - 事件总线：快充和设备连接状态变化时通知提速
      * 4. 更新显示：将新数据显示到OLED和串口
      * 
      * 自适应行为示例：
@@ -96,38 +242,157 @@ void loop() {
     
     // 步骤1：检查是否应该执行扫描（自适应频率控制）
     if (aScan.tick()){
+        PROF_RECORD_US(PROF_SCAN_LATE, aScan.getLastLatenessMs() * 1000UL);
         
         // 步骤2：读取SW3538完整数据
-        if (sw3538.readAllData()) {
-            // 调试输出：通过串口显示所有寄存器数据
-            sw3538.printAllData(Serial);
+        PROF_START(readStart);
+        bool readOk = sw3538.readAllData();
+        PROF_STOP(PROF_READ, readStart);
+#ifdef RAW_RECORD
+        // 录制校验前的读数和掩码（失败帧也录制），回放时重新校验
+        rawRecorder.append(millis(), sw3538.getReadFrame(), sw3538.getReadMask(), sw3538.getValidMask());
+#endif
+        if (readOk) {
+            // 调试输出：通过串口显示所有寄存器数据（变化模式只输出变化的字段）
+            PROF_START(serialStart);
+            sw3538Report.write(Serial, sw3538.data);
+            PROF_STOP(PROF_SERIAL, serialStart);
+            
+            // 检查限值裕量，决定是否进入守护模式
+            protectionGuard.update(sw3538.data);
+            
+            // 按实际采样时间积分能量（扫描间隔可变）
+            // 能量只在'e'命令时输出，每次扫描打印会占满串口
+            energyMeter.update(millis(), sw3538.data);
+            
+            // 流式统计，窗口翻转时输出上一窗口的分布
+            if (channelStats.update(millis(), sw3538.data)) {
+                channelStats.printStats(Serial);
+            }
             
             // 步骤3：计算总电流（两路之和）
             float total_ma = sw3538.data.currentPath1mA +
                              sw3538.data.currentPath2mA;
             
             // 步骤4：更新自适应算法
-            // 4.1 基于电流变化调整扫描频率
-            aScan.updateCurrent(total_ma);
+            // 4.1 基于电流变化调整扫描频率（电流读数无效时保持当前频率，坏数据不触发提速）
+            if ((sw3538.data.validMask & SW3538_VALID_CURRENTS) == SW3538_VALID_CURRENTS) {
+                aScan.updateCurrent(total_ma);
+            }
             
-            // 4.2 基于多维状态变化调整扫描频率
-            aScan.updateState(sw3538.data.fastChargeStatus, 
-                             sw3538.data.path1Online, 
-                             sw3538.data.path2Online);
+            // 步骤5：发布数据快照，同时计算显示数据（电压、电流、功率等）
+            publishSW3538Data(sw3538.data);  // 供其他模块使用
             
-            // 步骤5：更新全局数据结构
-            sw3538Data = sw3538.data;  // 供其他模块使用
+            // 步骤6：与上次采样比较一次，分发变化事件
+            // （快充/连接变化→高速扫描，插拔→点亮OLED）
+            sw3538Events.process(sw3538.data);
+            chargeSessions.update(millis(), sw3538.data);
             
-            // 步骤6：计算并存储显示数据（电压、电流、功率等）
-            updateDisplayData(sw3538Data);
+            // 步骤7：记录历史
+            sampleHistory.append(millis(), sw3538.data);
+            historyGraph.push(sw3538.data);  // 曲线屏每次采样一列
+            sampleLog.append(sw3538.data, millis());
             
-            // 步骤7：刷新OLED显示
+            // 步骤8：刷新OLED显示（版本未变化时跳过）
+            PROF_START(renderStart);
             displaySw3538Data();
-            pluginCheck();
+            PROF_STOP(PROF_RENDER, renderStart);
 
         } else {
             // 错误处理：数据读取失败
             Serial.println("[ERROR] 数据读取失败");
         }
     }
+    
+    // 串口命令（按行，非阻塞）：参数命令list/get/set/save/defaults，format，其余单字符命令见handleKeyCommand()
+    // 单字符命令可不带换行：逐字符发送的终端在空闲PARAM_KEY_IDLE_MS后执行
+    while (Serial.available()) {
+        const char* line = commandLine.feed((char)Serial.read());
+        if (!line || params.handleCommand(line, Serial)) continue;
+        if (strcmp(line, "format") == 0) {
+            formatStorage();
+        } else if (line[1] == '\0') {
+            handleKeyCommand(line[0]);
+        }
+    }
+    const char* key = commandLine.idle();
+    if (key) handleKeyCommand(key[0]);
+    PROF_STOP(PROF_LOOP, loopStart);
+}
+
+// 单字符命令：'d'转储寄存器，'e'打印能量，'s'打印充电会话，'o'切换ADC过采样位数，'c'切换完整/变化报告，'p'打印延迟直方图，'r'清零
+void handleKeyCommand(char cmd) {
+    if (cmd == 'd') {
+        sw3538.dumpRegisters(Serial);
+    } else if (cmd == 'e') {
+        energyMeter.printEnergy(Serial);
+    } else if (cmd == 's') {
+        chargeSessions.printSessions(Serial);
+    } else if (cmd == 'o') {
+        params.set(PARAM_ADC_OVERSAMPLE, (params.get(PARAM_ADC_OVERSAMPLE) + 1) % (SW3538_OVERSAMPLE_MAX_BITS + 1));
+        Serial.print("[ADC] oversample x");
+        Serial.println(1U << (2 * params.get(PARAM_ADC_OVERSAMPLE)));
+    } else if (cmd == 'c') {
+        params.set(PARAM_REPORT_CHANGES, !params.get(PARAM_REPORT_CHANGES));
+    }
+#if LOOP_PROFILE
+    loopProfiler.handleCommand(cmd, Serial);
+#endif
+}
+
+// 格式化文件系统并重新挂载日志 - 已有文件系统但挂载失败时不会自动格式化，由用户确认后执行
+void formatStorage() {
+    bool ok = flashFsFormat() && sampleLog.begin();
+#ifdef RAW_RECORD
+    ok = ok && rawRecorder.begin("/raw.bin");
+#endif
+    Serial.println(ok ? "[FS] formatted" : "[FS] format failed");
+}
+
+// 参数变化 - 写入各模块自己的副本，热路径不查注册表
+void onParamChange(ParamId id, uint32_t value, void* ctx) {
+    switch (id) {
+        case PARAM_SCAN_EPSILON_MA:
+        case PARAM_ADC_OVERSAMPLE:
+            // 过采样4^k次噪声降为1/2^k，阈值同比缩小
+            sw3538.setOversampleBits(params.get(PARAM_ADC_OVERSAMPLE));
+            aScan.setEpsilon(params.get(PARAM_SCAN_EPSILON_MA) >> params.get(PARAM_ADC_OVERSAMPLE));
+            break;
+        case PARAM_SCAN_STABLE_COUNT: aScan.setStableCount(value); break;
+        case PARAM_SCAN_MIN_MS:       aScan.setMinInterval(value); break;
+        case PARAM_SCAN_MAX_MS:       aScan.setMaxInterval(value); break;
+        case PARAM_SCAN_BACKOFF:      aScan.setBackoff(value); break;
+        case PARAM_I2C_CLOCK_HZ:      sw3538.setBusClock(value); break;
+        case PARAM_SCREEN_OFF_MS:     setScreenOffTimeout(value); break;
+        case PARAM_REPORT_CHANGES:
+            sw3538Report.setMode(value ? REPORT_CHANGES : REPORT_FULL);
+            sw3538Report.reset();  // 切换后先输出一次全部字段
+            break;
+        default: break;
+    }
+}
+
+// 系统信息
+void displaySystemInfo() {
+    Serial.println("系统信息:");
+    Serial.print("MCU: ESP32-C3");
+    Serial.print(" 时钟频率: ");
+    Serial.print(ESP.getCpuFreqMHz());
+    Serial.println("MHz");
+    Serial.print("可用内存: ");
+    Serial.print(ESP.getFreeHeap());
+    Serial.println(" bytes");
+    Serial.println();
+}
+
+// 守护越限回调 - 串口告警并点亮OLED
+void onGuardTrip(GuardChannel ch, float value, uint32_t latencyUs, void* ctx) {
+    static const char* names[] = { "TEMP", "CURRENT1", "CURRENT2" };
+    char buf[64];
+    snprintf(buf, sizeof(buf), "[ALARM] %s limit exceeded: %.1f (latency %luus)",
+             names[ch], value, (unsigned long)latencyUs);
+    Serial.println(buf);
+    
+    updateLastAccessTime();
+    turnOnOled();
 }
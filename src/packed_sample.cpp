@@ -0,0 +1,64 @@
+/*
+ * packed_sample.cpp - 带版本号的12字节打包采样格式实现
+ */
+
+#include "packed_sample.h"
+
+// 无分支饱和：负数为0，超过maxV为maxV
+static inline uint32_t saturate(int32_t v, uint32_t maxV) {
+    uint32_t pos = (uint32_t)v & ~(uint32_t)(v >> 31);
+    uint32_t over = 0U - (uint32_t)(pos > maxV);    // 超限时全1
+    return (pos & ~over) | (maxV & over);
+}
+
+uint16_t packSampleState(const SW3538_Data_t& data) {
+    return (uint16_t)((uint32_t)data.fastChargeStatus |
+                      ((uint32_t)data.path1Online << 1) |
+                      ((uint32_t)data.path2Online << 2) |
+                      ((uint32_t)data.path1BuckStatus << 3) |
+                      ((uint32_t)data.path2BuckStatus << 4) |
+                      (((uint32_t)data.fastChargeProtocol & 0x0F) << 5) |
+                      (((uint32_t)data.pdVersion & 0x03) << 9));
+}
+
+void packSample(const SW3538_Data_t& data, uint32_t dtMs, PackedSample& out) {
+    uint32_t dt = (dtMs | (0U - (uint32_t)(dtMs > PACKED_SAMPLE_DT_MAX))) & PACKED_SAMPLE_DT_MAX;
+    uint32_t vin = saturate(((int32_t)data.inputVoltagemV + 5) / 10, PACKED_SAMPLE_VIN_MAX);
+
+    // 温度：偏移后饱和到1~255，无效值(-999)清零
+    uint32_t temp = saturate(data.ntcTemperatureC + PACKED_SAMPLE_TEMP_OFFSET - 1, 254) + 1;
+    temp &= 0U - (uint32_t)(data.ntcTemperatureC != -999);
+
+    out.w[0] = dt | (saturate(data.outputVoltagemV, PACKED_SAMPLE_VOUT_MAX) << 16);
+    out.w[1] = saturate(data.currentPath1mA, PACKED_SAMPLE_CURRENT_MAX) |
+               (saturate(data.currentPath2mA, PACKED_SAMPLE_CURRENT_MAX) << 14) |
+               ((uint32_t)PACKED_SAMPLE_VERSION << 28);
+    out.w[2] = packSampleState(data) | (vin << 11) | (temp << 23);
+}
+
+bool unpackSample(const PackedSample& in, SW3538_Data_t& out) {
+    uint32_t w0 = in.w[0], w1 = in.w[1], w2 = in.w[2];
+
+    out.outputVoltagemV = (uint16_t)((w0 >> 16) & PACKED_SAMPLE_VOUT_MAX);
+    out.currentPath1mA = (int16_t)(w1 & PACKED_SAMPLE_CURRENT_MAX);
+    out.currentPath2mA = (int16_t)((w1 >> 14) & PACKED_SAMPLE_CURRENT_MAX);
+    out.inputVoltagemV = (uint16_t)(((w2 >> 11) & PACKED_SAMPLE_VIN_MAX) * 10);
+
+    int32_t temp = (int32_t)((w2 >> 23) & 0xFF);
+    out.ntcTemperatureC = (int16_t)(temp - PACKED_SAMPLE_TEMP_OFFSET +
+                                    (int32_t)(temp == 0) * (-999 + PACKED_SAMPLE_TEMP_OFFSET));
+
+    out.fastChargeStatus = w2 & 0x01;
+    out.path1Online = (w2 >> 1) & 0x01;
+    out.path2Online = (w2 >> 2) & 0x01;
+    out.path1BuckStatus = (w2 >> 3) & 0x01;
+    out.path2BuckStatus = (w2 >> 4) & 0x01;
+    out.fastChargeProtocol = (SW3538_FastChargeProtocol)((w2 >> 5) & 0x0F);
+    out.pdVersion = (w2 >> 9) & 0x03;
+    out.chipVersion = 0;
+    out.maxPowerW = 0;
+    out.validMask = SW3538_VALID_ALL & ~(SW3538_VALID(SW3538_SRC_VERSION) | SW3538_VALID(SW3538_SRC_MAX_POWER));  // 未打包
+    out.timeMs = 0;     // 由调用者按dt累加
+
+    return (w1 >> 28) == PACKED_SAMPLE_VERSION;
+}
@@ -0,0 +1,68 @@
+/*
+ * packed_sample.h - 带版本号的12字节打包采样格式
+ *
+ * 设计说明：
+ * 1. SW3538_Data_t含int大小的枚举和5个bool，对齐后32字节；缓存或传输采样时
+ *    统一使用3个32位字的打包格式：
+ *    - w0: bit0-15 时间差ms（饱和），bit16-30 输出电压mV
+ *    - w1: bit0-13 通路1电流mA，bit14-27 通路2电流mA，bit28-31 格式版本
+ *    - w2: bit0-10 状态字，bit11-22 输入电压（10mV），bit23-30 温度（°C+64，0为无效）
+ * 2. 状态字与日志记录LogSample::state布局相同：bit0-4 快充/通路1/通路2/Buck1/Buck2，
+ *    bit5-8 协议，bit9-10 PD版本
+ * 3. 打包/解包只用移位、掩码和比较结果的算术，无分支；超量程值饱和而非回绕
+ * 4. 驱动解码得到的电流（2.5mA/bit，≤10237mA）、电压（10mV/1mV/bit）和
+ *    温度（-40~150°C）均可无损往返；芯片版本和最大功率是配置量，不随采样保存
+ *
+ * 格式变化时递增PACKED_SAMPLE_VERSION，读取方据此拒绝不认识的记录
+ */
+
+#ifndef PACKED_SAMPLE_H
+#define PACKED_SAMPLE_H
+
+#include <Arduino.h>
+#include "SW3538.h"
+
+#define PACKED_SAMPLE_VERSION   1
+
+// 各字段上限
+#define PACKED_SAMPLE_DT_MAX        0xFFFFUL    // 时间差 ms
+#define PACKED_SAMPLE_VOUT_MAX      0x7FFFUL    // mV
+#define PACKED_SAMPLE_CURRENT_MAX   0x3FFFUL    // mA
+#define PACKED_SAMPLE_VIN_MAX       0x0FFFUL    // 10mV
+#define PACKED_SAMPLE_TEMP_OFFSET   64          // 可表示-63~191°C
+
+/**
+ * @brief 打包采样记录
+ */
+struct PackedSample {
+    uint32_t w[3];
+};
+
+static_assert(sizeof(PackedSample) == 12, "PackedSample must be 12 bytes");
+
+/**
+ * @brief 打包一次采样
+ *
+ * @param data 驱动采样数据
+ * @param dtMs 距上一条记录的时间（ms），超过PACKED_SAMPLE_DT_MAX时饱和
+ * @param out 输出记录
+ */
+void packSample(const SW3538_Data_t& data, uint32_t dtMs, PackedSample& out);
+
+/**
+ * @brief 解包一条记录
+ *
+ * @return false 记录版本不是PACKED_SAMPLE_VERSION（out内容无意义）
+ * @note chipVersion、maxPowerW置0
+ */
+bool unpackSample(const PackedSample& in, SW3538_Data_t& out);
+
+/**
+ * @brief 状态字（标志位、协议、PD版本，共11位）
+ */
+uint16_t packSampleState(const SW3538_Data_t& data);
+
+inline uint32_t packedSampleDtMs(const PackedSample& p) { return p.w[0] & PACKED_SAMPLE_DT_MAX; }
+inline uint8_t packedSampleVersion(const PackedSample& p) { return p.w[1] >> 28; }
+
+#endif // PACKED_SAMPLE_H
@@ -0,0 +1,251 @@
+/*
+ * param_registry.cpp - 运行时参数注册表实现
+ */
+
+#include "param_registry.h"
+#include "SW3538.h"
+#include "report_builder.h"
+
+#ifdef ARDUINO
+#include <Preferences.h>
+#else
+#include <stdio.h>
+#endif
+
+#define PARAM_NVS_NAMESPACE  "params"
+#define PARAM_NVS_KEY        "values"
+#define PARAM_MAGIC          0x5052   // "PR"
+
+ParamRegistry params;
+
+static const ParamDesc PARAMS[PARAM_COUNT] = {
+    // name             type              default                 min     max                         unit
+    { "scan.eps",       PARAM_TYPE_U16,   50,                     1,      5000,                       "mA" },
+    { "scan.stable",    PARAM_TYPE_U8,    5,                      1,      100,                        "" },
+    { "scan.min",       PARAM_TYPE_U32,   200,                    10,     60000,                      "ms" },
+    { "scan.max",       PARAM_TYPE_U32,   5000,                   10,     600000,                     "ms" },
+    { "scan.backoff",   PARAM_TYPE_U8,    2,                      1,      16,                         "x" },
+    { "i2c.clock",      PARAM_TYPE_U32,   100000,                 10000,  1000000,                    "Hz" },
+    { "oled.timeout",   PARAM_TYPE_U32,   30000,                  1000,   3600000,                    "ms" },
+    { "adc.os",         PARAM_TYPE_U8,    SW3538_OVERSAMPLE_BITS, 0,      SW3538_OVERSAMPLE_MAX_BITS, "bits" },
+    { "report.changes", PARAM_TYPE_BOOL,  REPORT_CHANGES_ONLY,    0,      1,                          "" },
+};
+
+// 相关参数约束：lo的值不得大于hi的值
+static const struct { ParamId lo; ParamId hi; } PARAM_ORDER[] = {
+    { PARAM_SCAN_MIN_MS, PARAM_SCAN_MAX_MS },
+};
+
+// 持久化格式：新增参数追加在末尾，旧数据按count只覆盖前面的参数
+struct ParamBlob {
+    uint16_t magic;
+    uint16_t count;
+    uint32_t values[PARAM_COUNT];
+};
+
+ParamRegistry::ParamRegistry() : _version(0), _cb(nullptr), _cbCtx(nullptr) {
+    _path[0] = '\0';
+    for (uint8_t i = 0; i < PARAM_COUNT; i++) _values[i] = PARAMS[i].def;
+}
+
+const ParamDesc& ParamRegistry::desc(ParamId id) {
+    return PARAMS[id];
+}
+
+ParamId ParamRegistry::find(const char* name) {
+    for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+        if (strcmp(PARAMS[i].name, name) == 0) return (ParamId)i;
+    }
+    return PARAM_COUNT;
+}
+
+bool ParamRegistry::begin(const char* path) {
+    strncpy(_path, path, sizeof(_path) - 1);
+    _path[sizeof(_path) - 1] = '\0';
+
+    ParamBlob blob;
+    size_t n = 0;
+#ifdef ARDUINO
+    Preferences prefs;
+    if (prefs.begin(PARAM_NVS_NAMESPACE, true)) {
+        size_t len = prefs.getBytesLength(PARAM_NVS_KEY);
+        if (len <= sizeof(blob)) n = prefs.getBytes(PARAM_NVS_KEY, &blob, len);
+        prefs.end();
+    }
+#else
+    FILE* f = fopen(_path, "rb");
+    if (f) {
+        n = fread(&blob, 1, sizeof(blob), f);
+        fclose(f);
+    }
+#endif
+    if (n < 4 || blob.magic != PARAM_MAGIC) return false;
+
+    uint16_t count = blob.count < (uint16_t)PARAM_COUNT ? blob.count : (uint16_t)PARAM_COUNT;
+    if (n < 4 + count * sizeof(uint32_t)) return false;
+    for (uint8_t i = 0; i < count; i++) {
+        uint32_t v = blob.values[i];
+        if (v >= PARAMS[i].min && v <= PARAMS[i].max) _values[i] = v;
+    }
+    // 存储中的组合不满足约束时，这组参数恢复默认值
+    for (uint8_t k = 0; k < sizeof(PARAM_ORDER) / sizeof(PARAM_ORDER[0]); k++) {
+        if (_values[PARAM_ORDER[k].lo] > _values[PARAM_ORDER[k].hi]) {
+            _values[PARAM_ORDER[k].lo] = PARAMS[PARAM_ORDER[k].lo].def;
+            _values[PARAM_ORDER[k].hi] = PARAMS[PARAM_ORDER[k].hi].def;
+        }
+    }
+    return true;
+}
+
+bool ParamRegistry::save() {
+    ParamBlob blob;
+    blob.magic = PARAM_MAGIC;
+    blob.count = PARAM_COUNT;
+    memcpy(blob.values, _values, sizeof(blob.values));
+#ifdef ARDUINO
+    Preferences prefs;
+    if (!prefs.begin(PARAM_NVS_NAMESPACE, false)) return false;
+    size_t n = prefs.putBytes(PARAM_NVS_KEY, &blob, sizeof(blob));
+    prefs.end();
+    return n == sizeof(blob);
+#else
+    FILE* f = fopen(_path, "wb");
+    if (!f) return false;
+    size_t n = fwrite(&blob, 1, sizeof(blob), f);
+    fclose(f);
+    return n == sizeof(blob);
+#endif
+}
+
+bool ParamRegistry::set(ParamId id, uint32_t value) {
+    if (id >= PARAM_COUNT) return false;
+    const ParamDesc& d = PARAMS[id];
+    if (value < d.min || value > d.max) return false;
+    if (_values[id] == value) return true;
+    if (!consistent(id, value)) return false;
+
+    _values[id] = value;
+    _version++;
+    if (_cb) _cb(id, value, _cbCtx);
+    return true;
+}
+
+bool ParamRegistry::consistent(ParamId id, uint32_t value) const {
+    for (uint8_t k = 0; k < sizeof(PARAM_ORDER) / sizeof(PARAM_ORDER[0]); k++) {
+        if (id == PARAM_ORDER[k].lo && value > _values[PARAM_ORDER[k].hi]) return false;
+        if (id == PARAM_ORDER[k].hi && value < _values[PARAM_ORDER[k].lo]) return false;
+    }
+    return true;
+}
+
+void ParamRegistry::resetDefaults() {
+    // 先整体写入再逐个回调：逐个set时中间组合可能违反约束
+    uint32_t old[PARAM_COUNT];
+    memcpy(old, _values, sizeof(old));
+    for (uint8_t i = 0; i < PARAM_COUNT; i++) _values[i] = PARAMS[i].def;
+    for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+        if (old[i] == _values[i]) continue;
+        _version++;
+        if (_cb) _cb((ParamId)i, _values[i], _cbCtx);
+    }
+}
+
+void ParamRegistry::applyAll() {
+    if (!_cb) return;
+    for (uint8_t i = 0; i < PARAM_COUNT; i++) _cb((ParamId)i, _values[i], _cbCtx);
+}
+
+void ParamRegistry::printParam(ParamId id, Print& serial) const {
+    const ParamDesc& d = PARAMS[id];
+    char buf[80];
+    snprintf(buf, sizeof(buf), "[Param] %-14s = %lu%s (default %lu, %lu..%lu)", d.name,
+             (unsigned long)_values[id], d.unit, (unsigned long)d.def, (unsigned long)d.min, (unsigned long)d.max);
+    serial.println(buf);
+}
+
+void ParamRegistry::list(Print& serial) const {
+    for (uint8_t i = 0; i < PARAM_COUNT; i++) printParam((ParamId)i, serial);
+}
+
+bool ParamRegistry::handleCommand(const char* line, Print& serial) {
+    char cmd[10], name[20], value[16];
+    int n = sscanf(line, "%9s %19s %15s", cmd, name, value);
+    if (n < 1) return false;
+
+    if (strcmp(cmd, "list") == 0) {
+        list(serial);
+        return true;
+    }
+    if (strcmp(cmd, "save") == 0) {
+        serial.println(save() ? "[Param] saved" : "[Param] save failed");
+        return true;
+    }
+    if (strcmp(cmd, "defaults") == 0) {
+        resetDefaults();
+        serial.println("[Param] defaults restored (not saved)");
+        return true;
+    }
+
+    bool isGet = strcmp(cmd, "get") == 0;
+    bool isSet = strcmp(cmd, "set") == 0;
+    if (!isGet && !isSet) return false;
+
+    char buf[64];
+    ParamId id = n >= 2 ? find(name) : PARAM_COUNT;
+    if (id == PARAM_COUNT) {
+        snprintf(buf, sizeof(buf), "[Param] unknown: %s", n >= 2 ? name : "");
+        serial.println(buf);
+        return true;
+    }
+
+    if (isSet) {
+        char* end = nullptr;
+        unsigned long v = n >= 3 ? strtoul(value, &end, 0) : 0;
+        bool inRange = n >= 3 && *end == '\0' && v >= PARAMS[id].min && v <= PARAMS[id].max;
+        if (!inRange || !set(id, (uint32_t)v)) {
+            if (inRange) {
+                snprintf(buf, sizeof(buf), "[Param] %s conflicts with related parameters", name);
+            } else {
+                snprintf(buf, sizeof(buf), "[Param] invalid value for %s (%lu..%lu)", name,
+                         (unsigned long)PARAMS[id].min, (unsigned long)PARAMS[id].max);
+            }
+            serial.println(buf);
+            return true;
+        }
+    }
+    printParam(id, serial);
+    return true;
+}
+
+const char* CommandLine::feed(char c) {
+    _lastMs = millis();
+    if (c != '\n' && c != '\r') {
+        if (_len < sizeof(_buf) - 1) {
+            _buf[_len++] = c;
+        } else {
+            _overflow = true;
+        }
+        return nullptr;
+    }
+
+    bool overflow = _overflow;
+    uint8_t len = _len;
+    _len = 0;
+    _overflow = false;
+    if (overflow) return nullptr;
+
+    // 去掉首尾空白
+    while (len > 0 && (_buf[len - 1] == ' ' || _buf[len - 1] == '\t')) len--;
+    _buf[len] = '\0';
+    const char* line = _buf;
+    while (*line == ' ' || *line == '\t') line++;
+    return *line ? line : nullptr;
+}
+
+const char* CommandLine::idle() {
+    if (_len != 1 || _overflow || millis() - _lastMs < PARAM_KEY_IDLE_MS) return nullptr;
+    _len = 0;
+    if (_buf[0] == ' ' || _buf[0] == '\t') return nullptr;
+    _buf[1] = '\0';
+    return _buf;
+}
@@ -0,0 +1,179 @@
+/*
+ * param_registry.h - 运行时参数注册表
+ *
+ * 设计说明：
+ * 1. 参数以常量描述表定义（名称、类型、默认值、范围、单位），值统一存为uint32_t数组，
+ *    get()只是一次数组读取
+ * 2. 模块不查注册表：参数变化时通过回调把新值写入模块自己的副本（setEpsilon()等），
+ *    热路径上没有额外开销
+ * 3. 串口按行解析命令，不阻塞主循环：
+ *    list / get <name> / set <name> <value> / save / defaults
+ * 4. save写入持久化存储：目标板使用NVS，Linux下使用普通文件；
+ *    加载时只接受范围内的值，新增参数（存储中没有）取默认值
+ * 5. 相关参数互相约束（scan.min <= scan.max），set和加载时都检查，不满足时拒绝
+ *
+ * set立即生效但不自动保存，现场A/B对比后再save
+ */
+
+#ifndef PARAM_REGISTRY_H
+#define PARAM_REGISTRY_H
+
+#include <Arduino.h>
+
+// 命令行缓冲区大小（字节）
+#ifndef PARAM_LINE_BYTES
+#define PARAM_LINE_BYTES  48
+#endif
+
+// 单字符命令的空闲超时（ms）：逐字符发送的终端不必输入换行
+#ifndef PARAM_KEY_IDLE_MS
+#define PARAM_KEY_IDLE_MS 300
+#endif
+
+enum ParamId : uint8_t {
+    PARAM_SCAN_EPSILON_MA = 0,   // 电流变化阈值
+    PARAM_SCAN_STABLE_COUNT,     // 连续稳定多少次后降频
+    PARAM_SCAN_MIN_MS,           // 最短扫描间隔
+    PARAM_SCAN_MAX_MS,           // 最长扫描间隔
+    PARAM_SCAN_BACKOFF,          // 退避系数
+    PARAM_I2C_CLOCK_HZ,          // I2C时钟
+    PARAM_SCREEN_OFF_MS,         // OLED无操作熄屏时间
+    PARAM_ADC_OVERSAMPLE,        // ADC过采样位数（每通道4^n次）
+    PARAM_REPORT_CHANGES,        // 串口报告只输出变化字段
+    PARAM_COUNT
+};
+
+enum ParamType : uint8_t {
+    PARAM_TYPE_BOOL = 0,
+    PARAM_TYPE_U8,
+    PARAM_TYPE_U16,
+    PARAM_TYPE_U32
+};
+
+/**
+ * @brief 参数描述
+ */
+struct ParamDesc {
+    const char* name;
+    ParamType type;
+    uint32_t def;
+    uint32_t min;
+    uint32_t max;
+    const char* unit;
+};
+
+/**
+ * @class ParamRegistry
+ * @brief 类型化参数表
+ */
+class ParamRegistry {
+public:
+    typedef void (*ChangeCallback)(ParamId id, uint32_t value, void* ctx);
+
+    ParamRegistry();
+
+    /**
+     * @brief 从持久化存储加载（不存在时保持默认值）
+     *
+     * @param path Linux下的文件路径
+     * @return 是否加载到已保存的参数
+     */
+    bool begin(const char* path = "/params.bin");
+
+    /**
+     * @brief 参数当前值
+     */
+    uint32_t get(ParamId id) const { return _values[id]; }
+
+    /**
+     * @brief 设置参数，超出范围或违反相关参数约束时拒绝；值变化时调用回调
+     */
+    bool set(ParamId id, uint32_t value);
+
+    /**
+     * @brief 保存全部参数
+     */
+    bool save();
+
+    /**
+     * @brief 全部恢复默认值（不保存）
+     */
+    void resetDefaults();
+
+    /**
+     * @brief 按名称查找，未找到返回PARAM_COUNT
+     */
+    static ParamId find(const char* name);
+    static const ParamDesc& desc(ParamId id);
+
+    /**
+     * @brief 参数变化回调（set/resetDefaults/applyAll时调用）
+     */
+    void setCallback(ChangeCallback cb, void* ctx = nullptr) { _cb = cb; _cbCtx = ctx; }
+
+    /**
+     * @brief 对全部参数调用一次回调，启动时把加载的值写入各模块
+     */
+    void applyAll();
+
+    /**
+     * @brief 执行一行参数命令
+     *
+     * @return false 不是参数命令（交给其他命令处理）
+     */
+    bool handleCommand(const char* line, Print& serial);
+
+    void list(Print& serial) const;
+
+    /**
+     * @brief 每次set/defaults递增，调用者可据此判断参数是否变化
+     */
+    uint16_t getVersion() const { return _version; }
+
+private:
+    uint32_t _values[PARAM_COUNT];
+    uint16_t _version;
+    ChangeCallback _cb;
+    void* _cbCtx;
+    char _path[24];
+
+    void printParam(ParamId id, Print& serial) const;
+    bool consistent(ParamId id, uint32_t value) const;
+};
+
+/**
+ * @class CommandLine
+ * @brief 非阻塞串口行缓冲
+ *
+ * 逐字符送入，遇到换行返回完整的一行（去掉首尾空白），空行忽略，超长行丢弃。
+ * 单字符命令兼容不发送换行的终端：行首只有一个字符且之后PARAM_KEY_IDLE_MS内
+ * 没有新字符时，idle()把它作为一行返回
+ */
+class CommandLine {
+public:
+    CommandLine() : _len(0), _overflow(false), _lastMs(0) {}
+
+    /**
+     * @brief 送入一个字符
+     *
+     * @return 完整的一行，未结束返回nullptr
+     */
+    const char* feed(char c);
+
+    /**
+     * @brief 每次循环调用，检查单字符命令是否已空闲超时
+     *
+     * @return 单字符的一行，否则返回nullptr
+     */
+    const char* idle();
+
+private:
+    char _buf[PARAM_LINE_BYTES];
+    uint8_t _len;
+    bool _overflow;
+    uint32_t _lastMs;
+};
+
+extern ParamRegistry params;
+
+#endif // PARAM_REGISTRY_H
@@ -0,0 +1,307 @@
+/*
+ * profile_generator.cpp - 合成充电曲线负载生成与浸泡测试实现
+ */
+
+#include "profile_generator.h"
+#include "display.h"
+#include <chrono>
+
+// ===== 负载脚本 =====
+// 脚本循环执行；时长单位ms，电压mV，电流mA，温度°C
+
+static const ProfileSegment PLUG_STORM[] = {
+    {  800, 0,                                   SW3538_FC_NONE, 0, 5000, 5000,    0,    0,   0,   0, 30, 30 },
+    {  400, PSEG_ONLINE1 | PSEG_BUCK1,           SW3538_FC_NONE, 0, 5000, 5000, 1200,  500,   0,   0, 30, 30 },
+    {  300, 0,                                   SW3538_FC_NONE, 0, 5000, 5000,    0,    0,   0,   0, 30, 30 },
+    { 1500, PSEG_ONLINE1 | PSEG_ONLINE2 | PSEG_BUCK1 | PSEG_BUCK2,
+                                                 SW3538_FC_NONE, 0, 5000, 5000,  900,  900, 600, 600, 30, 31 },
+    {  150, PSEG_ONLINE2 | PSEG_BUCK2,           SW3538_FC_NONE, 0, 5000, 5000,    0,    0, 600, 600, 31, 31 },
+    {   90, PSEG_ONLINE1 | PSEG_ONLINE2 | PSEG_BUCK1 | PSEG_BUCK2,
+                                                 SW3538_FC_NONE, 0, 5000, 5000, 1500,  900, 600, 600, 31, 31 },
+    {  600, 0,                                   SW3538_FC_NONE, 0, 5000, 5000,    0,    0,   0,   0, 31, 30 },
+};
+
+static const ProfileSegment PD_FIXED[] = {
+    {  2000, 0,                                  SW3538_FC_NONE,   0,  5000,  5000,    0,    0, 0, 0, 30, 30 },
+    {  1500, PSEG_ONLINE1 | PSEG_BUCK1,          SW3538_FC_NONE,   0,  5000,  5000,    0,  500, 0, 0, 30, 30 },
+    { 60000, PSEG_ONLINE1 | PSEG_BUCK1 | PSEG_FAST, SW3538_FC_PD_FIX, 2,  9000,  9000, 2000, 2000, 0, 0, 30, 45 },
+    { 60000, PSEG_ONLINE1 | PSEG_BUCK1 | PSEG_FAST, SW3538_FC_PD_FIX, 2, 20000, 20000, 3000, 3000, 0, 0, 45, 60 },
+    { 30000, PSEG_ONLINE1 | PSEG_BUCK1 | PSEG_FAST, SW3538_FC_PD_FIX, 2, 20000, 20000, 3000,  300, 0, 0, 60, 50 },
+    {  3000, 0,                                  SW3538_FC_NONE,   0,  5000,  5000,    0,    0, 0, 0, 50, 45 },
+};
+
+static const ProfileSegment PD_PPS[] = {
+    {   2000, 0,                                 SW3538_FC_NONE,   0,  5000,  5000,    0,    0, 0, 0, 30, 30 },
+    {   1000, PSEG_ONLINE1 | PSEG_BUCK1,         SW3538_FC_NONE,   0,  5000,  5000,    0,  500, 0, 0, 30, 30 },
+    {  30000, PSEG_ONLINE1 | PSEG_BUCK1 | PSEG_FAST, SW3538_FC_PD_PPS, 2,  5000, 11000,  500, 3000, 0, 0, 30, 35 },
+    { 120000, PSEG_ONLINE1 | PSEG_BUCK1 | PSEG_FAST, SW3538_FC_PD_PPS, 2, 11000,  8400, 3000, 2500, 0, 0, 35, 50 },
+    {   2000, 0,                                 SW3538_FC_NONE,   0,  5000,  5000,    0,    0, 0, 0, 50, 45 },
+};
+
+static const ProfileSegment QC3_RAMP[] = {
+    {  2000, 0,                                  SW3538_FC_NONE,  0,  5000,  5000, 0, 0,    0,    0, 30, 30 },
+    {  1000, PSEG_ONLINE2 | PSEG_BUCK2,          SW3538_FC_NONE,  0,  5000,  5000, 0, 0,    0,  300, 30, 30 },
+    { 20000, PSEG_ONLINE2 | PSEG_BUCK2 | PSEG_FAST, SW3538_FC_QC3_0, 0,  5000, 12000, 0, 0,  500, 1800, 30, 35 },
+    { 90000, PSEG_ONLINE2 | PSEG_BUCK2 | PSEG_FAST, SW3538_FC_QC3_0, 0, 12000, 12000, 0, 0, 1800, 1500, 35, 48 },
+    {  1000, 0,                                  SW3538_FC_NONE,  0,  5000,  5000, 0, 0,    0,    0, 48, 45 },
+};
+
+static const ProfileSegment THERMAL_DRIFT[] = {
+    { 600000, PSEG_ONLINE1 | PSEG_ONLINE2 | PSEG_BUCK1 | PSEG_BUCK2 | PSEG_FAST,
+                                                 SW3538_FC_PD_FIX, 2, 9000, 9000, 2000, 2000, 1500, 1500, 25, 88 },
+    { 600000, PSEG_ONLINE1 | PSEG_ONLINE2 | PSEG_BUCK1 | PSEG_BUCK2 | PSEG_FAST,
+                                                 SW3538_FC_PD_FIX, 2, 9000, 9000, 2000, 1000, 1500, 1500, 88, 40 },
+    {   5000, 0,                                 SW3538_FC_NONE,   0, 5000, 5000,    0,    0,    0,    0, 40, 35 },
+};
+
+struct ProfileTable {
+    const char* name;
+    const ProfileSegment* segments;
+    uint8_t count;
+};
+
+#define PROFILE_ENTRY(name, table) { name, table, sizeof(table) / sizeof(table[0]) }
+
+static const ProfileTable PROFILES[PROFILE_COUNT] = {
+    PROFILE_ENTRY("plug-storm", PLUG_STORM),
+    PROFILE_ENTRY("pd-fixed", PD_FIXED),
+    PROFILE_ENTRY("pd-pps", PD_PPS),
+    PROFILE_ENTRY("qc3-ramp", QC3_RAMP),
+    PROFILE_ENTRY("thermal-drift", THERMAL_DRIFT),
+};
+
+// ===== ProfileGenerator =====
+
+ProfileGenerator::ProfileGenerator()
+    : _segments(PLUG_STORM), _segmentCount(1), _segIndex(0), _segStartMs(0),
+      _lastFlags(0), _lastProtocol(0), _lastPd(0), _expected(0),
+      _rng(1), _noiseMA(10), _noiseMV(20) {
+}
+
+const char* ProfileGenerator::getProfileName(LoadProfile profile) {
+    return profile < PROFILE_COUNT ? PROFILES[profile].name : "UNKNOWN";
+}
+
+void ProfileGenerator::begin(LoadProfile profile, uint32_t seed) {
+    if (profile >= PROFILE_COUNT) profile = PROFILE_PLUG_STORM;
+    _segments = PROFILES[profile].segments;
+    _segmentCount = PROFILES[profile].count;
+    _rng = seed ? seed : 1;
+
+    // 与事件总线的初始比较状态一致：全部离线、无快充
+    _lastFlags = 0;
+    _lastProtocol = 0;
+    _lastPd = 0;
+    _expected = 0;
+
+    _segIndex = 0;
+    _segStartMs = 0;
+    enterSegment(0);
+}
+
+void ProfileGenerator::expect(SW3538_EventType type, uint32_t timeMs) {
+    uint32_t bit = SW3538_EVT_MASK(type);
+    if (!(_expected & bit)) _changeMs[type] = timeMs;  // 未检测前重复发生按最早时刻计
+    _expected |= bit;
+}
+
+// 与上一段比较，登记期望产生的事件
+void ProfileGenerator::enterSegment(uint32_t timeMs) {
+    const ProfileSegment& seg = _segments[_segIndex];
+    uint8_t rise = seg.flags & ~_lastFlags;
+    uint8_t fall = _lastFlags & ~seg.flags;
+
+    if (rise & (PSEG_ONLINE1 | PSEG_ONLINE2)) expect(SW3538_EVT_PATH_ONLINE, timeMs);
+    if (fall & (PSEG_ONLINE1 | PSEG_ONLINE2)) expect(SW3538_EVT_PATH_OFFLINE, timeMs);
+    if (rise & (PSEG_BUCK1 | PSEG_BUCK2)) expect(SW3538_EVT_BUCK_ON, timeMs);
+    if (fall & (PSEG_BUCK1 | PSEG_BUCK2)) expect(SW3538_EVT_BUCK_OFF, timeMs);
+    if (rise & PSEG_FAST) expect(SW3538_EVT_FAST_CHARGE_ON, timeMs);
+    if (fall & PSEG_FAST) expect(SW3538_EVT_FAST_CHARGE_OFF, timeMs);
+    if (seg.protocol != _lastProtocol) expect(SW3538_EVT_PROTOCOL_CHANGE, timeMs);
+    if (seg.pdVersion != _lastPd) expect(SW3538_EVT_PD_VERSION_CHANGE, timeMs);
+
+    _lastFlags = seg.flags;
+    _lastProtocol = seg.protocol;
+    _lastPd = seg.pdVersion;
+}
+
+uint32_t ProfileGenerator::nextRandom() {
+    // xorshift32
+    _rng ^= _rng << 13;
+    _rng ^= _rng >> 17;
+    _rng ^= _rng << 5;
+    return _rng;
+}
+
+int32_t ProfileGenerator::noise(uint16_t amplitude) {
+    if (amplitude == 0) return 0;
+    return (int32_t)(nextRandom() % (2UL * amplitude + 1)) - amplitude;
+}
+
+// NTC温度反算ADC原始值（20uA档），与SW3538::ntcRawToCelsius()互逆
+uint16_t ProfileGenerator::celsiusToNtcRaw(float tempC) {
+    const float B = 3950.0f;
+    const float T0 = 298.15f;
+    const float R0 = 10.0f;
+
+    float resistance = R0 * expf(B * (1.0f / (tempC + 273.15f) - 1.0f / T0));  // kOhm
+    float voltage = resistance * 20.0f;                                          // mV
+    return (uint16_t)(voltage / 1.2f + 0.5f);
+}
+
+void ProfileGenerator::sample(uint32_t timeMs, SW3538_RawFrame& frame) {
+    // 推进到timeMs所在的分段，每个分段边界都是一次真实状态变化
+    while (timeMs - _segStartMs >= _segments[_segIndex].durationMs) {
+        _segStartMs += _segments[_segIndex].durationMs;
+        _segIndex = (_segIndex + 1) % _segmentCount;
+        enterSegment(_segStartMs);
+    }
+
+    const ProfileSegment& seg = _segments[_segIndex];
+    float k = (float)(timeMs - _segStartMs) / seg.durationMs;
+
+    int32_t vout = seg.voutStart + (int32_t)((seg.voutEnd - seg.voutStart) * k);
+    if (seg.protocol == SW3538_FC_PD_PPS) vout -= vout % 20;         // PPS 20mV步进
+    else if (seg.protocol == SW3538_FC_QC3_0) vout -= vout % 200;    // QC3 200mV步进
+    vout += noise(_noiseMV);
+
+    int32_t i1 = 0, i2 = 0;
+    if (seg.flags & PSEG_ONLINE1) i1 = seg.i1Start + (int32_t)((seg.i1End - seg.i1Start) * k) + noise(_noiseMA);
+    if (seg.flags & PSEG_ONLINE2) i2 = seg.i2Start + (int32_t)((seg.i2End - seg.i2Start) * k) + noise(_noiseMA);
+    if (i1 < 0) i1 = 0;
+    if (i2 < 0) i2 = 0;
+
+    float temp = seg.tempStart + (seg.tempEnd - seg.tempStart) * k;
+
+    frame.version = 0x01;
+    frame.maxPower = 65;
+    frame.fastCharge = ((seg.flags & PSEG_FAST) ? 0x80 : 0) | ((seg.pdVersion & 0x03) << 4) | (seg.protocol & 0x0F);
+    frame.status0 = ((seg.flags & PSEG_BUCK1) ? 0x01 : 0) | ((seg.flags & PSEG_BUCK2) ? 0x02 : 0);
+    frame.status1 = ((seg.flags & PSEG_ONLINE1) ? 0x02 : 0) | ((seg.flags & PSEG_ONLINE2) ? 0x01 : 0);
+    frame.ntcState = 0;
+    frame.adc[SW3538_RAW_IBUS1] = (uint16_t)(i1 / 2.5f + 0.5f);
+    frame.adc[SW3538_RAW_IBUS2] = (uint16_t)(i2 / 2.5f + 0.5f);
+    frame.adc[SW3538_RAW_VIN] = (uint16_t)((20000 + noise(_noiseMV)) / 10);
+    frame.adc[SW3538_RAW_VOUT] = (uint16_t)(vout < 0 ? 0 : vout);
+    frame.adc[SW3538_RAW_NTC] = celsiusToNtcRaw(temp);
+}
+
+void ProfileGenerator::apply(uint32_t timeMs, SW3538SimBus& bus) {
+    SW3538_RawFrame frame;
+    sample(timeMs, frame);
+    bus.setFrame(frame);
+}
+
+uint32_t ProfileGenerator::acknowledge(uint32_t fired, uint32_t timeMs, uint32_t& latencySumMs, uint32_t& latencyMaxMs) {
+    uint32_t hit = fired & _expected;
+    for (uint8_t t = 0; t < SW3538_EVT_COUNT; t++) {
+        if (!(hit & SW3538_EVT_MASK(t))) continue;
+        uint32_t latency = timeMs - _changeMs[t];
+        latencySumMs += latency;
+        if (latency > latencyMaxMs) latencyMaxMs = latency;
+    }
+    _expected &= ~hit;
+    return hit;
+}
+
+uint16_t ProfileGenerator::expire(uint32_t timeMs) {
+    uint16_t n = 0;
+    for (uint8_t t = 0; t < SW3538_EVT_COUNT; t++) {
+        uint32_t bit = SW3538_EVT_MASK(t);
+        if ((_expected & bit) && timeMs - _changeMs[t] > SOAK_DETECT_TIMEOUT_MS) {
+            _expected &= ~bit;
+            n++;
+        }
+    }
+    return n;
+}
+
+// ===== SoakRunner =====
+
+SoakRunner::SoakRunner()
+    : _driver(SW3538_DEFAULT_ADDRESS, _bus),
+      _nackPermille(SOAK_NACK_PERMILLE), _glitchPermille(SOAK_GLITCH_PERMILLE) {
+}
+
+static void renderSnapshot(const SW3538Snapshot& snap, void*) {
+    renderSw3538Data(snap);
+}
+
+void SoakRunner::setRender(bool render) {
+    _pipeline.setRenderer(render ? renderSnapshot : nullptr);
+}
+
+void SoakRunner::run(LoadProfile profile, uint32_t durationMs, SoakResult& result, uint32_t seed) {
+    memset(&result, 0, sizeof(result));
+    _gen.begin(profile, seed);
+    _pipeline.reset();
+    _bus = SW3538SimBus();
+    _bus.setFaults(_nackPermille, _glitchPermille);
+    _driver = SW3538Sim(SW3538_DEFAULT_ADDRESS, _bus);
+
+    AdaptiveScan& scan = _pipeline.getScan();
+    uint32_t t = 0;
+
+    // 驱动的ADC转换等待推进的是虚拟时钟，耗时用真实时钟统计
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (t < durationMs) {
+        _gen.apply(t, _bus);
+        _driver.readAllData();
+        uint32_t fired = _pipeline.feed(t, _driver.getReadFrame(), result.pipeline,
+                                        _driver.getReadMask(), _driver.getValidMask());
+
+        uint32_t hit = _gen.acknowledge(fired, t, result.latencySumMs, result.latencyMaxMs);
+        result.detected += __builtin_popcount(hit);
+        result.missed += _gen.expire(t);
+
+        // 记录AdaptiveScan选择的间隔，虚拟时钟直接跳到下次扫描
+        uint32_t interval = scan.getCurrentInterval();
+        uint8_t bucket = 0;
+        for (uint32_t limit = 200; interval > limit && bucket < SOAK_INTERVAL_BUCKETS - 1; limit <<= 1) bucket++;
+        result.intervalScans[bucket]++;
+
+        t += interval;
+    }
+    result.pipeline.elapsedUs = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    result.pipeline.spanMs = t;
+    result.virtualMs = t;
+    result.reads = _driver.getReadStats();
+    result.injectedFaults = _bus.getInjectedFaults();
+}
+
+void SoakRunner::printResult(LoadProfile profile, const SoakResult& result, Print& serial) {
+    char buf[96];
+    const RawReplayResult& p = result.pipeline;
+
+    float hours = result.virtualMs / 3600000.0f;
+    float fps = p.elapsedUs ? p.frames * 1e6f / p.elapsedUs : 0.0f;
+    float speedup = p.elapsedUs ? result.virtualMs * 1000.0f / p.elapsedUs : 0.0f;
+    snprintf(buf, sizeof(buf), "[Soak] %s %.2fh in %lums, %.0f scan/s, x%.0f",
+             ProfileGenerator::getProfileName(profile), hours,
+             (unsigned long)(p.elapsedUs / 1000), fps, speedup);
+    serial.println(buf);
+
+    snprintf(buf, sizeof(buf), "[Soak] scans:%lu failed:%lu held:%lu events:%lu",
+             (unsigned long)p.frames, (unsigned long)p.decodeErrors, (unsigned long)p.heldFields,
+             (unsigned long)p.events);
+    serial.println(buf);
+
+    const SW3538_ReadStats& r = result.reads;
+    snprintf(buf, sizeof(buf), "[Soak] bus faults:%lu rereads:%lu confirmed:%lu held:%lu",
+             (unsigned long)result.injectedFaults, (unsigned long)r.rereads,
+             (unsigned long)r.confirmed, (unsigned long)r.held);
+    serial.println(buf);
+
+    snprintf(buf, sizeof(buf), "[Soak] interval 200/400/800/1600/3200/5000: %lu/%lu/%lu/%lu/%lu/%lu",
+             (unsigned long)result.intervalScans[0], (unsigned long)result.intervalScans[1],
+             (unsigned long)result.intervalScans[2], (unsigned long)result.intervalScans[3],
+             (unsigned long)result.intervalScans[4], (unsigned long)result.intervalScans[5]);
+    serial.println(buf);
+
+    uint32_t avg = result.detected ? result.latencySumMs / result.detected : 0;
+    snprintf(buf, sizeof(buf), "[Soak] detected:%lu missed:%lu latency avg:%lums max:%lums",
+             (unsigned long)result.detected, (unsigned long)result.missed,
+             (unsigned long)avg, (unsigned long)result.latencyMaxMs);
+    serial.println(buf);
+}
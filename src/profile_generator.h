@@ -0,0 +1,203 @@
+/*
+ * profile_generator.h - 合成充电曲线负载生成与浸泡测试
+ *
+ * 设计说明：
+ * 1. 模拟SW3538寄存器：按脚本分段（接入状态、协议、电压/电流/温度线性变化）
+ *    在虚拟时钟上生成芯片的寄存器状态（真值，含负载波动噪声），写入SW3538SimBus；
+ *    总线故障（无应答、0xFF毛刺）由SW3538SimBus注入，经驱动的重读和毛刺判定处理
+ * 2. 脚本以常量表描述，覆盖插拔风暴、PD固定档、PPS调压、QC3步进、温度漂移
+ * 3. 分段切换时刻即为真实状态变化时刻，据此计算事件检测延迟
+ * 4. 浸泡测试直接跳到AdaptiveScan给出的下次扫描时刻，数小时输入数秒跑完；
+ *    每次扫描由SW3538Sim::readAllData()从模拟总线读取，驱动的实际读数和有效位
+ *    经过RawReplay的完整处理链路（重新校验、解码、扫描、显示数据、事件，可选渲染）
+ *
+ * 仅用于主机（不进固件构建）；浸泡测试入口为test/host/soak_main.cpp（make -C test/host soak）
+ */
+
+#ifndef PROFILE_GENERATOR_H
+#define PROFILE_GENERATOR_H
+
+#include <Arduino.h>
+#include "SW3538.h"
+#include "raw_record.h"
+#include "sim_bus.h"
+
+// 事件超过该时间仍未检测到视为漏检（大于最长扫描间隔）
+#ifndef SOAK_DETECT_TIMEOUT_MS
+#define SOAK_DETECT_TIMEOUT_MS   10000
+#endif
+
+// 浸泡测试默认总线故障率（千分比，见SW3538SimBus::setFaults()）
+#ifndef SOAK_NACK_PERMILLE
+#define SOAK_NACK_PERMILLE       1
+#endif
+#ifndef SOAK_GLITCH_PERMILLE
+#define SOAK_GLITCH_PERMILLE     1
+#endif
+
+// 扫描间隔分布桶数：200/400/800/1600/3200/更长
+#define SOAK_INTERVAL_BUCKETS    6
+
+enum LoadProfile : uint8_t {
+    PROFILE_PLUG_STORM = 0,   // 频繁插拔、冲击电流
+    PROFILE_PD_FIXED,         // PD固定档 9V→20V，恒流后涓流
+    PROFILE_PD_PPS,           // PPS 20mV步进调压
+    PROFILE_QC3_RAMP,         // QC3 200mV步进升压
+    PROFILE_THERMAL_DRIFT,    // 双路长时间充电，温度缓慢升降
+    PROFILE_COUNT
+};
+
+// 分段状态标志
+#define PSEG_ONLINE1   0x01
+#define PSEG_ONLINE2   0x02
+#define PSEG_BUCK1     0x04
+#define PSEG_BUCK2     0x08
+#define PSEG_FAST      0x10
+
+/**
+ * @brief 脚本分段，段内电压/电流/温度从Start线性变化到End
+ */
+struct ProfileSegment {
+    uint32_t durationMs;
+    uint8_t flags;            // PSEG_*
+    uint8_t protocol;         // SW3538_FastChargeProtocol
+    uint8_t pdVersion;
+    uint16_t voutStart, voutEnd;   // mV
+    uint16_t i1Start, i1End;       // mA
+    uint16_t i2Start, i2End;       // mA
+    int16_t tempStart, tempEnd;    // °C
+};
+
+/**
+ * @class ProfileGenerator
+ * @brief 脚本驱动的SW3538寄存器模拟
+ */
+class ProfileGenerator {
+public:
+    ProfileGenerator();
+
+    /**
+     * @brief 选择脚本并从虚拟时间0开始
+     *
+     * @param seed 噪声和故障的随机种子，相同种子结果可复现
+     */
+    void begin(LoadProfile profile, uint32_t seed = 1);
+
+    /**
+     * @brief 设置负载波动噪声幅度（均匀分布±值），ADC转换噪声由SW3538SimBus::setNoise()设置
+     */
+    void setNoise(uint16_t currentMA, uint16_t voltageMV) { _noiseMA = currentMA; _noiseMV = voltageMV; }
+
+    /**
+     * @brief 生成虚拟时刻芯片的寄存器状态
+     *
+     * @param timeMs 虚拟时间，必须单调不减
+     * @param frame 输出寄存器状态（真值，不含总线故障）
+     */
+    void sample(uint32_t timeMs, SW3538_RawFrame& frame);
+
+    /**
+     * @brief 生成虚拟时刻的寄存器状态并写入模拟总线
+     */
+    void apply(uint32_t timeMs, SW3538SimBus& bus);
+
+    /**
+     * @brief 确认已检测到的事件
+     *
+     * @param fired 处理链路本次触发的事件掩码
+     * @param timeMs 检测时刻
+     * @param latencySumMs 累加：已确认事件的检测延迟之和
+     * @param latencyMaxMs 更新：最大检测延迟
+     * @return 已确认的期望事件掩码
+     */
+    uint32_t acknowledge(uint32_t fired, uint32_t timeMs, uint32_t& latencySumMs, uint32_t& latencyMaxMs);
+
+    /**
+     * @brief 超时未检测的期望事件计为漏检并清除
+     *
+     * @return 本次清除的事件个数
+     */
+    uint16_t expire(uint32_t timeMs);
+
+    static const char* getProfileName(LoadProfile profile);
+
+private:
+    const ProfileSegment* _segments;
+    uint8_t _segmentCount;
+    uint8_t _segIndex;
+    uint32_t _segStartMs;
+    uint8_t _lastFlags;
+    uint8_t _lastProtocol;
+    uint8_t _lastPd;
+
+    uint32_t _expected;                        // 尚未检测到的期望事件掩码
+    uint32_t _changeMs[SW3538_EVT_COUNT];      // 各期望事件的真实发生时刻
+
+    uint32_t _rng;
+    uint16_t _noiseMA;
+    uint16_t _noiseMV;
+
+    void enterSegment(uint32_t timeMs);
+    void expect(SW3538_EventType type, uint32_t timeMs);
+    uint32_t nextRandom();
+    int32_t noise(uint16_t amplitude);
+    static uint16_t celsiusToNtcRaw(float tempC);
+};
+
+/**
+ * @brief 浸泡测试统计
+ */
+struct SoakResult {
+    RawReplayResult pipeline;                  // 帧数、读失败帧、保持的字段、事件数、耗时
+    uint32_t virtualMs;                        // 模拟的时间长度
+    uint32_t detected;                         // 检测到的期望事件数
+    uint32_t missed;                           // 漏检（超时或状态在扫描前已恢复）
+    uint32_t latencySumMs;
+    uint32_t latencyMaxMs;
+    uint32_t intervalScans[SOAK_INTERVAL_BUCKETS];  // AdaptiveScan各间隔档的扫描次数
+    SW3538_ReadStats reads;                    // 驱动的重读、确认、保持次数
+    uint32_t injectedFaults;                   // 模拟总线注入的故障数
+};
+
+/**
+ * @class SoakRunner
+ * @brief 在虚拟时钟上运行负载脚本
+ */
+class SoakRunner {
+public:
+    SoakRunner();
+
+    /**
+     * @brief 运行一个脚本
+     *
+     * @param profile 负载脚本
+     * @param durationMs 虚拟时长
+     * @param result 输出统计
+     * @param seed 随机种子
+     */
+    void run(LoadProfile profile, uint32_t durationMs, SoakResult& result, uint32_t seed = 1);
+
+    /**
+     * @brief 是否渲染到OLED帧缓冲区（不发送到屏幕），默认关闭
+     */
+    void setRender(bool render);
+
+    /**
+     * @brief 设置模拟总线的故障率（千分比），下次run()生效
+     */
+    void setBusFaults(uint16_t nackPermille, uint16_t glitchPermille) { _nackPermille = nackPermille; _glitchPermille = glitchPermille; }
+
+    ProfileGenerator& getGenerator() { return _gen; }
+
+    static void printResult(LoadProfile profile, const SoakResult& result, Print& serial);
+
+private:
+    ProfileGenerator _gen;
+    SW3538SimBus _bus;
+    SW3538Sim _driver;
+    RawReplay _pipeline;
+    uint16_t _nackPermille;
+    uint16_t _glitchPermille;
+};
+
+#endif // PROFILE_GENERATOR_H
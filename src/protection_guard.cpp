@@ -0,0 +1,131 @@
+/*
+ * protection_guard.cpp - 有界延迟的过温/过流守护实现
+ */
+
+#include "protection_guard.h"
+
+ProtectionGuard::ProtectionGuard()
+    : _driver(nullptr), _guarded(GUARD_NONE), _periodUs(10000), _lastSampleUs(0),
+      _maxGapUs(0), _lastLatencyUs(0), _rejected(0), _callback(nullptr), _callbackCtx(nullptr) {
+    _limit[GUARD_TEMP] = 90;
+    _margin[GUARD_TEMP] = 5;
+    _limit[GUARD_CURRENT1] = _limit[GUARD_CURRENT2] = 3300;
+    _margin[GUARD_CURRENT1] = _margin[GUARD_CURRENT2] = 300;
+    for (uint8_t i = 0; i < GUARD_CH_COUNT; i++) _tripped[i] = false;
+}
+
+void ProtectionGuard::begin(SW3538& driver) {
+    _driver = &driver;
+}
+
+void ProtectionGuard::setTempLimit(int16_t limitC, int16_t marginC) {
+    _limit[GUARD_TEMP] = limitC;
+    _margin[GUARD_TEMP] = marginC;
+}
+
+void ProtectionGuard::setCurrentLimit(int16_t limitMA, int16_t marginMA) {
+    _limit[GUARD_CURRENT1] = _limit[GUARD_CURRENT2] = limitMA;
+    _margin[GUARD_CURRENT1] = _margin[GUARD_CURRENT2] = marginMA;
+}
+
+uint8_t ProtectionGuard::adcChannel(GuardChannel ch) {
+    switch (ch) {
+        case GUARD_TEMP:     return SW3538_ADC_CH_NTC;
+        case GUARD_CURRENT1: return SW3538_ADC_CH_IBUS1;
+        case GUARD_CURRENT2: return SW3538_ADC_CH_IBUS2;
+        default:             return SW3538_ADC_CH_NONE;
+    }
+}
+
+float ProtectionGuard::toValue(GuardChannel ch, uint16_t raw) const {
+    if (ch == GUARD_TEMP) {
+        return SW3538::ntcRawToCelsius(raw, _driver->isNtc40uA());
+    }
+    return SW3538::adcToValue(adcChannel(ch), raw);
+}
+
+// 越限判断与锁存
+void ProtectionGuard::evaluate(GuardChannel ch, float value, uint32_t nowUs, uint32_t lastUs) {
+    if (ch == GUARD_TEMP && value == -999) return;
+
+    if (!_tripped[ch] && value >= _limit[ch]) {
+        _tripped[ch] = true;
+        _lastLatencyUs = nowUs - lastUs;
+        if (_callback) _callback(ch, value, _lastLatencyUs, _callbackCtx);
+    } else if (_tripped[ch] && value < _limit[ch] - _margin[ch]) {
+        _tripped[ch] = false;
+    }
+}
+
+void ProtectionGuard::update(const SW3538_Data_t& data) {
+    if (_driver == nullptr) return;
+
+    const float values[GUARD_CH_COUNT] = {
+        (float)data.ntcTemperatureC, (float)data.currentPath1mA, (float)data.currentPath2mA
+    };
+    uint32_t now = micros();
+
+    // 常规扫描本身也是一次检测机会，延迟以扫描间隔计
+    GuardChannel closest = GUARD_NONE;
+    float bestHeadroom = 0.0f;
+    for (uint8_t i = 0; i < GUARD_CH_COUNT; i++) {
+        GuardChannel ch = (GuardChannel)i;
+        if (ch == GUARD_TEMP && data.ntcTemperatureC == -999) continue;
+
+        evaluate(ch, values[i], now, _lastSampleUs);
+
+        // 剩余裕量比例最小的通道优先守护
+        float headroom = (_limit[i] - values[i]) / (float)(_margin[i] > 0 ? _margin[i] : 1);
+        if (headroom < 1.0f && (closest == GUARD_NONE || headroom < bestHeadroom)) {
+            closest = ch;
+            bestHeadroom = headroom;
+        }
+    }
+    _lastSampleUs = now;
+
+    if (closest != _guarded) {
+        if (closest == GUARD_NONE) {
+            _driver->releaseFastRead(this);   // 退出守护，通道交还突发采集
+        } else if (_guarded != GUARD_NONE && _driver->getFastOwner() == this) {
+            _driver->endFastRead();
+        }
+        _guarded = closest;
+        _maxGapUs = 0;
+    }
+}
+
+void ProtectionGuard::service() {
+    if (_guarded == GUARD_NONE) return;
+
+    uint32_t now = micros();
+    uint32_t gap = now - _lastSampleUs;
+    if (gap < _periodUs) return;
+
+    // 守护优先：抢占突发采集的快速读取通道
+    uint8_t channel = adcChannel(_guarded);
+    _driver->claimFastRead(this, true);
+    if (_driver->getFastChannel() != channel && !_driver->beginFastRead(channel)) return;
+
+    uint16_t raw;
+    if (!_driver->readFast(raw)) return;
+    float value = toValue(_guarded, raw);
+
+    // 快速读取不经过readAllData()的校验：越限读数再读一次确认，
+    // 单次毛刺（如低字节读到0xFF）不触发关断；确认读失败时本周期不判定
+    if (!_tripped[_guarded] && value >= _limit[_guarded]) {
+        if (!_driver->readFast(raw)) return;
+        float again = toValue(_guarded, raw);
+        if (again < _limit[_guarded]) {
+            _rejected++;
+            return;
+        }
+        value = again;
+    }
+
+    now = micros();
+    gap = now - _lastSampleUs;
+    if (gap > _maxGapUs) _maxGapUs = gap;
+
+    evaluate(_guarded, value, now, _lastSampleUs);
+    _lastSampleUs = now;
+}
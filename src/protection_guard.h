@@ -0,0 +1,133 @@
+/*
+ * protection_guard.h - 有界延迟的过温/过流守护
+ *
+ * 设计说明：
+ * 1. 常规扫描时检查温度和两路电流，距离限值小于裕量时进入守护模式
+ * 2. 守护模式下用驱动的单通道快速读取路径，以固定周期只采样该通道
+ * 3. 快速读取不经过readAllData()的毛刺校验：高字节0xFF由驱动按读失败丢弃，
+ *    越限读数再读一次确认后才触发，单次毛刺（低字节0xFF可使3.2A读成3.8A）不会误关断
+ * 4. 越限立即回调。检测延迟上界 = 守护周期 + 主循环中最长的一次阻塞 + 重新选通 + 两次快速读取。
+ *    100kHz、默认配置下最长阻塞是未过采样的readAllData()（约42ms，会清除快速读取选通），
+ *    上界约 10 + 42 + 7 + 1.6 ≈ 61ms（主机模拟实测见test/host/test_protection_guard.cpp）。
+ *    以下路径同样阻塞主循环，启用时上界按其耗时增大：
+ *    - 过采样的readAllData()：每通道4^k次快速读取，k=4时约5×256×0.8ms ≈ 1s
+ *    - BurstCapture触发后的capturePost()：BURST_POST_SAMPLES次快速读取，512次约0.4s
+ *    - SampleLog/RawRecorder落盘：LittleFS写块，需擦除扇区时数十毫秒
+ *    守护期间实际观测到的最大采样间隔由getMaxGapUs()给出
+ * 5. 只有常规扫描能进入守护模式：数值从限值-裕量升到限值所用时间须长于扫描间隔，
+ *    否则越限时尚未守护，延迟以扫描间隔计
+ * 6. 触发后锁存，数值回落到限值-裕量以下才重新布防
+ *
+ * 与BurstCapture共用驱动的快速读取通道：守护期间以claimFastRead(this, true)抢占，
+ * 退出守护时释放，突发采集在此期间暂停，不会互相重新选通
+ */
+
+#ifndef PROTECTION_GUARD_H
+#define PROTECTION_GUARD_H
+
+#include <Arduino.h>
+#include "SW3538.h"
+
+enum GuardChannel : uint8_t {
+    GUARD_TEMP = 0,       // NTC温度 °C
+    GUARD_CURRENT1,       // 通路1电流 mA
+    GUARD_CURRENT2,       // 通路2电流 mA
+    GUARD_CH_COUNT,
+    GUARD_NONE = 0xFF
+};
+
+/**
+ * @brief 越限回调
+ *
+ * @param ch 越限通道
+ * @param value 越限时的测量值（°C或mA）
+ * @param latencyUs 上一个未越限样本到本次检测的时间，即检测延迟上界
+ * @param ctx 注册时传入的上下文
+ */
+typedef void (*GuardCallback)(GuardChannel ch, float value, uint32_t latencyUs, void* ctx);
+
+/**
+ * @class ProtectionGuard
+ * @brief 软件过温/过流守护
+ */
+class ProtectionGuard {
+public:
+    ProtectionGuard();
+
+    void begin(SW3538& driver);
+
+    /**
+     * @brief 设置温度限值
+     *
+     * @param limitC 限值，单位°C
+     * @param marginC 进入守护模式的裕量，单位°C
+     */
+    void setTempLimit(int16_t limitC, int16_t marginC = 5);
+
+    /**
+     * @brief 设置通路电流限值（两路共用）
+     *
+     * @param limitMA 限值，单位mA
+     * @param marginMA 进入守护模式的裕量，单位mA
+     */
+    void setCurrentLimit(int16_t limitMA, int16_t marginMA = 300);
+
+    /**
+     * @brief 设置守护模式采样周期
+     *
+     * @param us 周期，单位us，默认10ms
+     */
+    void setGuardPeriod(uint32_t us) { _periodUs = us; }
+
+    void setCallback(GuardCallback cb, void* ctx = nullptr) { _callback = cb; _callbackCtx = ctx; }
+
+    /**
+     * @brief 常规扫描后调用，决定是否进入/退出守护模式
+     */
+    void update(const SW3538_Data_t& data);
+
+    /**
+     * @brief 主循环中调用，守护模式下按周期快速采样
+     */
+    void service();
+
+    GuardChannel getGuardedChannel() const { return _guarded; }
+    bool isTripped(GuardChannel ch) const { return _tripped[ch]; }
+
+    /**
+     * @brief 守护期间观测到的最大采样间隔，单位us
+     */
+    uint32_t getMaxGapUs() const { return _maxGapUs; }
+
+    /**
+     * @brief 最近一次越限的检测延迟，单位us
+     */
+    uint32_t getLastLatencyUs() const { return _lastLatencyUs; }
+
+    /**
+     * @brief 越限但确认读未越限（判定为毛刺）的次数
+     */
+    uint32_t getRejected() const { return _rejected; }
+
+private:
+    SW3538* _driver;
+    int16_t _limit[GUARD_CH_COUNT];
+    int16_t _margin[GUARD_CH_COUNT];
+    bool _tripped[GUARD_CH_COUNT];
+
+    GuardChannel _guarded;
+    uint32_t _periodUs;
+    uint32_t _lastSampleUs;
+    uint32_t _maxGapUs;
+    uint32_t _lastLatencyUs;
+    uint32_t _rejected;
+
+    GuardCallback _callback;
+    void* _callbackCtx;
+
+    static uint8_t adcChannel(GuardChannel ch);
+    float toValue(GuardChannel ch, uint16_t raw) const;
+    void evaluate(GuardChannel ch, float value, uint32_t nowUs, uint32_t lastUs);
+};
+
+#endif // PROTECTION_GUARD_H
@@ -0,0 +1,391 @@
+/*
+ * raw_record.cpp - 原始寄存器帧录制与加速回放实现
+ */
+
+#include "raw_record.h"
+#include "global_data.h"
+#include "flash_fs.h"
+
+#include <stddef.h>
+
+#ifdef ARDUINO
+#include <LittleFS.h>
+#else
+#include <stdio.h>
+#endif
+
+#define RAW_FILE_MAGIC     0x5752      // "RW"
+#define RAW_FILE_VERSION   2           // 2：增加读到/有效掩码
+#define RAW_HEADER_BYTES   8
+#define RAW_MAX_RECORD     (5 + 2 + 6 + 2 * SW3538_RAW_ADC_COUNT + 4)  // 时间差+掩码+全部字段+读到/有效掩码
+#define RAW_MASKS_BIT      (1 << (6 + SW3538_RAW_ADC_COUNT))
+
+// 回放时录制间隔与AdaptiveScan间隔的允许偏差（读取耗时、主循环抖动）
+#ifndef RAW_REPLAY_TOLERANCE_MS
+#define RAW_REPLAY_TOLERANCE_MS  50
+#endif
+
+// ===== 存储后端 =====
+// 与SampleLog相同：每次操作独立打开/关闭文件，按缓冲区批量读写
+
+#ifdef ARDUINO
+
+// 与SampleLog共用挂载，只格式化从未格式化的分区
+static bool storageMount() {
+    return flashFsMount();
+}
+
+static bool storageWrite(const char* path, const void* buf, size_t len, bool append) {
+    File f = LittleFS.open(path, append ? FILE_APPEND : FILE_WRITE);
+    if (!f) return false;
+    size_t n = f.write((const uint8_t*)buf, len);
+    f.close();
+    return n == len;
+}
+
+static size_t storageRead(const char* path, uint32_t offset, void* buf, size_t len) {
+    File f = LittleFS.open(path, FILE_READ);
+    if (!f) return 0;
+    size_t n = 0;
+    if (f.seek(offset)) n = f.read((uint8_t*)buf, len);
+    f.close();
+    return n;
+}
+
+#else
+
+static bool storageMount() {
+    return true;
+}
+
+static bool storageWrite(const char* path, const void* buf, size_t len, bool append) {
+    FILE* f = fopen(path, append ? "ab" : "wb");
+    if (!f) return false;
+    size_t n = fwrite(buf, 1, len, f);
+    fclose(f);
+    return n == len;
+}
+
+static size_t storageRead(const char* path, uint32_t offset, void* buf, size_t len) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return 0;
+    size_t n = 0;
+    if (fseek(f, offset, SEEK_SET) == 0) n = fread(buf, 1, len, f);
+    fclose(f);
+    return n;
+}
+
+#endif
+
+// ===== 记录编码 =====
+// 字段顺序：version, maxPower, fastCharge, status0, status1, ntcState（各1字节），
+// adc[0..4]（各2字节，小端）；掩码第i位表示第i个字段与上一帧不同，
+// 第11位表示其后跟读到掩码和有效掩码（各2字节，与上一帧不同时才写）
+
+static inline size_t putVarint(uint8_t* out, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+static inline bool getVarint(const uint8_t*& p, const uint8_t* end, uint32_t& v) {
+    v = 0;
+    for (uint8_t shift = 0; shift < 35 && p < end; shift += 7) {
+        uint8_t b = *p++;
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+static const uint8_t REG_OFFSET[6] = {
+    offsetof(SW3538_RawFrame, version), offsetof(SW3538_RawFrame, maxPower),
+    offsetof(SW3538_RawFrame, fastCharge), offsetof(SW3538_RawFrame, status0),
+    offsetof(SW3538_RawFrame, status1), offsetof(SW3538_RawFrame, ntcState)
+};
+
+static inline uint8_t regGet(const SW3538_RawFrame& f, uint8_t i) {
+    return ((const uint8_t*)&f)[REG_OFFSET[i]];
+}
+
+static inline void regSet(SW3538_RawFrame& f, uint8_t i, uint8_t v) {
+    ((uint8_t*)&f)[REG_OFFSET[i]] = v;
+}
+
+// 录制的一帧：校验前的读数和驱动的校验结果
+struct RawRecord {
+    SW3538_RawFrame frame;
+    uint16_t readMask;
+    uint16_t validMask;
+};
+
+static size_t encodeRecord(uint8_t* out, uint32_t dtMs, const RawRecord& cur, RawRecord& prev, bool all) {
+    size_t n = putVarint(out, dtMs);
+    uint8_t* maskPos = out + n;
+    n += 2;
+
+    uint16_t mask = 0;
+    for (uint8_t i = 0; i < 6; i++) {
+        uint8_t v = regGet(cur.frame, i);
+        if (all || v != regGet(prev.frame, i)) {
+            mask |= 1 << i;
+            out[n++] = v;
+        }
+    }
+    for (uint8_t i = 0; i < SW3538_RAW_ADC_COUNT; i++) {
+        uint16_t v = cur.frame.adc[i];
+        if (all || v != prev.frame.adc[i]) {
+            mask |= 1 << (6 + i);
+            out[n++] = (uint8_t)v;
+            out[n++] = (uint8_t)(v >> 8);
+        }
+    }
+    if (all || cur.readMask != prev.readMask || cur.validMask != prev.validMask) {
+        mask |= RAW_MASKS_BIT;
+        out[n++] = (uint8_t)cur.readMask;
+        out[n++] = (uint8_t)(cur.readMask >> 8);
+        out[n++] = (uint8_t)cur.validMask;
+        out[n++] = (uint8_t)(cur.validMask >> 8);
+    }
+    maskPos[0] = (uint8_t)mask;
+    maskPos[1] = (uint8_t)(mask >> 8);
+    prev = cur;
+    return n;
+}
+
+// 在上一帧基础上应用一条记录，数据不完整返回false
+static bool decodeRecord(const uint8_t*& p, const uint8_t* end, uint32_t& dtMs, RawRecord& rec) {
+    if (!getVarint(p, end, dtMs) || end - p < 2) return false;
+    uint16_t mask = p[0] | ((uint16_t)p[1] << 8);
+    p += 2;
+
+    for (uint8_t i = 0; i < 6; i++) {
+        if (!(mask & (1 << i))) continue;
+        if (p >= end) return false;
+        regSet(rec.frame, i, *p++);
+    }
+    for (uint8_t i = 0; i < SW3538_RAW_ADC_COUNT; i++) {
+        if (!(mask & (1 << (6 + i)))) continue;
+        if (end - p < 2) return false;
+        rec.frame.adc[i] = p[0] | ((uint16_t)p[1] << 8);
+        p += 2;
+    }
+    if (mask & RAW_MASKS_BIT) {
+        if (end - p < 4) return false;
+        rec.readMask = p[0] | ((uint16_t)p[1] << 8);
+        rec.validMask = p[2] | ((uint16_t)p[3] << 8);
+        p += 4;
+    }
+    return true;
+}
+
+// ===== RawRecorder =====
+
+RawRecorder::RawRecorder()
+    : _ready(false), _full(false), _first(true), _lastMs(0), _prevReadMask(0), _prevValidMask(0),
+      _frames(0), _fileBytes(0), _bufLen(0) {
+    _path[0] = '\0';
+    memset(&_prev, 0, sizeof(_prev));
+}
+
+bool RawRecorder::begin(const char* path) {
+    _ready = false;
+    if (!storageMount()) return false;
+
+    snprintf(_path, sizeof(_path), "%s", path);
+    uint8_t header[RAW_HEADER_BYTES] = {
+        (uint8_t)RAW_FILE_MAGIC, (uint8_t)(RAW_FILE_MAGIC >> 8),
+        RAW_FILE_VERSION, (uint8_t)sizeof(SW3538_RawFrame), 0, 0, 0, 0
+    };
+    if (!storageWrite(_path, header, sizeof(header), false)) return false;
+
+    _fileBytes = sizeof(header);
+    _bufLen = 0;
+    _frames = 0;
+    _first = true;
+    _full = false;
+    _ready = true;
+    return true;
+}
+
+bool RawRecorder::append(uint32_t timeMs, const SW3538_RawFrame& frame, uint16_t readMask, uint16_t validMask) {
+    if (!_ready || _full) return false;
+
+    if (_fileBytes + _bufLen + RAW_MAX_RECORD > RAW_RECORD_MAX_BYTES) {
+        flush();
+        _full = true;
+        return false;
+    }
+    if (_bufLen + RAW_MAX_RECORD > RAW_RECORD_BUFFER_BYTES && !flush()) {
+        return false;
+    }
+
+    // 首帧写绝对时间和全部字段
+    uint32_t dt = _first ? timeMs : timeMs - _lastMs;
+    RawRecord rec = { frame, readMask, validMask };
+    RawRecord prev = { _prev, _prevReadMask, _prevValidMask };
+    _bufLen += encodeRecord(_buf + _bufLen, dt, rec, prev, _first);
+    _prev = frame;
+    _prevReadMask = readMask;
+    _prevValidMask = validMask;
+    _lastMs = timeMs;
+    _first = false;
+    _frames++;
+    return true;
+}
+
+bool RawRecorder::flush() {
+    if (!_ready || _bufLen == 0) return _ready;
+    if (!storageWrite(_path, _buf, _bufLen, true)) return false;
+    _fileBytes += _bufLen;
+    _bufLen = 0;
+    return true;
+}
+
+// ===== RawReplay =====
+
+RawReplay::RawReplay()
+    : _speed(0), _renderer(nullptr), _rendererCtx(nullptr), _callback(nullptr), _callbackCtx(nullptr), _lastMs(0) {
+    memset(&_held, 0, sizeof(_held));
+    _events.subscribe(AdaptiveScan::EVENT_MASK, AdaptiveScan::onEvent, &_scan);
+}
+
+bool RawReplay::run(const char* path, RawReplayResult& result) {
+    memset(&result, 0, sizeof(result));
+
+    uint8_t buf[RAW_RECORD_BUFFER_BYTES];
+    size_t len = storageRead(path, 0, buf, RAW_HEADER_BYTES);
+    if (len != RAW_HEADER_BYTES ||
+        (buf[0] | ((uint16_t)buf[1] << 8)) != RAW_FILE_MAGIC ||
+        buf[2] != RAW_FILE_VERSION || buf[3] != sizeof(SW3538_RawFrame)) {
+        return false;
+    }
+
+    reset();
+
+    RawRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    uint32_t offset = RAW_HEADER_BYTES;
+    uint32_t timeMs = 0, firstMs = 0;
+    bool eof = false;
+    size_t pos = 0;
+    len = 0;
+
+    uint32_t startUs = micros();
+    for (;;) {
+        // 剩余数据不足一条完整记录时补充缓冲区
+        if (!eof && len - pos < RAW_MAX_RECORD) {
+            memmove(buf, buf + pos, len - pos);
+            len -= pos;
+            pos = 0;
+            size_t want = sizeof(buf) - len;
+            size_t n = storageRead(path, offset, buf + len, want);
+            offset += n;
+            len += n;
+            if (n < want) eof = true;
+        }
+        if (pos >= len) break;
+
+        const uint8_t* p = buf + pos;
+        uint32_t dt;
+        if (!decodeRecord(p, buf + len, dt, rec)) break;  // 末尾截断
+        pos = p - buf;
+
+        timeMs = result.frames == 0 ? dt : timeMs + dt;
+        if (result.frames == 0) firstMs = timeMs;
+
+        // 按倍速等待虚拟时钟
+        if (_speed > 0) {
+            uint32_t dueUs = (uint32_t)((uint64_t)(timeMs - firstMs) * 1000 / _speed);
+            uint32_t elapsed = micros() - startUs;
+            if (dueUs > elapsed) delayMicroseconds(dueUs - elapsed);
+        }
+
+        feed(timeMs, rec.frame, result, rec.readMask, rec.validMask);
+    }
+    result.elapsedUs = micros() - startUs;
+    result.spanMs = timeMs - firstMs;
+    return true;
+}
+
+void RawReplay::reset() {
+    _scan.begin();
+    SW3538EventBus::resetState(_eventState);
+    memset(&_held, 0, sizeof(_held));
+}
+
+// 与主循环扫描分支相同的处理顺序；快照为局部变量，不发布到全局
+// 校验前的读数重新校验：未读到或超出量程的槽位保持上次的值，
+// 录制时的有效掩码只能收紧（回放无法重读，重读一致才接受的读数以录制结果为准）
+uint32_t RawReplay::feed(uint32_t timeMs, const SW3538_RawFrame& frame, RawReplayResult& result,
+                         uint16_t readMask, uint16_t validMask) {
+    // 上一帧处理后的扫描间隔应与录制间隔一致
+    if (result.frames > 0) {
+        int32_t diff = (int32_t)(timeMs - _lastMs) - (int32_t)_scan.getCurrentInterval();
+        if (diff > RAW_REPLAY_TOLERANCE_MS || diff < -RAW_REPLAY_TOLERANCE_MS) {
+            result.intervalDiffs++;
+        }
+    }
+    result.frames++;
+    _lastMs = timeMs;
+    _scan.markScanned(timeMs);
+
+    uint16_t outOfRange;
+    SW3538::checkPlausibility(frame, outOfRange);
+    uint16_t valid = validMask & readMask & ~outOfRange;
+    if (valid != validMask) result.revalidated++;
+    result.heldFields += __builtin_popcount(SW3538_VALID_ALL & ~valid);
+    for (uint8_t s = 0; s < SW3538_SRC_COUNT; s++) {
+        if (valid & SW3538_VALID(s)) sw3538RawSet(_held, s, sw3538RawGet(frame, s));
+    }
+
+    // 与readAllData()相同：版本和最大功率都无效即为通信失败
+    SW3538_Data_t data;
+    memset(&data, 0, sizeof(data));
+    if (!(valid & (SW3538_VALID(SW3538_SRC_VERSION) | SW3538_VALID(SW3538_SRC_MAX_POWER))) ||
+        !SW3538::decodeRawFrame(_held, data)) {
+        result.decodeErrors++;
+        return 0;
+    }
+    data.validMask = valid;
+
+    // 电流读数无效时保持当前频率，同主循环
+    if ((valid & SW3538_VALID_CURRENTS) == SW3538_VALID_CURRENTS) {
+        _scan.updateCurrent(data.currentPath1mA + data.currentPath2mA);
+    }
+
+    SW3538Snapshot snap;
+    snap.data = data;
+    computeDisplayData(data, snap.display);
+    snap.version = result.frames;
+
+    uint32_t fired = _events.process(data, _eventState, 0);
+    result.events += __builtin_popcount(fired);
+
+    if (_renderer) _renderer(snap, _rendererCtx);
+    if (_callback) _callback(timeMs, data, _callbackCtx);
+    return fired;
+}
+
+void RawReplay::printResult(const RawReplayResult& result, Print& serial) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "[Replay] frames:%lu err:%lu events:%lu",
+             (unsigned long)result.frames, (unsigned long)result.decodeErrors,
+             (unsigned long)result.events);
+    serial.println(buf);
+
+    snprintf(buf, sizeof(buf), "[Replay] interval mismatch:%lu held:%lu revalidated:%lu",
+             (unsigned long)result.intervalDiffs, (unsigned long)result.heldFields,
+             (unsigned long)result.revalidated);
+    serial.println(buf);
+
+    float fps = result.elapsedUs ? result.frames * 1e6f / result.elapsedUs : 0.0f;
+    float speedup = result.elapsedUs ? result.spanMs * 1000.0f / result.elapsedUs : 0.0f;
+    snprintf(buf, sizeof(buf), "[Replay] %lums in %luus, %.0f frame/s, x%.0f",
+             (unsigned long)result.spanMs, (unsigned long)result.elapsedUs, fps, speedup);
+    serial.println(buf);
+}
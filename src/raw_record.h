@@ -0,0 +1,190 @@
+/*
+ * raw_record.h - 原始寄存器帧录制与加速回放
+ *
+ * 设计说明：
+ * 1. 录制：每次readAllData()后追加驱动校验前的读数（寄存器字节+ADC原始值，
+ *    含毛刺和读失败）、读到/有效掩码和采样时间，用于现场问题复现
+ * 2. 编码：时间差变长整数 + 16位变化掩码 + 仅变化的字段，掩码不变时不写，
+ *    状态寄存器基本不变，典型记录约10-13字节（原始帧16字节+掩码4字节+时间4字节）
+ * 3. 回放：按虚拟时钟将帧重新校验（无效槽位保持上次的值）→ 解码 → AdaptiveScan →
+ *    显示数据 → 事件总线 →（可选）渲染回调的链路，可按倍速或尽快回放
+ * 4. 回放统计吞吐量和扫描间隔偏差，作为无硬件的回归检查
+ *    （test/host/test_raw_record.cpp）
+ * 5. 目标板使用LittleFS，Linux下使用普通文件
+ *
+ * 回放只使用自身的快照，不发布全局数据、不访问OLED，可与实时扫描同时运行
+ */
+
+#ifndef RAW_RECORD_H
+#define RAW_RECORD_H
+
+#include <Arduino.h>
+#include "SW3538.h"
+#include "adaptive_scan.h"
+#include "sw3538_events.h"
+
+struct SW3538Snapshot;
+
+// 录制文件最大字节数，达到后停止录制
+#ifndef RAW_RECORD_MAX_BYTES
+#define RAW_RECORD_MAX_BYTES   (256UL * 1024UL)
+#endif
+
+// 写缓冲区大小（字节）
+#ifndef RAW_RECORD_BUFFER_BYTES
+#define RAW_RECORD_BUFFER_BYTES  256
+#endif
+
+/**
+ * @class RawRecorder
+ * @brief 原始帧录制器
+ */
+class RawRecorder {
+public:
+    RawRecorder();
+
+    /**
+     * @brief 新建录制文件（覆盖同名文件）
+     *
+     * @param path 文件路径
+     * @return false 存储不可用
+     */
+    bool begin(const char* path = "/raw.bin");
+
+    /**
+     * @brief 追加一帧（写入RAM缓冲区，满时自动落盘）
+     *
+     * @param timeMs 采样时的millis()
+     * @param frame 校验前的读数（SW3538::getReadFrame()）
+     * @param readMask 读到的槽位（getReadMask()）
+     * @param validMask 驱动判定有效的槽位（getValidMask()），合成帧取默认值
+     * @return false 未就绪、文件已满或写入失败
+     */
+    bool append(uint32_t timeMs, const SW3538_RawFrame& frame,
+                uint16_t readMask = SW3538_VALID_ALL, uint16_t validMask = SW3538_VALID_ALL);
+
+    /**
+     * @brief 立即将缓冲区写入文件
+     */
+    bool flush();
+
+    uint32_t getFrames() const { return _frames; }
+    uint32_t getBytes() const { return _fileBytes + _bufLen; }
+    bool isFull() const { return _full; }
+
+private:
+    char _path[32];
+    bool _ready;
+    bool _full;
+    bool _first;
+    uint32_t _lastMs;
+    SW3538_RawFrame _prev;
+    uint16_t _prevReadMask;
+    uint16_t _prevValidMask;
+    uint32_t _frames;
+    uint32_t _fileBytes;
+    uint8_t _buf[RAW_RECORD_BUFFER_BYTES];
+    uint16_t _bufLen;
+};
+
+/**
+ * @brief 回放统计
+ */
+struct RawReplayResult {
+    uint32_t frames;           // 回放帧数
+    uint32_t decodeErrors;     // 通信失败帧数
+    uint32_t heldFields;       // 重新校验后无效、保持上次值的字段数
+    uint32_t revalidated;      // 录制时有效、按当前规则无效的帧数
+    uint32_t intervalDiffs;    // AdaptiveScan间隔与录制间隔不一致的次数
+    uint32_t events;           // 事件总线触发的事件数
+    uint32_t spanMs;           // 录制时间跨度
+    uint32_t elapsedUs;        // 回放耗时
+};
+
+/**
+ * @class RawReplay
+ * @brief 原始帧回放引擎
+ *
+ * 自带AdaptiveScan、事件总线和快照实例，不影响实时扫描状态
+ */
+class RawReplay {
+public:
+    /**
+     * @brief 每帧回调，可用于回归检查
+     *
+     * @param timeMs 录制时间
+     * @param data 解码结果
+     * @param ctx 注册时传入的上下文
+     */
+    typedef void (*FrameCallback)(uint32_t timeMs, const SW3538_Data_t& data, void* ctx);
+
+    /**
+     * @brief 渲染回调，参数为回放自身的快照（含显示数据）
+     */
+    typedef void (*RenderCallback)(const SW3538Snapshot& snap, void* ctx);
+
+    RawReplay();
+
+    /**
+     * @brief 设置回放速度
+     *
+     * @param speed 倍速，0表示不等待尽快回放（默认）
+     */
+    void setSpeed(uint16_t speed) { _speed = speed; }
+
+    /**
+     * @brief 设置渲染回调，默认不渲染
+     */
+    void setRenderer(RenderCallback cb, void* ctx = nullptr) { _renderer = cb; _rendererCtx = ctx; }
+
+    void setCallback(FrameCallback cb, void* ctx = nullptr) { _callback = cb; _callbackCtx = ctx; }
+
+    /**
+     * @brief 回放整个文件
+     *
+     * @param path 录制文件路径
+     * @param result 输出统计
+     * @return false 文件不存在或格式错误
+     */
+    bool run(const char* path, RawReplayResult& result);
+
+    /**
+     * @brief 重置扫描器和事件比较状态，逐帧送入前调用
+     */
+    void reset();
+
+    /**
+     * @brief 送入一帧，重新校验后经过与主循环扫描分支相同的处理链路
+     *
+     * @param timeMs 帧时间（虚拟时钟）
+     * @param frame 校验前的读数
+     * @param result 累加统计
+     * @param readMask 读到的槽位
+     * @param validMask 录制时驱动判定有效的槽位
+     * @return 本帧触发的事件类型掩码
+     */
+    uint32_t feed(uint32_t timeMs, const SW3538_RawFrame& frame, RawReplayResult& result,
+                  uint16_t readMask = SW3538_VALID_ALL, uint16_t validMask = SW3538_VALID_ALL);
+
+    AdaptiveScan& getScan() { return _scan; }
+    SW3538EventBus& getEventBus() { return _events; }
+
+    /**
+     * @brief 打印回放统计（帧数、耗时、吞吐量、相对实时倍数）
+     */
+    static void printResult(const RawReplayResult& result, Print& serial);
+
+private:
+    AdaptiveScan _scan;
+    SW3538EventBus _events;
+    SW3538EventState _eventState;
+    SW3538_RawFrame _held;      // 校验后的帧，无效槽位为上次的有效值
+    uint16_t _speed;
+    RenderCallback _renderer;
+    void* _rendererCtx;
+    FrameCallback _callback;
+    void* _callbackCtx;
+    uint32_t _lastMs;
+};
+
+#endif // RAW_RECORD_H
@@ -0,0 +1,167 @@
+/*
+ * report_builder.cpp - 串口采样报告生成实现
+ */
+
+#include "report_builder.h"
+
+// 字段标签：完整模式标签、是否结束一行、变化模式键名
+struct ReportLabel {
+    const char* full;
+    bool endLine;
+    const char* key;
+};
+
+static const ReportLabel LABELS[RF_COUNT] = {
+    { "Version: ",         true,  "ver" },
+    { "MaxPower: ",        true,  "pmax" },
+    { "FastCharger: ",     true,  "fc" },
+    { "Protocol: ",        true,  "proto" },
+    { "PD_Version: ",      true,  "pd" },
+    { "Path1 Link: ",      false, "link1" },
+    { " Path1 Buck:",      true,  "buck1" },
+    { "Path2 Link: ",      false, "link2" },
+    { " Path2 Buck:",      true,  "buck2" },
+    { "Path1 Current: ",   true,  "I1" },
+    { "Path2 Current: ",   true,  "I2" },
+    { "Input Voltage: ",   true,  "Vin" },
+    { "Output Voltage: ",  true,  "Vout" },
+    { "Temperature: ",     true,  "T" },
+};
+
+static const char REPORT_HEADER[] = "--- SW3538 ---\r\n";
+static const char REPORT_FOOTER[] = "--------------\r\n";
+static const char REPORT_CHANGES_PREFIX[] = "[SW3538]";
+
+SW3538Report::SW3538Report()
+    : _mode(REPORT_CHANGES_ONLY ? REPORT_CHANGES : REPORT_FULL), _reports(0), _bytes(0), _formats(0) {
+    reset();
+}
+
+void SW3538Report::reset() {
+    memset(_fields, 0, sizeof(_fields));
+    _valid = false;
+    _fullValid = false;
+    _len = 0;
+    _buf[0] = '\0';
+}
+
+uint32_t SW3538Report::fieldKey(uint8_t field, const SW3538_Data_t& data) {
+    switch (field) {
+        case RF_VERSION:     return data.chipVersion;
+        case RF_MAX_POWER:   return data.maxPowerW;
+        case RF_FAST_CHARGE: return data.fastChargeStatus;
+        case RF_PROTOCOL:    return data.fastChargeProtocol;
+        case RF_PD_VERSION:  return data.pdVersion;
+        case RF_LINK1:       return data.path1Online;
+        case RF_BUCK1:       return data.path1BuckStatus;
+        case RF_LINK2:       return data.path2Online;
+        case RF_BUCK2:       return data.path2BuckStatus;
+        case RF_CURRENT1:    return (uint16_t)data.currentPath1mA;
+        case RF_CURRENT2:    return (uint16_t)data.currentPath2mA;
+        case RF_VIN:         return data.inputVoltagemV;
+        case RF_VOUT:        return data.outputVoltagemV;
+        case RF_TEMP:        return (uint16_t)data.ntcTemperatureC;
+        default:             return 0;
+    }
+}
+
+// 格式化单个字段的数值文本（与printAllData()相同）
+void SW3538Report::format(uint8_t field, const SW3538_Data_t& data) {
+    FieldCache& c = _fields[field];
+    const size_t size = sizeof(c.text);
+    int n = 0;
+
+    switch (field) {
+        case RF_VERSION:     n = snprintf(c.text, size, "%u", data.chipVersion); break;
+        case RF_MAX_POWER:   n = snprintf(c.text, size, "%uW", data.maxPowerW); break;
+        case RF_FAST_CHARGE: n = snprintf(c.text, size, "%s", data.fastChargeStatus ? "ON" : "OFF"); break;
+        case RF_PROTOCOL:    n = snprintf(c.text, size, "%s", SW3538::getProtocolName(data.fastChargeProtocol)); break;
+        case RF_PD_VERSION:
+            n = snprintf(c.text, size, "%s", data.pdVersion == 1 ? "2.0" : (data.pdVersion == 2 ? "3.0" : "RSV"));
+            break;
+        case RF_LINK1:       n = snprintf(c.text, size, "%s", data.path1Online ? "ON" : "OFF"); break;
+        case RF_BUCK1:       n = snprintf(c.text, size, "%s", data.path1BuckStatus ? "ON" : "OFF"); break;
+        case RF_LINK2:       n = snprintf(c.text, size, "%s", data.path2Online ? "ON" : "OFF"); break;
+        case RF_BUCK2:       n = snprintf(c.text, size, "%s", data.path2BuckStatus ? "ON" : "OFF"); break;
+        case RF_CURRENT1:    n = snprintf(c.text, size, "%dmA", data.currentPath1mA); break;
+        case RF_CURRENT2:    n = snprintf(c.text, size, "%dmA", data.currentPath2mA); break;
+        case RF_VIN:         n = snprintf(c.text, size, "%umV", data.inputVoltagemV); break;
+        case RF_VOUT:        n = snprintf(c.text, size, "%umV", data.outputVoltagemV); break;
+        case RF_TEMP:
+            if (data.ntcTemperatureC == -999) {
+                n = snprintf(c.text, size, "N/A");
+            } else {
+                n = snprintf(c.text, size, "%dC", data.ntcTemperatureC);
+            }
+            break;
+    }
+
+    c.len = n < 0 ? 0 : (n >= (int)size ? size - 1 : n);
+    _formats++;
+}
+
+// 比较各字段原始值，只重新格式化变化的字段
+// 返回变化字段的位掩码
+uint16_t SW3538Report::refresh(const SW3538_Data_t& data) {
+    uint16_t changed = 0;
+    for (uint8_t f = 0; f < RF_COUNT; f++) {
+        uint32_t key = fieldKey(f, data);
+        if (_valid && _fields[f].key == key) continue;
+        _fields[f].key = key;
+        format(f, data);
+        changed |= 1 << f;
+    }
+    _valid = true;
+    return changed;
+}
+
+void SW3538Report::append(const char* s, size_t n) {
+    if (_len + n >= sizeof(_buf)) n = sizeof(_buf) - 1 - _len;  // 截断，不越界
+    memcpy(_buf + _len, s, n);
+    _len += n;
+}
+
+size_t SW3538Report::build(const SW3538_Data_t& data, ReportMode mode) {
+    uint16_t changed = refresh(data);
+
+    if (mode == REPORT_FULL) {
+        if (changed == 0 && _fullValid) return _len;  // 无变化，复用上次的报告
+
+        _len = 0;
+        append(REPORT_HEADER, sizeof(REPORT_HEADER) - 1);
+        for (uint8_t f = 0; f < RF_COUNT; f++) {
+            const ReportLabel& l = LABELS[f];
+            append(l.full, strlen(l.full));
+            append(_fields[f].text, _fields[f].len);
+            if (l.endLine) append("\r\n", 2);
+        }
+        append(REPORT_FOOTER, sizeof(REPORT_FOOTER) - 1);
+        _fullValid = true;
+    } else {
+        _len = 0;
+        _fullValid = false;
+        if (changed != 0) {
+            append(REPORT_CHANGES_PREFIX, sizeof(REPORT_CHANGES_PREFIX) - 1);
+            for (uint8_t f = 0; f < RF_COUNT; f++) {
+                if (!(changed & (1 << f))) continue;
+                const ReportLabel& l = LABELS[f];
+                append(" ", 1);
+                append(l.key, strlen(l.key));
+                append("=", 1);
+                append(_fields[f].text, _fields[f].len);
+            }
+            append("\r\n", 2);
+        }
+    }
+
+    _buf[_len] = '\0';
+    return _len;
+}
+
+size_t SW3538Report::write(Print& serial, const SW3538_Data_t& data, ReportMode mode) {
+    size_t n = build(data, mode);
+    _reports++;
+    if (n == 0) return 0;
+    _bytes += n;
+    return serial.write((const uint8_t*)_buf, n);
+}
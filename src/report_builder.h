@@ -0,0 +1,124 @@
+/*
+ * report_builder.h - 串口采样报告生成
+ *
+ * 设计说明：
+ * 1. 报告写入一块预分配缓冲区，每次采样只调用一次Print::write，
+ *    替代printAllData()逐项约40次print（USB CDC每次调用都有固定开销）
+ * 2. 每个字段缓存上次格式化的数值文本和对应的原始值，只有值变化的字段重新格式化；
+ *    全部字段未变化时直接复用上次的缓冲区
+ * 3. 完整模式逐字节等同printAllData()的输出；
+ *    变化模式只输出变化的字段，单行"key=value"，无变化时不输出
+ */
+
+#ifndef REPORT_BUILDER_H
+#define REPORT_BUILDER_H
+
+#include <Arduino.h>
+#include "SW3538.h"
+
+// 报告缓冲区大小（字节），完整报告约300字节
+#ifndef REPORT_BUFFER_BYTES
+#define REPORT_BUFFER_BYTES  384
+#endif
+
+// 默认输出模式：0完整，1只输出变化
+#ifndef REPORT_CHANGES_ONLY
+#define REPORT_CHANGES_ONLY  0
+#endif
+
+enum ReportMode : uint8_t {
+    REPORT_FULL = 0,       // 与printAllData()相同的多行报告
+    REPORT_CHANGES         // 只输出变化的字段
+};
+
+// 报告字段（按输出顺序）
+enum ReportField : uint8_t {
+    RF_VERSION = 0,
+    RF_MAX_POWER,
+    RF_FAST_CHARGE,
+    RF_PROTOCOL,
+    RF_PD_VERSION,
+    RF_LINK1,
+    RF_BUCK1,
+    RF_LINK2,
+    RF_BUCK2,
+    RF_CURRENT1,
+    RF_CURRENT2,
+    RF_VIN,
+    RF_VOUT,
+    RF_TEMP,
+    RF_COUNT
+};
+
+/**
+ * @class SW3538Report
+ * @brief 增量格式化、单次写出的采样报告
+ */
+class SW3538Report {
+public:
+    SW3538Report();
+
+    /**
+     * @brief 清空缓存，下次报告重新格式化全部字段（变化模式下输出全部字段）
+     */
+    void reset();
+
+    /**
+     * @brief 生成报告到内部缓冲区
+     *
+     * @return 报告字节数（变化模式下无变化为0）
+     */
+    size_t build(const SW3538_Data_t& data, ReportMode mode);
+
+    /**
+     * @brief 生成报告并一次写出
+     *
+     * @return 写出的字节数
+     */
+    size_t write(Print& serial, const SW3538_Data_t& data, ReportMode mode);
+
+    /**
+     * @brief 最近一次生成的报告
+     */
+    const char* text() const { return _buf; }
+    size_t length() const { return _len; }
+
+    void setMode(ReportMode mode) { _mode = mode; }
+    ReportMode getMode() const { return _mode; }
+
+    /**
+     * @brief 按当前模式生成并写出
+     */
+    size_t write(Print& serial, const SW3538_Data_t& data) { return write(serial, data, _mode); }
+
+    // ===== 统计 =====
+    uint32_t getReports() const { return _reports; }
+    uint32_t getBytes() const { return _bytes; }
+    uint32_t getFormats() const { return _formats; }    // 重新格式化的字段数
+
+private:
+    struct FieldCache {
+        uint32_t key;          // 字段原始值
+        uint8_t len;
+        char text[12];         // 已格式化的数值文本
+    };
+
+    FieldCache _fields[RF_COUNT];
+    bool _valid;               // 缓存有效
+    bool _fullValid;           // 缓冲区中是否为与缓存一致的完整报告
+    ReportMode _mode;
+    char _buf[REPORT_BUFFER_BYTES];
+    size_t _len;
+
+    uint32_t _reports;
+    uint32_t _bytes;
+    uint32_t _formats;
+
+    uint16_t refresh(const SW3538_Data_t& data);
+    void format(uint8_t field, const SW3538_Data_t& data);
+    void append(const char* s, size_t n);
+
+    static uint32_t fieldKey(uint8_t field, const SW3538_Data_t& data);
+};
+
+#endif // REPORT_BUILDER_H
@@ -0,0 +1,206 @@
+/*
+ * sample_history.cpp - RAM时间序列历史记录实现
+ */
+
+#include "sample_history.h"
+
+static_assert(sizeof(SampleHistory) <= HISTORY_RAM_BUDGET, "SampleHistory exceeds HISTORY_RAM_BUDGET");
+static_assert(HISTORY_RAW_LEN >= 2, "HISTORY_RAW_LEN must be at least 2");
+
+// 回绕安全的时间比较：a是否早于b
+static inline bool timeBefore(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+SampleHistory::SampleHistory() {
+    _rings[0].entries = _tier1;
+    _rings[0].capacity = HISTORY_TIER1_LEN;
+    _rings[0].periodMs = HISTORY_TIER1_PERIOD_MS;
+    _rings[1].entries = _tier2;
+    _rings[1].capacity = HISTORY_TIER2_LEN;
+    _rings[1].periodMs = HISTORY_TIER2_PERIOD_MS;
+    clear();
+}
+
+void SampleHistory::clear() {
+    _rawHead = 0;
+    _rawCount = 0;
+    _rawFirstMs = 0;
+    _rawLastMs = 0;
+    for (uint8_t r = 0; r < 2; r++) {
+        _rings[r].head = 0;
+        _rings[r].count = 0;
+        resetAccum(_rings[r].acc, 0);
+    }
+}
+
+void SampleHistory::pack(const SW3538_Data_t& data, uint16_t values[HISTORY_CH_COUNT]) {
+    values[HISTORY_CH_CURRENT1] = data.currentPath1mA < 0 ? 0 : (uint16_t)data.currentPath1mA;
+    values[HISTORY_CH_CURRENT2] = data.currentPath2mA < 0 ? 0 : (uint16_t)data.currentPath2mA;
+    values[HISTORY_CH_VOUT] = data.outputVoltagemV;
+    values[HISTORY_CH_VIN] = data.inputVoltagemV;
+    values[HISTORY_CH_TEMP] = data.ntcTemperatureC == -999 ? HISTORY_INVALID : (uint16_t)(data.ntcTemperatureC + 273);
+}
+
+void SampleHistory::resetAccum(Accum& acc, uint32_t startMs) {
+    acc.startMs = startMs;
+    acc.count = 0;
+    for (uint8_t c = 0; c < HISTORY_CH_COUNT; c++) {
+        acc.sum[c] = 0;
+        acc.n[c] = 0;
+        acc.minV[c] = HISTORY_INVALID;
+        acc.maxV[c] = 0;
+    }
+}
+
+// 将当前桶写入环形缓冲区
+void SampleHistory::flush(AggRing& ring) {
+    Accum& acc = ring.acc;
+    if (acc.count == 0) return;
+
+    AggEntry& e = ring.entries[ring.head];
+    e.timeMs = acc.startMs;
+    e.count = acc.count;
+    for (uint8_t c = 0; c < HISTORY_CH_COUNT; c++) {
+        if (acc.n[c] == 0) {
+            e.minV[c] = e.maxV[c] = e.meanV[c] = HISTORY_INVALID;
+        } else {
+            e.minV[c] = acc.minV[c];
+            e.maxV[c] = acc.maxV[c];
+            e.meanV[c] = (uint16_t)((acc.sum[c] + acc.n[c] / 2) / acc.n[c]);
+        }
+    }
+
+    ring.head = (ring.head + 1) % ring.capacity;
+    if (ring.count < ring.capacity) ring.count++;
+}
+
+void SampleHistory::accumulate(AggRing& ring, uint32_t timeMs, const uint16_t values[HISTORY_CH_COUNT]) {
+    uint32_t bucketStart = timeMs - timeMs % ring.periodMs;
+    Accum& acc = ring.acc;
+
+    if (acc.count > 0 && bucketStart != acc.startMs) {
+        flush(ring);
+        resetAccum(acc, bucketStart);
+    } else if (acc.count == 0) {
+        acc.startMs = bucketStart;
+    }
+
+    acc.count++;
+    for (uint8_t c = 0; c < HISTORY_CH_COUNT; c++) {
+        uint16_t v = values[c];
+        if (v == HISTORY_INVALID) continue;
+        acc.sum[c] += v;
+        acc.n[c]++;
+        if (v < acc.minV[c]) acc.minV[c] = v;
+        if (v > acc.maxV[c]) acc.maxV[c] = v;
+    }
+}
+
+void SampleHistory::appendRaw(uint32_t timeMs, const SW3538_Data_t& data) {
+    uint32_t dt = timeMs - _rawLastMs;
+    if (_rawCount > 0 && (dt > PACKED_SAMPLE_DT_MAX || timeBefore(timeMs, _rawLastMs))) {
+        _rawHead = 0;   // 时间差无法表示，原始级重新开始（聚合级不受影响）
+        _rawCount = 0;
+    }
+
+    if (_rawCount == 0) {
+        _rawFirstMs = timeMs;
+        dt = 0;
+    } else if (_rawCount == HISTORY_RAW_LEN) {
+        // 覆盖最旧一条（位于_rawHead），起点前移到下一条
+        _rawFirstMs += packedSampleDtMs(_raw[(_rawHead + 1) % HISTORY_RAW_LEN]);
+    }
+
+    packSample(data, dt, _raw[_rawHead]);
+    _rawLastMs = timeMs;
+    _rawHead = (_rawHead + 1) % HISTORY_RAW_LEN;
+    if (_rawCount < HISTORY_RAW_LEN) _rawCount++;
+}
+
+void SampleHistory::append(uint32_t timeMs, const SW3538_Data_t& data) {
+    uint16_t values[HISTORY_CH_COUNT];
+    pack(data, values);
+    appendRaw(timeMs, data);
+    accumulate(_rings[0], timeMs, values);
+    accumulate(_rings[1], timeMs, values);
+}
+
+void SampleHistory::append(uint32_t timeMs, const uint16_t values[HISTORY_CH_COUNT]) {
+    SW3538_Data_t data;
+    memset(&data, 0, sizeof(data));
+    data.currentPath1mA = values[HISTORY_CH_CURRENT1] == HISTORY_INVALID ? 0 : values[HISTORY_CH_CURRENT1];
+    data.currentPath2mA = values[HISTORY_CH_CURRENT2] == HISTORY_INVALID ? 0 : values[HISTORY_CH_CURRENT2];
+    data.outputVoltagemV = values[HISTORY_CH_VOUT] == HISTORY_INVALID ? 0 : values[HISTORY_CH_VOUT];
+    data.inputVoltagemV = values[HISTORY_CH_VIN] == HISTORY_INVALID ? 0 : values[HISTORY_CH_VIN];
+    data.ntcTemperatureC = decodeTemp(values[HISTORY_CH_TEMP]);
+    appendRaw(timeMs, data);
+    accumulate(_rings[0], timeMs, values);
+    accumulate(_rings[1], timeMs, values);
+}
+
+size_t SampleHistory::size(HistoryTier tier) const {
+    switch (tier) {
+        case HISTORY_TIER_RAW:  return _rawCount;
+        case HISTORY_TIER_10S:  return _rings[0].count;
+        case HISTORY_TIER_1MIN: return _rings[1].count;
+        default:                return 0;
+    }
+}
+
+// 在按时间升序的环形缓冲区中查找第一个不早于fromMs的逻辑下标
+template <typename Entry>
+size_t SampleHistory::lowerBound(const Entry* entries, uint16_t capacity, uint16_t head, uint16_t count,
+                                 uint32_t fromMs) {
+    size_t lo = 0, hi = count;
+    size_t first = (head + capacity - count) % capacity;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (timeBefore(entries[(first + mid) % capacity].timeMs, fromMs)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+size_t SampleHistory::query(HistoryTier tier, uint32_t fromMs, uint32_t toMs, HistoryPoint* out, size_t maxOut) const {
+    size_t n = 0;
+
+    if (tier == HISTORY_TIER_RAW) {
+        size_t first = (_rawHead + HISTORY_RAW_LEN - _rawCount) % HISTORY_RAW_LEN;
+        uint32_t t = _rawFirstMs;
+        for (size_t i = 0; i < _rawCount && n < maxOut; i++) {
+            const PackedSample& e = _raw[(first + i) % HISTORY_RAW_LEN];
+            if (i > 0) t += packedSampleDtMs(e);
+            if (timeBefore(t, fromMs)) continue;
+            if (timeBefore(toMs, t)) break;
+
+            SW3538_Data_t data;
+            unpackSample(e, data);
+            HistoryPoint& p = out[n++];
+            p.timeMs = t;
+            p.count = 1;
+            pack(data, p.minV);
+            memcpy(p.maxV, p.minV, sizeof(p.maxV));
+            memcpy(p.meanV, p.minV, sizeof(p.meanV));
+        }
+        return n;
+    }
+
+    if (tier >= HISTORY_TIER_COUNT) return 0;
+    const AggRing& ring = _rings[tier - 1];
+    size_t first = (ring.head + ring.capacity - ring.count) % ring.capacity;
+    for (size_t i = lowerBound(ring.entries, ring.capacity, ring.head, ring.count, fromMs); i < ring.count && n < maxOut; i++) {
+        const AggEntry& e = ring.entries[(first + i) % ring.capacity];
+        if (timeBefore(toMs, e.timeMs)) break;
+        HistoryPoint& p = out[n++];
+        p.timeMs = e.timeMs;
+        p.count = e.count;
+        memcpy(p.minV, e.minV, sizeof(p.minV));
+        memcpy(p.maxV, e.maxV, sizeof(p.maxV));
+        memcpy(p.meanV, e.meanV, sizeof(p.meanV));
+    }
+    return n;
+}
@@ -0,0 +1,186 @@
+/*
+ * sample_history.h - RAM时间序列历史记录
+ *
+ * 设计说明：
+ * 1. 三级固定长度环形缓冲区，全部静态分配：
+ *    - 原始级：最近约80秒的原始采样
+ *    - 10秒级：每10秒一个min/max/mean桶，保留1小时
+ *    - 1分钟级：每分钟一个min/max/mean桶，保留1天
+ * 2. 每个通道打包为16位无符号值，0xFFFF表示无效（不参与统计）
+ * 3. 原始级保存12字节打包采样（packed_sample.h，含状态字，时间为相邻差值），
+ *    间隔超过打包时间差上限（约65秒）时原始级重新开始
+ * 4. 追加为O(1)：各级维护当前桶累加器，跨桶时写入一条记录
+ * 5. 聚合级区间查询按时间二分定位起点，再顺序复制；原始级从最旧一条累加时间差顺序查找
+ */
+
+#ifndef SAMPLE_HISTORY_H
+#define SAMPLE_HISTORY_H
+
+#include <Arduino.h>
+#include "SW3538.h"
+#include "packed_sample.h"
+
+// 各级容量（条目数），可在build_flags中覆盖
+#ifndef HISTORY_RAW_LEN
+#define HISTORY_RAW_LEN      400     // 200ms采样间隔下约80秒
+#endif
+#ifndef HISTORY_TIER1_LEN
+#define HISTORY_TIER1_LEN    360     // 10s × 360 = 1小时
+#endif
+#ifndef HISTORY_TIER2_LEN
+#define HISTORY_TIER2_LEN    1440    // 1min × 1440 = 1天
+#endif
+
+// RAM预算（字节），超出时编译失败
+#ifndef HISTORY_RAM_BUDGET
+#define HISTORY_RAM_BUDGET   (72UL * 1024UL)
+#endif
+
+// 桶周期（ms）
+#define HISTORY_TIER1_PERIOD_MS  10000UL
+#define HISTORY_TIER2_PERIOD_MS  60000UL
+
+// 通道定义
+enum HistoryChannel : uint8_t {
+    HISTORY_CH_CURRENT1 = 0,   // 通路1电流 mA
+    HISTORY_CH_CURRENT2,       // 通路2电流 mA
+    HISTORY_CH_VOUT,           // 输出电压 mV
+    HISTORY_CH_VIN,            // 输入电压 mV
+    HISTORY_CH_TEMP,           // 温度 K（°C + 273）
+    HISTORY_CH_COUNT
+};
+
+// 级别定义
+enum HistoryTier : uint8_t {
+    HISTORY_TIER_RAW = 0,
+    HISTORY_TIER_10S,
+    HISTORY_TIER_1MIN,
+    HISTORY_TIER_COUNT
+};
+
+#define HISTORY_INVALID  0xFFFF
+
+/**
+ * @brief 查询结果条目
+ *
+ * 原始级的min/max/mean相同，count为1
+ */
+struct HistoryPoint {
+    uint32_t timeMs;                    // 采样时间或桶起始时间
+    uint16_t minV[HISTORY_CH_COUNT];
+    uint16_t maxV[HISTORY_CH_COUNT];
+    uint16_t meanV[HISTORY_CH_COUNT];
+    uint16_t count;                     // 桶内采样数
+};
+
+/**
+ * @class SampleHistory
+ * @brief 多分辨率历史记录
+ */
+class SampleHistory {
+public:
+    SampleHistory();
+
+    /**
+     * @brief 清空所有级别
+     */
+    void clear();
+
+    /**
+     * @brief 追加一次采样
+     *
+     * @param timeMs 采样时间（millis()）
+     * @param data SW3538采样数据
+     */
+    void append(uint32_t timeMs, const SW3538_Data_t& data);
+
+    /**
+     * @brief 追加一次已打包的采样
+     *
+     * @note 原始级按打包格式保存，无效的电流/电压通道记为0，状态字为0
+     */
+    void append(uint32_t timeMs, const uint16_t values[HISTORY_CH_COUNT]);
+
+    /**
+     * @brief 区间查询
+     *
+     * @param tier 查询级别
+     * @param fromMs 起始时间（含）
+     * @param toMs 结束时间（含）
+     * @param out 输出缓冲区，按时间升序
+     * @param maxOut 输出缓冲区容量
+     * @return 写入的条目数
+     * @note 聚合级只返回已完成的桶
+     */
+    size_t query(HistoryTier tier, uint32_t fromMs, uint32_t toMs, HistoryPoint* out, size_t maxOut) const;
+
+    /**
+     * @brief 获取某级已保存的条目数
+     */
+    size_t size(HistoryTier tier) const;
+
+    /**
+     * @brief 将采样打包为16位通道值
+     */
+    static void pack(const SW3538_Data_t& data, uint16_t values[HISTORY_CH_COUNT]);
+
+    /**
+     * @brief 温度通道解码（°C），无效返回-999
+     */
+    static int16_t decodeTemp(uint16_t v) { return v == HISTORY_INVALID ? -999 : (int16_t)v - 273; }
+
+    /**
+     * @brief 历史记录占用的RAM（字节）
+     */
+    static constexpr size_t ramBytes() { return sizeof(SampleHistory); }
+
+private:
+    struct AggEntry {
+        uint32_t timeMs;      // 桶起始时间
+        uint16_t minV[HISTORY_CH_COUNT];
+        uint16_t maxV[HISTORY_CH_COUNT];
+        uint16_t meanV[HISTORY_CH_COUNT];
+        uint16_t count;
+    };
+
+    // 当前桶累加器
+    struct Accum {
+        uint32_t startMs;
+        uint32_t sum[HISTORY_CH_COUNT];
+        uint16_t n[HISTORY_CH_COUNT];
+        uint16_t minV[HISTORY_CH_COUNT];
+        uint16_t maxV[HISTORY_CH_COUNT];
+        uint16_t count;
+    };
+
+    // 聚合级环形缓冲区
+    struct AggRing {
+        AggEntry* entries;
+        uint16_t capacity;
+        uint16_t head;        // 下一个写入位置
+        uint16_t count;
+        uint32_t periodMs;
+        Accum acc;
+    };
+
+    PackedSample _raw[HISTORY_RAW_LEN];
+    uint16_t _rawHead;
+    uint16_t _rawCount;
+    uint32_t _rawFirstMs;     // 最旧一条的时间（其时间差字段不再使用）
+    uint32_t _rawLastMs;      // 最新一条的时间
+
+    AggEntry _tier1[HISTORY_TIER1_LEN];
+    AggEntry _tier2[HISTORY_TIER2_LEN];
+    AggRing _rings[2];
+
+    static void resetAccum(Accum& acc, uint32_t startMs);
+    static void accumulate(AggRing& ring, uint32_t timeMs, const uint16_t values[HISTORY_CH_COUNT]);
+    static void flush(AggRing& ring);
+    void appendRaw(uint32_t timeMs, const SW3538_Data_t& data);
+
+    template <typename Entry>
+    static size_t lowerBound(const Entry* entries, uint16_t capacity, uint16_t head, uint16_t count,
+                             uint32_t fromMs);
+};
+
+#endif // SAMPLE_HISTORY_H
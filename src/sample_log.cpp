@@ -0,0 +1,396 @@
+/*
+ * sample_log.cpp - Flash追加式采样日志实现
+ */
+
+#include "sample_log.h"
+#include "packed_sample.h"
+#include "flash_fs.h"
+
+#ifdef ARDUINO
+#include <LittleFS.h>
+#else
+#include <stdio.h>
+#include <sys/stat.h>
+#endif
+
+#define LOG_BLOCK_MAGIC   0x4C53      // "SL"
+#define LOG_INDEX_MAGIC   0x58444953  // "SIDX"
+#define LOG_MAX_ENCODED   24          // 单条采样编码的最大字节数
+
+// ===== 存储后端 =====
+// 每次操作独立打开/关闭文件，写入频率低（按块），无需保持句柄
+
+#ifdef ARDUINO
+
+// 只格式化从未格式化的分区，见flashFsMount()
+static bool storageMount(const char* dir) {
+    if (!flashFsMount()) return false;
+    if (!LittleFS.exists(dir)) LittleFS.mkdir(dir);
+    return true;
+}
+
+static bool storageWrite(const char* path, const void* buf, size_t len, bool append) {
+    File f = LittleFS.open(path, append ? FILE_APPEND : FILE_WRITE);
+    if (!f) return false;
+    size_t n = f.write((const uint8_t*)buf, len);
+    f.close();
+    return n == len;
+}
+
+static size_t storageRead(const char* path, uint32_t offset, void* buf, size_t len) {
+    File f = LittleFS.open(path, FILE_READ);
+    if (!f) return 0;
+    size_t n = 0;
+    if (f.seek(offset)) n = f.read((uint8_t*)buf, len);
+    f.close();
+    return n;
+}
+
+static uint32_t storageSize(const char* path) {
+    File f = LittleFS.open(path, FILE_READ);
+    if (!f) return 0;
+    uint32_t n = f.size();
+    f.close();
+    return n;
+}
+
+static void storageRemove(const char* path) {
+    LittleFS.remove(path);
+}
+
+#else
+
+static bool storageMount(const char* dir) {
+    mkdir(dir, 0755);
+    struct stat st;
+    return stat(dir, &st) == 0;
+}
+
+static bool storageWrite(const char* path, const void* buf, size_t len, bool append) {
+    FILE* f = fopen(path, append ? "ab" : "wb");
+    if (!f) return false;
+    size_t n = fwrite(buf, 1, len, f);
+    fclose(f);
+    return n == len;
+}
+
+static size_t storageRead(const char* path, uint32_t offset, void* buf, size_t len) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return 0;
+    size_t n = 0;
+    if (fseek(f, offset, SEEK_SET) == 0) n = fread(buf, 1, len, f);
+    fclose(f);
+    return n;
+}
+
+static uint32_t storageSize(const char* path) {
+    struct stat st;
+    return stat(path, &st) == 0 ? (uint32_t)st.st_size : 0;
+}
+
+static void storageRemove(const char* path) {
+    remove(path);
+}
+
+#endif
+
+// ===== 变长整数编码 =====
+
+static inline uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+static inline size_t putVarint(uint8_t* out, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+static inline bool getVarint(const uint8_t*& p, const uint8_t* end, uint32_t& v) {
+    v = 0;
+    for (uint8_t shift = 0; shift < 35 && p < end; shift += 7) {
+        uint8_t b = *p++;
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+// ===== SampleLog =====
+
+SampleLog::SampleLog()
+    : _ready(false), _timeOffset(0), _samples(0), _flashWrites(0), _flashBytes(0) {
+    _dir[0] = '\0';
+    memset(&_index, 0, sizeof(_index));
+    resetBlock();
+}
+
+void SampleLog::segmentPath(char* buf, size_t len, uint32_t id) const {
+    snprintf(buf, len, "%s/seg%05lu.bin", _dir, (unsigned long)id);
+}
+
+void SampleLog::indexPath(char* buf, size_t len) const {
+    snprintf(buf, len, "%s/index.bin", _dir);
+}
+
+void SampleLog::resetBlock() {
+    memset(&_block.hdr, 0, sizeof(_block.hdr));
+    _block.hdr.magic = LOG_BLOCK_MAGIC;
+    memset(&_prev, 0, sizeof(_prev));
+}
+
+bool SampleLog::saveIndex() {
+    char path[40];
+    indexPath(path, sizeof(path));
+    size_t len = sizeof(_index) - sizeof(SegmentInfo) * (SAMPLE_LOG_MAX_SEGMENTS - _index.count);
+    if (!storageWrite(path, &_index, len, false)) return false;
+    _flashWrites++;
+    _flashBytes += len;
+    return true;
+}
+
+// 从块头恢复段的实际长度和结束时间（上次掉电前索引可能未更新）
+void SampleLog::recoverSegment(SegmentInfo& seg) {
+    char path[40];
+    segmentPath(path, sizeof(path), seg.id);
+    uint32_t size = storageSize(path);
+    uint32_t offset = 0;
+    BlockHeader hdr;
+
+    while (offset + sizeof(hdr) <= size &&
+           storageRead(path, offset, &hdr, sizeof(hdr)) == sizeof(hdr) &&
+           hdr.magic == LOG_BLOCK_MAGIC &&
+           offset + sizeof(hdr) + hdr.payloadLen <= size) {
+        if (offset == 0) seg.t0 = hdr.t0;
+        seg.t1 = hdr.t1;
+        offset += sizeof(hdr) + hdr.payloadLen;
+    }
+    seg.bytes = offset;
+}
+
+bool SampleLog::begin(const char* dir) {
+    strncpy(_dir, dir, sizeof(_dir) - 1);
+    _dir[sizeof(_dir) - 1] = '\0';
+
+    if (!storageMount(_dir)) {
+        SW3538DefaultLogger::log("Sample log: storage mount failed");
+        return false;
+    }
+
+    char path[40];
+    indexPath(path, sizeof(path));
+    memset(&_index, 0, sizeof(_index));
+    size_t n = storageRead(path, 0, &_index, sizeof(_index));
+    if (n < sizeof(_index) - sizeof(_index.segments) || _index.magic != LOG_INDEX_MAGIC ||
+        _index.count > SAMPLE_LOG_MAX_SEGMENTS) {
+        memset(&_index, 0, sizeof(_index));
+        _index.magic = LOG_INDEX_MAGIC;
+    }
+
+    if (_index.count == 0) {
+        _ready = true;
+        return rotateSegment();
+    }
+
+    // 索引只在滚动时保存，各段从块头恢复；当前段可能为空（已滚动但未落盘），
+    // 日志时间从所有非空段的最晚时间接续，不能只看最后一段
+    uint32_t lastMs = 0;
+    for (uint16_t i = 0; i < _index.count; i++) {
+        SegmentInfo& seg = _index.segments[i];
+        recoverSegment(seg);
+        if (seg.bytes > 0 && seg.t1 > lastMs) lastMs = seg.t1;
+    }
+    _timeOffset = lastMs + 1;
+    resetBlock();
+    _ready = true;
+
+    SW3538DefaultLogger::logVal("Sample log segments: ", _index.count);
+    return true;
+}
+
+bool SampleLog::rotateSegment() {
+    if (_index.count >= SAMPLE_LOG_MAX_SEGMENTS) {
+        char path[40];
+        segmentPath(path, sizeof(path), _index.segments[0].id);
+        storageRemove(path);
+        memmove(&_index.segments[0], &_index.segments[1], sizeof(SegmentInfo) * (SAMPLE_LOG_MAX_SEGMENTS - 1));
+        _index.count--;
+    }
+
+    SegmentInfo& seg = _index.segments[_index.count++];
+    seg.id = _index.nextId++;
+    seg.t0 = 0;
+    seg.t1 = 0;
+    seg.bytes = 0;
+    return saveIndex();
+}
+
+void SampleLog::toLogSample(const SW3538_Data_t& data, uint32_t timeMs, LogSample& out) {
+    out.timeMs = timeMs;
+    out.currentPath1mA = data.currentPath1mA;
+    out.currentPath2mA = data.currentPath2mA;
+    out.outputVoltagemV = data.outputVoltagemV;
+    out.inputVoltagemV = data.inputVoltagemV;
+    out.ntcTemperatureC = data.ntcTemperatureC;
+    out.state = packSampleState(data);
+}
+
+size_t SampleLog::encode(const LogSample& prev, const LogSample& cur, uint8_t* out) {
+    size_t n = putVarint(out, cur.timeMs - prev.timeMs);
+    n += putVarint(out + n, zigzag((int32_t)cur.currentPath1mA - prev.currentPath1mA));
+    n += putVarint(out + n, zigzag((int32_t)cur.currentPath2mA - prev.currentPath2mA));
+    n += putVarint(out + n, zigzag((int32_t)cur.outputVoltagemV - prev.outputVoltagemV));
+    n += putVarint(out + n, zigzag((int32_t)cur.inputVoltagemV - prev.inputVoltagemV));
+    n += putVarint(out + n, zigzag((int32_t)cur.ntcTemperatureC - prev.ntcTemperatureC));
+    n += putVarint(out + n, zigzag((int32_t)cur.state - prev.state));
+    return n;
+}
+
+bool SampleLog::append(const SW3538_Data_t& data, uint32_t uptimeMs) {
+    if (!_ready) return false;
+
+    if (_block.hdr.payloadLen + LOG_MAX_ENCODED > SAMPLE_LOG_BLOCK_BYTES) {
+        if (!flush()) return false;
+    }
+
+    LogSample cur;
+    toLogSample(data, toLogTime(uptimeMs), cur);
+
+    // 块内首条以t0为基准，其余字段相对全零
+    if (_block.hdr.count == 0) {
+        _block.hdr.t0 = cur.timeMs;
+        _prev.timeMs = cur.timeMs;
+    }
+
+    _block.hdr.payloadLen += encode(_prev, cur, _block.payload + _block.hdr.payloadLen);
+    _block.hdr.count++;
+    _block.hdr.t1 = cur.timeMs;
+    _prev = cur;
+    _samples++;
+    return true;
+}
+
+bool SampleLog::flush() {
+    if (!_ready) return false;
+    if (_block.hdr.count == 0) return true;
+
+    SegmentInfo* seg = &_index.segments[_index.count - 1];
+    uint32_t blockLen = sizeof(BlockHeader) + _block.hdr.payloadLen;
+    if (seg->bytes > 0 && seg->bytes + blockLen > SAMPLE_LOG_SEGMENT_BYTES) {
+        if (!rotateSegment()) return false;
+        seg = &_index.segments[_index.count - 1];
+    }
+
+    char path[40];
+    segmentPath(path, sizeof(path), seg->id);
+    if (!storageWrite(path, &_block, blockLen, true)) {
+        SW3538DefaultLogger::log("Sample log: write failed");
+        return false;
+    }
+    _flashWrites++;
+    _flashBytes += blockLen;
+
+    if (seg->bytes == 0) seg->t0 = _block.hdr.t0;
+    seg->t1 = _block.hdr.t1;
+    seg->bytes += blockLen;
+
+    resetBlock();
+    return true;
+}
+
+size_t SampleLog::decodeBlock(const BlockHeader& hdr, const uint8_t* payload, uint32_t fromMs, uint32_t toMs,
+                              ScanCallback cb, void* ctx) {
+    const uint8_t* p = payload;
+    const uint8_t* end = payload + hdr.payloadLen;
+    LogSample s;
+    memset(&s, 0, sizeof(s));
+    s.timeMs = hdr.t0;
+    size_t emitted = 0;
+
+    for (uint16_t i = 0; i < hdr.count; i++) {
+        uint32_t v[7];
+        for (uint8_t k = 0; k < 7; k++) {
+            if (!getVarint(p, end, v[k])) return emitted;
+        }
+        s.timeMs += v[0];
+        s.currentPath1mA += unzigzag(v[1]);
+        s.currentPath2mA += unzigzag(v[2]);
+        s.outputVoltagemV += unzigzag(v[3]);
+        s.inputVoltagemV += unzigzag(v[4]);
+        s.ntcTemperatureC += unzigzag(v[5]);
+        s.state += unzigzag(v[6]);
+
+        if (s.timeMs < fromMs) continue;
+        if (s.timeMs > toMs) break;
+        cb(s, ctx);
+        emitted++;
+    }
+    return emitted;
+}
+
+size_t SampleLog::scan(uint32_t fromMs, uint32_t toMs, ScanCallback cb, void* ctx) {
+    if (!_ready || cb == nullptr) return 0;
+
+    size_t emitted = 0;
+    uint8_t payload[SAMPLE_LOG_BLOCK_BYTES];
+
+    for (uint16_t i = 0; i < _index.count; i++) {
+        const SegmentInfo& seg = _index.segments[i];
+        if (seg.bytes == 0 || seg.t1 < fromMs || seg.t0 > toMs) continue;
+
+        char path[40];
+        segmentPath(path, sizeof(path), seg.id);
+        uint32_t offset = 0;
+        BlockHeader hdr;
+        while (offset + sizeof(hdr) <= seg.bytes &&
+               storageRead(path, offset, &hdr, sizeof(hdr)) == sizeof(hdr) &&
+               hdr.magic == LOG_BLOCK_MAGIC && hdr.payloadLen <= sizeof(payload)) {
+            uint32_t payloadOffset = offset + sizeof(hdr);
+            offset = payloadOffset + hdr.payloadLen;
+
+            // 按块头跳过区间外的块
+            if (hdr.t1 < fromMs) continue;
+            if (hdr.t0 > toMs) break;
+
+            if (storageRead(path, payloadOffset, payload, hdr.payloadLen) != hdr.payloadLen) break;
+            emitted += decodeBlock(hdr, payload, fromMs, toMs, cb, ctx);
+        }
+    }
+
+    // 尚未落盘的块
+    if (_block.hdr.count > 0 && _block.hdr.t1 >= fromMs && _block.hdr.t0 <= toMs) {
+        emitted += decodeBlock(_block.hdr, _block.payload, fromMs, toMs, cb, ctx);
+    }
+    return emitted;
+}
+
+float SampleLog::bytesPerSample() const {
+    return _samples ? (float)_flashBytes / _samples : 0.0f;
+}
+
+float SampleLog::compressionRatio() const {
+    return _samples ? (float)_flashBytes / ((float)_samples * sizeof(SW3538_Data_t)) : 0.0f;
+}
+
+void SampleLog::printStats(Print& serial) const {
+    char buf[64];
+    serial.println("--- Sample Log ---");
+    snprintf(buf, sizeof(buf), "Samples: %lu  Segments: %u",
+             (unsigned long)_samples, _index.count);
+    serial.println(buf);
+    snprintf(buf, sizeof(buf), "Flash writes: %lu  bytes: %lu",
+             (unsigned long)_flashWrites, (unsigned long)_flashBytes);
+    serial.println(buf);
+    snprintf(buf, sizeof(buf), "Bytes/sample: %.2f  Ratio: %.3f",
+             bytesPerSample(), compressionRatio());
+    serial.println(buf);
+    serial.println("------------------");
+}
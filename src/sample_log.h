@@ -0,0 +1,170 @@
+/*
+ * sample_log.h - Flash追加式采样日志
+ *
+ * 设计说明：
+ * 1. 采样在RAM中增量差分编码（zigzag变长整数），块缓冲区满后一次写入，
+ *    避免逐条写Flash造成的延迟和磨损
+ * 2. 日志按段（文件）滚动，超过段数上限时删除最旧段
+ * 3. 段索引记录每段的起止时间，区间扫描跳过无关段；
+ *    段内每块有头部（起止时间、长度），跳过无关块无需解码
+ * 4. 目标板使用LittleFS，Linux下使用普通文件
+ * 5. 无RTC，日志时间 = 上次日志末尾时间 + 本次上电millis()，跨重启单调递增
+ *
+ * 掉电时最多丢失一个未写入的块
+ */
+
+#ifndef SAMPLE_LOG_H
+#define SAMPLE_LOG_H
+
+#include <Arduino.h>
+#include "SW3538.h"
+
+// 块缓冲区大小（字节），越大块头开销和写入次数越少
+#ifndef SAMPLE_LOG_BLOCK_BYTES
+#define SAMPLE_LOG_BLOCK_BYTES    1024
+#endif
+
+// 单段最大字节数
+#ifndef SAMPLE_LOG_SEGMENT_BYTES
+#define SAMPLE_LOG_SEGMENT_BYTES  (32UL * 1024UL)
+#endif
+
+// 最多保留的段数
+#ifndef SAMPLE_LOG_MAX_SEGMENTS
+#define SAMPLE_LOG_MAX_SEGMENTS   8
+#endif
+
+/**
+ * @brief 日志采样记录（解码后）
+ */
+struct LogSample {
+    uint32_t timeMs;          // 日志时间，跨重启单调
+    int16_t currentPath1mA;
+    int16_t currentPath2mA;
+    uint16_t outputVoltagemV;
+    uint16_t inputVoltagemV;
+    int16_t ntcTemperatureC;
+    uint16_t state;           // 同packSampleState()：bit0-4 快充/通路1/通路2/Buck1/Buck2, bit5-8 协议, bit9-10 PD版本
+};
+
+/**
+ * @class SampleLog
+ * @brief 批量写入的持久化采样日志
+ */
+class SampleLog {
+public:
+    typedef void (*ScanCallback)(const LogSample& sample, void* ctx);
+
+    SampleLog();
+
+    /**
+     * @brief 挂载存储并恢复索引
+     *
+     * @param dir 日志目录
+     * @return false 存储不可用（只格式化从未格式化的分区，见flashFsMount()）
+     */
+    bool begin(const char* dir = "/log");
+
+    /**
+     * @brief 追加一次采样（仅写入RAM块缓冲区，满时自动落盘）
+     *
+     * @param data 采样数据
+     * @param uptimeMs 采样时的millis()
+     */
+    bool append(const SW3538_Data_t& data, uint32_t uptimeMs);
+
+    /**
+     * @brief 立即将块缓冲区写入Flash
+     */
+    bool flush();
+
+    /**
+     * @brief 扫描时间区间内的采样
+     *
+     * @param fromMs 起始日志时间（含）
+     * @param toMs 结束日志时间（含）
+     * @return 回调的采样数
+     * @note 包含尚未落盘的块缓冲区
+     */
+    size_t scan(uint32_t fromMs, uint32_t toMs, ScanCallback cb, void* ctx);
+
+    /**
+     * @brief 将millis()换算为日志时间
+     */
+    uint32_t toLogTime(uint32_t uptimeMs) const { return _timeOffset + uptimeMs; }
+
+    // ===== 统计 =====
+    uint32_t getSamples() const { return _samples; }
+    uint32_t getFlashWrites() const { return _flashWrites; }
+    uint32_t getFlashBytes() const { return _flashBytes; }
+
+    /**
+     * @brief 每条采样平均占用的Flash字节数（含块头和索引）
+     */
+    float bytesPerSample() const;
+
+    /**
+     * @brief 压缩比：Flash写入字节数（含块头和索引） / 未压缩采样字节数（sizeof(SW3538_Data_t)）
+     */
+    float compressionRatio() const;
+
+    void printStats(Print& serial) const;
+
+private:
+    struct BlockHeader {
+        uint16_t magic;
+        uint16_t count;
+        uint16_t payloadLen;
+        uint16_t reserved;
+        uint32_t t0;
+        uint32_t t1;
+    };
+
+    struct SegmentInfo {
+        uint32_t id;
+        uint32_t t0;
+        uint32_t t1;
+        uint32_t bytes;
+    };
+
+    struct IndexFile {
+        uint32_t magic;
+        uint32_t nextId;
+        uint16_t count;
+        uint16_t reserved;
+        SegmentInfo segments[SAMPLE_LOG_MAX_SEGMENTS];
+    };
+
+    char _dir[24];
+    bool _ready;
+    IndexFile _index;
+    uint32_t _timeOffset;
+
+    // 当前块：块头与负载连续存放，落盘时一次写入
+    struct Block {
+        BlockHeader hdr;
+        uint8_t payload[SAMPLE_LOG_BLOCK_BYTES];
+    };
+
+    Block _block;
+    LogSample _prev;
+
+    // 统计
+    uint32_t _samples;
+    uint32_t _flashWrites;
+    uint32_t _flashBytes;
+
+    void segmentPath(char* buf, size_t len, uint32_t id) const;
+    void indexPath(char* buf, size_t len) const;
+    bool saveIndex();
+    bool rotateSegment();
+    void recoverSegment(SegmentInfo& seg);
+    void resetBlock();
+
+    static void toLogSample(const SW3538_Data_t& data, uint32_t timeMs, LogSample& out);
+    static size_t encode(const LogSample& prev, const LogSample& cur, uint8_t* out);
+    static size_t decodeBlock(const BlockHeader& hdr, const uint8_t* payload, uint32_t fromMs, uint32_t toMs,
+                              ScanCallback cb, void* ctx);
+};
+
+#endif // SAMPLE_LOG_H
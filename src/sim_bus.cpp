@@ -0,0 +1,118 @@
+/*
+ * sim_bus.cpp - 模拟SW3538的I2C总线实现
+ */
+
+#include "sim_bus.h"
+#include "SW3538_impl.h"
+
+SW3538SimBus::SW3538SimBus(uint8_t address)
+    : _address(address), _noiseQ8(0), _rng(1), _nackPermille(0), _glitchPermille(0), _glitchTargets(SIM_GLITCH_ALL), _failedRead(0xFFFF),
+      _txAddress(0), _txLen(0), _regPtr(0), _rxLeft(0), _latchedAdc(0),
+      _bits(0), _transactions(0), _conversions(0), _faults(0) {
+    memset(_regs, 0, sizeof(_regs));
+    memset(_truthQ8, 0, sizeof(_truthQ8));
+}
+
+void SW3538SimBus::setFrame(const SW3538_RawFrame& frame, uint8_t fracQ8) {
+    for (uint8_t i = 0; i < SW3538_FIELD_COUNT; i++) {
+        const SW3538_FieldDesc& f = SW3538_FIELDS[i];
+        if (f.adcChannel == SW3538_ADC_CH_NONE) {
+            _regs[SW3538_REG_OFFSET(f.reg)] = (uint8_t)sw3538RawGet(frame, f.source);
+        } else {
+            uint8_t slot = f.source - SW3538_SRC_ADC_FIRST;
+            _truthQ8[slot] = ((uint32_t)sw3538RawGet(frame, f.source) << 8) + fracQ8;
+        }
+    }
+}
+
+uint32_t SW3538SimBus::nextRandom() {
+    // xorshift32
+    _rng ^= _rng << 13;
+    _rng ^= _rng >> 17;
+    _rng ^= _rng << 5;
+    return _rng;
+}
+
+bool SW3538SimBus::inject(uint16_t permille) {
+    if (permille == 0 || nextRandom() % 1000 >= permille) return false;
+    _faults++;
+    return true;
+}
+
+// 一次转换：按当前选通通道取真值加噪声
+uint16_t SW3538SimBus::convert() {
+    uint8_t idx = sw3538AdcFieldIndex<SW3538Fields>(_regs[SW3538_REG_ADC_CONFIG]);
+    if (idx >= SW3538_FIELD_COUNT) return 0;
+    const SW3538_FieldDesc& f = SW3538_FIELDS[idx];
+    _conversions++;
+
+    // 12个[0,1)均匀分布之和减6，近似标准正态，Q16
+    int32_t g = 0;
+    for (uint8_t i = 0; i < 12; i++) g += nextRandom() & 0xFFFF;
+    g -= 6L * 65536L;
+
+    int64_t q8 = (int64_t)_truthQ8[f.source - SW3538_SRC_ADC_FIRST] + (((int64_t)g * _noiseQ8) >> 16);
+    int32_t lsb = (int32_t)((q8 + 128) >> 8);
+    int32_t maxV = (1L << f.width) - 1;
+    if (lsb < 0) lsb = 0;
+    if (lsb > maxV) lsb = maxV;
+    return (uint16_t)lsb;
+}
+
+void SW3538SimBus::beginTransmission(uint8_t address) {
+    _txAddress = address;
+    _txLen = 0;
+    _bits += 1 + 9;     // 起始位 + 地址字节
+    _transactions++;
+}
+
+size_t SW3538SimBus::write(uint8_t value) {
+    _bits += 9;
+    if (_txLen < sizeof(_txBuf)) _txBuf[_txLen] = value;
+    _txLen++;
+    return 1;
+}
+
+uint8_t SW3538SimBus::endTransmission(bool sendStop) {
+    if (sendStop) _bits += 1;
+    if (_txAddress != _address || inject(_nackPermille)) return 2;   // 地址无应答
+
+    if (_txLen >= 1) _regPtr = _txBuf[0];
+    if (_txLen >= 2) _regs[_regPtr] = _txBuf[1];
+    return 0;
+}
+
+uint8_t SW3538SimBus::requestFrom(uint8_t address, uint8_t quantity) {
+    _bits += 1 + 9 + 9UL * quantity + 1;   // 重复起始 + 地址 + 数据 + 停止
+    _transactions++;
+    if (address != _address || _regPtr == _failedRead || inject(_nackPermille)) {
+        _rxLeft = 0;
+        return 0;
+    }
+    _rxLeft = quantity;
+    return quantity;
+}
+
+int SW3538SimBus::read() {
+    if (_rxLeft == 0) return -1;
+    _rxLeft--;
+
+    uint8_t reg = _regPtr++;
+    int value;
+    uint8_t target;
+    if (reg == SW3538_REG_ADC_DATA_LOW) {
+        _latchedAdc = convert();    // 读低字节启动一次新转换
+        value = _latchedAdc & 0xFF;
+        target = SIM_GLITCH_ADC_LOW;
+    } else if (reg == SW3538_REG_ADC_DATA_HIGH) {
+        value = _latchedAdc >> 8;
+        target = SIM_GLITCH_ADC_HIGH;
+    } else {
+        value = _regs[reg];
+        target = SIM_GLITCH_REG;
+    }
+    return (_glitchTargets & target) && inject(_glitchPermille) ? 0xFF : value;
+}
+
+// 模拟总线驱动只在此实例化，固件驱动（SW3538.cpp）不依赖模拟总线
+template class SW3538T<SW3538SimBus, SW3538NullLogger, SW3538NoRetry, SW3538Variant>;
@@ -0,0 +1,138 @@
+/*
+ * sim_bus.h - 模拟SW3538的I2C总线
+ *
+ * 设计说明：
+ * 1. 提供驱动Bus策略所需的TwoWire接口，寄存器内容取自一帧原始帧，
+ *    驱动写入的寄存器（解锁、ADC使能、通道选择）照常保存
+ * 2. ADC真值带1/256 LSB的小数部分；每次读ADC低字节视为一次新转换，
+ *    结果 = 真值 + 高斯噪声（12个均匀分布之和近似），四舍五入到LSB
+ * 3. 按标准模式时序统计总线位数：起始/停止各1位，每字节9位（含应答），
+ *    由此换算任意时钟频率下的总线占用时间
+ * 4. 故障注入：每次事务按千分比随机地址无应答（或指定寄存器的读取总是无应答），或每个数据字节按千分比读到0xFF
+ *    （SDA受干扰/被拉高），毛刺可限定在寄存器、ADC低字节或ADC高字节，用于验证驱动的读取校验
+ *
+ * 用于基准测试和无硬件的驱动验证，不访问真实总线
+ */
+
+#ifndef SIM_BUS_H
+#define SIM_BUS_H
+
+#include <Arduino.h>
+#include "SW3538.h"
+
+// 毛刺注入目标（可组合）
+#define SIM_GLITCH_REG        0x01    // 普通寄存器字节
+#define SIM_GLITCH_ADC_LOW    0x02    // ADC数据低字节
+#define SIM_GLITCH_ADC_HIGH   0x04    // ADC数据高字节
+#define SIM_GLITCH_ALL        0x07
+
+/**
+ * @class SW3538SimBus
+ * @brief 模拟SW3538的总线
+ */
+class SW3538SimBus {
+public:
+    SW3538SimBus(uint8_t address = SW3538_DEFAULT_ADDRESS);
+
+    /**
+     * @brief 用原始帧设置寄存器和ADC真值
+     *
+     * @param frame 寄存器和ADC原始值
+     * @param fracQ8 各ADC真值附加的小数部分，单位1/256 LSB
+     */
+    void setFrame(const SW3538_RawFrame& frame, uint8_t fracQ8 = 0);
+
+    /**
+     * @brief 模拟芯片的I2C地址
+     */
+    uint8_t getAddress() const { return _address; }
+
+    /**
+     * @brief 设置单次转换噪声标准差，单位1/256 LSB
+     */
+    void setNoise(uint16_t sigmaQ8) { _noiseQ8 = sigmaQ8; }
+
+    /**
+     * @brief ADC通道真值，单位1/256 LSB
+     */
+    uint32_t getAdcTruth(uint8_t slot) const { return _truthQ8[slot]; }
+
+    /**
+     * @brief 设置故障率
+     *
+     * @param nackPermille 每次事务地址无应答的千分比
+     * @param glitchPermille 每个读出字节变为0xFF的千分比
+     */
+    void setFaults(uint16_t nackPermille, uint16_t glitchPermille) { _nackPermille = nackPermille; _glitchPermille = glitchPermille; }
+
+    /**
+     * @brief 限定毛刺注入的字节类型（SIM_GLITCH_*），默认全部
+     */
+    void setGlitchTargets(uint8_t mask) { _glitchTargets = mask; }
+
+    /**
+     * @brief 指定寄存器的读取总是无应答（用于验证读改写在读失败时不写入），0xFFFF取消
+     */
+    void setFailedRead(uint16_t reg) { _failedRead = reg; }
+
+    /**
+     * @brief 寄存器当前内容（含驱动写入的值）
+     */
+    uint8_t getRegister(uint8_t reg) const { return _regs[reg]; }
+    void setRegister(uint8_t reg, uint8_t value) { _regs[reg] = value; }
+    uint32_t getInjectedFaults() const { return _faults; }
+
+    // ===== 统计 =====
+    void resetStats() { _bits = 0; _transactions = 0; _conversions = 0; _faults = 0; }
+    uint32_t getBits() const { return _bits; }
+    uint32_t getTransactions() const { return _transactions; }
+    uint32_t getConversions() const { return _conversions; }
+
+    /**
+     * @brief 指定时钟下的总线占用时间（us）
+     */
+    uint32_t busTimeUs(uint32_t clockHz) const { return (uint32_t)((uint64_t)_bits * 1000000UL / clockHz); }
+
+    // ===== TwoWire接口 =====
+    bool begin() { return true; }
+    bool begin(int, int) { return true; }
+    bool setClock(uint32_t) { return true; }
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t value);
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity);
+    int read();
+
+private:
+    uint8_t _address;
+    uint8_t _regs[256];
+    uint32_t _truthQ8[SW3538_RAW_ADC_COUNT];
+    uint16_t _noiseQ8;
+    uint32_t _rng;
+    uint16_t _nackPermille;
+    uint16_t _glitchPermille;
+    uint8_t _glitchTargets;
+    uint16_t _failedRead;
+
+    // 当前事务
+    uint8_t _txAddress;
+    uint8_t _txLen;
+    uint8_t _txBuf[2];
+    uint8_t _regPtr;
+    uint8_t _rxLeft;
+    uint16_t _latchedAdc;     // 最近一次转换结果，读高字节时返回
+
+    uint32_t _bits;
+    uint32_t _transactions;
+    uint32_t _conversions;
+    uint32_t _faults;
+
+    uint16_t convert();
+    bool inject(uint16_t permille);
+    uint32_t nextRandom();
+};
+
+typedef SW3538T<SW3538SimBus, SW3538NullLogger, SW3538NoRetry, SW3538Variant> SW3538Sim;
+extern template class SW3538T<SW3538SimBus, SW3538NullLogger, SW3538NoRetry, SW3538Variant>;
+
+#endif // SIM_BUS_H
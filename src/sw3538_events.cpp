@@ -0,0 +1,121 @@
+/*
+ * sw3538_events.cpp - 采样变化事件总线实现
+ */
+
+#include "sw3538_events.h"
+
+SW3538EventBus::SW3538EventBus()
+    : _subCount(0), _overTempC(80), _tempHystC(5), _currentMA(3000), _currentHystMA(20) {
+    resetState(_state);
+}
+
+void SW3538EventBus::resetState(SW3538EventState& state) {
+    memset(&state, 0, sizeof(state));
+    state.last.fastChargeProtocol = SW3538_FC_NONE;
+    state.last.ntcTemperatureC = -999;
+}
+
+bool SW3538EventBus::subscribe(uint32_t mask, SW3538_EventCallback cb, void* ctx) {
+    if (cb == nullptr || _subCount >= SW3538_EVENT_MAX_SUBSCRIBERS) return false;
+    _subs[_subCount].mask = mask;
+    _subs[_subCount].cb = cb;
+    _subs[_subCount].ctx = ctx;
+    _subCount++;
+    return true;
+}
+
+bool SW3538EventBus::unsubscribe(SW3538_EventCallback cb, void* ctx) {
+    for (uint8_t i = 0; i < _subCount; i++) {
+        if (_subs[i].cb == cb && _subs[i].ctx == ctx) {
+            _subs[i] = _subs[--_subCount];
+            return true;
+        }
+    }
+    return false;
+}
+
+void SW3538EventBus::setOverTempThreshold(int16_t tempC, int16_t hysteresisC) {
+    _overTempC = tempC;
+    _tempHystC = hysteresisC;
+}
+
+void SW3538EventBus::setCurrentThreshold(int16_t mA, int16_t hysteresisMA) {
+    _currentMA = mA;
+    _currentHystMA = hysteresisMA;
+}
+
+void SW3538EventBus::emit(SW3538_Event& evt, SW3538_EventType type, int32_t oldValue, int32_t newValue, uint32_t& fired) {
+    uint32_t bit = SW3538_EVT_MASK(type);
+    fired |= bit;
+
+    evt.type = type;
+    evt.oldValue = oldValue;
+    evt.newValue = newValue;
+    for (uint8_t i = 0; i < _subCount; i++) {
+        if (_subs[i].mask & bit) {
+            _subs[i].cb(evt, _subs[i].ctx);
+        }
+    }
+}
+
+uint32_t SW3538EventBus::process(const SW3538_Data_t& sample, SW3538EventState& state, uint8_t source) {
+    const SW3538_Data_t& last = state.last;
+    uint32_t fired = 0;
+
+    SW3538_Event evt;
+    evt.source = source;
+    evt.timeMs = millis();
+    evt.sample = &sample;
+
+    // 通路相关事件
+    const bool online[2] = { sample.path1Online, sample.path2Online };
+    const bool lastOnline[2] = { last.path1Online, last.path2Online };
+    const bool buck[2] = { sample.path1BuckStatus, sample.path2BuckStatus };
+    const bool lastBuck[2] = { last.path1BuckStatus, last.path2BuckStatus };
+    const int16_t current[2] = { sample.currentPath1mA, sample.currentPath2mA };
+    const int16_t lastCurrent[2] = { last.currentPath1mA, last.currentPath2mA };
+
+    for (uint8_t p = 0; p < 2; p++) {
+        evt.path = p + 1;
+        if (online[p] != lastOnline[p]) {
+            emit(evt, online[p] ? SW3538_EVT_PATH_ONLINE : SW3538_EVT_PATH_OFFLINE, lastOnline[p], online[p], fired);
+        }
+        if (buck[p] != lastBuck[p]) {
+            emit(evt, buck[p] ? SW3538_EVT_BUCK_ON : SW3538_EVT_BUCK_OFF, lastBuck[p], buck[p], fired);
+        }
+        if (!state.currentAbove[p] && current[p] >= _currentMA) {
+            state.currentAbove[p] = true;
+            emit(evt, SW3538_EVT_CURRENT_ABOVE, lastCurrent[p], current[p], fired);
+        } else if (state.currentAbove[p] && current[p] < _currentMA - _currentHystMA) {
+            state.currentAbove[p] = false;
+            emit(evt, SW3538_EVT_CURRENT_BELOW, lastCurrent[p], current[p], fired);
+        }
+    }
+
+    // 芯片级事件
+    evt.path = 0;
+    if (sample.fastChargeStatus != last.fastChargeStatus) {
+        emit(evt, sample.fastChargeStatus ? SW3538_EVT_FAST_CHARGE_ON : SW3538_EVT_FAST_CHARGE_OFF,
+             last.fastChargeStatus, sample.fastChargeStatus, fired);
+    }
+    if (sample.fastChargeProtocol != last.fastChargeProtocol) {
+        emit(evt, SW3538_EVT_PROTOCOL_CHANGE, last.fastChargeProtocol, sample.fastChargeProtocol, fired);
+    }
+    if (sample.pdVersion != last.pdVersion) {
+        emit(evt, SW3538_EVT_PD_VERSION_CHANGE, last.pdVersion, sample.pdVersion, fired);
+    }
+
+    // 温度无效(-999)时保持锁存状态不变
+    if (sample.ntcTemperatureC != -999) {
+        if (!state.overTemp && sample.ntcTemperatureC >= _overTempC) {
+            state.overTemp = true;
+            emit(evt, SW3538_EVT_OVER_TEMP, last.ntcTemperatureC, sample.ntcTemperatureC, fired);
+        } else if (state.overTemp && sample.ntcTemperatureC < _overTempC - _tempHystC) {
+            state.overTemp = false;
+            emit(evt, SW3538_EVT_TEMP_NORMAL, last.ntcTemperatureC, sample.ntcTemperatureC, fired);
+        }
+    }
+
+    state.last = sample;
+    return fired;
+}
@@ -0,0 +1,155 @@
+/*
+ * sw3538_events.h - 采样变化事件总线
+ *
+ * 设计说明：
+ * 1. 相邻两次采样只比较一次，生成类型化事件
+ * 2. 固定容量订阅表，按事件掩码分发，无动态内存分配
+ * 3. 比较状态（上次采样、阈值锁存）与订阅表分离，
+ *    多芯片场景下每个设备只需保存一份SW3538EventState
+ */
+
+#ifndef SW3538_EVENTS_H
+#define SW3538_EVENTS_H
+
+#include <Arduino.h>
+#include "SW3538.h"
+
+// 最大订阅者数量
+#ifndef SW3538_EVENT_MAX_SUBSCRIBERS
+#define SW3538_EVENT_MAX_SUBSCRIBERS 8
+#endif
+
+// 事件类型
+enum SW3538_EventType : uint8_t {
+    SW3538_EVT_PATH_ONLINE = 0,      // 通路接入设备
+    SW3538_EVT_PATH_OFFLINE,         // 通路设备拔出
+    SW3538_EVT_BUCK_ON,              // 通路Buck开启
+    SW3538_EVT_BUCK_OFF,             // 通路Buck关闭
+    SW3538_EVT_FAST_CHARGE_ON,       // 快充建立
+    SW3538_EVT_FAST_CHARGE_OFF,      // 快充退出
+    SW3538_EVT_PROTOCOL_CHANGE,      // 快充协议变化
+    SW3538_EVT_PD_VERSION_CHANGE,    // PD版本变化
+    SW3538_EVT_OVER_TEMP,            // 温度超过阈值
+    SW3538_EVT_TEMP_NORMAL,          // 温度回落到阈值-回差以下
+    SW3538_EVT_CURRENT_ABOVE,        // 通路电流超过阈值
+    SW3538_EVT_CURRENT_BELOW,        // 通路电流回落到阈值-回差以下
+    SW3538_EVT_COUNT
+};
+
+#define SW3538_EVT_MASK(type) (1UL << (type))
+
+// 常用掩码组合
+#define SW3538_EVT_MASK_PATH   (SW3538_EVT_MASK(SW3538_EVT_PATH_ONLINE) | SW3538_EVT_MASK(SW3538_EVT_PATH_OFFLINE))
+#define SW3538_EVT_MASK_FAST   (SW3538_EVT_MASK(SW3538_EVT_FAST_CHARGE_ON) | SW3538_EVT_MASK(SW3538_EVT_FAST_CHARGE_OFF))
+#define SW3538_EVT_MASK_ALL    ((1UL << SW3538_EVT_COUNT) - 1)
+
+/**
+ * @brief 事件内容
+ *
+ * path仅对通路相关事件有效（1或2），其余为0；
+ * oldValue/newValue为上次与本次采样的值（状态类为0/1，协议为枚举值，温度为°C，电流为mA），
+ * 阈值类事件同样传采样值（阈值见setCurrentThreshold()/setOverTempThreshold()）
+ */
+struct SW3538_Event {
+    SW3538_EventType type;
+    uint8_t source;                  // 设备序号（单芯片为0）
+    uint8_t path;
+    int32_t oldValue;
+    int32_t newValue;
+    uint32_t timeMs;                 // 事件检测时间（millis()）
+    const SW3538_Data_t* sample;     // 触发事件的采样
+};
+
+typedef void (*SW3538_EventCallback)(const SW3538_Event& evt, void* ctx);
+
+/**
+ * @brief 单个数据源的比较状态
+ *
+ * 初始为全零（通路离线、无快充），首次采样即可产生接入事件
+ */
+struct SW3538EventState {
+    SW3538_Data_t last;
+    bool overTemp;
+    bool currentAbove[2];
+};
+
+/**
+ * @class SW3538EventBus
+ * @brief 采样差分与事件分发
+ */
+class SW3538EventBus {
+public:
+    SW3538EventBus();
+
+    /**
+     * @brief 注册事件回调
+     *
+     * @param mask 关注的事件掩码（SW3538_EVT_MASK组合）
+     * @return false 订阅表已满
+     */
+    bool subscribe(uint32_t mask, SW3538_EventCallback cb, void* ctx = nullptr);
+
+    /**
+     * @brief 注销事件回调
+     */
+    bool unsubscribe(SW3538_EventCallback cb, void* ctx = nullptr);
+
+    /**
+     * @brief 设置过温阈值
+     *
+     * @param tempC 阈值，单位°C
+     * @param hysteresisC 回差，单位°C
+     */
+    void setOverTempThreshold(int16_t tempC, int16_t hysteresisC = 5);
+
+    /**
+     * @brief 设置通路电流阈值（两路共用）
+     *
+     * @param mA 阈值，单位mA
+     * @param hysteresisMA 回差，单位mA
+     */
+    void setCurrentThreshold(int16_t mA, int16_t hysteresisMA = 20);
+
+    /**
+     * @brief 与内部状态比较并分发事件（单芯片）
+     *
+     * @return 本次产生的事件类型掩码
+     */
+    uint32_t process(const SW3538_Data_t& sample) { return process(sample, _state, 0); }
+
+    /**
+     * @brief 与指定状态比较并分发事件（多芯片）
+     *
+     * @param sample 新采样
+     * @param state 该数据源的比较状态，处理后更新为新采样
+     * @param source 设备序号，原样填入事件
+     * @return 本次产生的事件类型掩码
+     */
+    uint32_t process(const SW3538_Data_t& sample, SW3538EventState& state, uint8_t source);
+
+    /**
+     * @brief 重置比较状态
+     */
+    static void resetState(SW3538EventState& state);
+
+private:
+    struct Subscriber {
+        uint32_t mask;
+        SW3538_EventCallback cb;
+        void* ctx;
+    };
+
+    Subscriber _subs[SW3538_EVENT_MAX_SUBSCRIBERS];
+    uint8_t _subCount;
+
+    int16_t _overTempC;
+    int16_t _tempHystC;
+    int16_t _currentMA;
+    int16_t _currentHystMA;
+
+    SW3538EventState _state;
+
+    void emit(SW3538_Event& evt, SW3538_EventType type, int32_t oldValue, int32_t newValue, uint32_t& fired);
+};
+
+#endif // SW3538_EVENTS_H
@@ -0,0 +1,151 @@
+/*
+ * sw3538_manager.cpp - 多芯片轮询管理器实现
+ */
+
+#include "sw3538_manager.h"
+
+SW3538Manager::SW3538Manager()
+    : _count(0), _next(0),
+      _budgetUs(0), _windowMs(1000), _windowStart(0), _windowUsedUs(0), _budgetSkips(0),
+      _callback(nullptr), _callbackCtx(nullptr) {
+}
+
+bool SW3538Manager::hasDevice(TwoWire& wire, uint8_t address) const {
+    for (uint8_t i = 0; i < _count; i++) {
+        if (&_devices[i].driver.getWire() == &wire && _devices[i].driver.getAddress() == address) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SW3538Manager::addDevice(TwoWire& wire, uint8_t address) {
+    if (_count >= SW3538_MAX_DEVICES || hasDevice(wire, address)) return false;
+
+    SW3538Device& dev = _devices[_count];
+    dev.driver = SW3538(address, wire);
+    dev.lastReadUs = 0;
+    dev.samples = 0;
+    dev.failures = 0;
+    SW3538EventBus::resetState(dev.events);
+    _count++;
+    return true;
+}
+
+// 探测 - 直接用总线事务，不构造驱动：逐地址构造/重试会在空地址上浪费时间
+bool SW3538Manager::probe(TwoWire& wire, uint8_t address) {
+    wire.beginTransmission(address);
+    if (wire.endTransmission() != 0) return false;
+
+    wire.beginTransmission(address);
+    wire.write(SW3538_REG_OFFSET(SW3538_REG_VERSION));
+    if (wire.endTransmission(false) != 0) return false;
+    if (wire.requestFrom(address, (uint8_t)1) != 1) return false;
+
+    int version = wire.read();
+    return version > 0x00 && version < 0xFF;
+}
+
+uint8_t SW3538Manager::discover(TwoWire& wire, uint8_t firstAddr, uint8_t lastAddr) {
+    uint8_t added = 0;
+    for (uint16_t addr = firstAddr; addr <= lastAddr && _count < SW3538_MAX_DEVICES; addr++) {
+        if (probe(wire, (uint8_t)addr) && addDevice(wire, (uint8_t)addr)) {
+            added++;
+        }
+    }
+    SW3538DefaultLogger::logVal("Managed devices: ", _count);
+    return added;
+}
+
+void SW3538Manager::begin() {
+    for (uint8_t i = 0; i < _count; i++) {
+        _devices[i].scan.begin();
+    }
+    _windowStart = millis();
+    _windowUsedUs = 0;
+}
+
+void SW3538Manager::setBusBudget(uint32_t budgetUs, uint32_t windowMs) {
+    _budgetUs = budgetUs;
+    _windowMs = windowMs > 0 ? windowMs : 1;
+}
+
+int8_t SW3538Manager::poll() {
+    if (_count == 0) return -1;
+
+    uint32_t now = millis();
+
+    // 预算窗口滚动
+    if (now - _windowStart >= _windowMs) {
+        _windowStart = now;
+        _windowUsedUs = 0;
+    }
+
+    for (uint8_t n = 0; n < _count; n++) {
+        uint8_t i = (_next + n) % _count;
+        SW3538Device& dev = _devices[i];
+        if (!dev.scan.isDue(now)) continue;
+
+        // 预算耗尽：保持到期状态，等待下个窗口
+        if (_budgetUs > 0 && _windowUsedUs >= _budgetUs) {
+            _budgetSkips++;
+            return -1;
+        }
+
+        dev.scan.markScanned(now);
+
+        uint32_t t0 = micros();
+        bool ok = dev.driver.readAllData();
+        dev.lastReadUs = micros() - t0;
+        _windowUsedUs += dev.lastReadUs;
+
+        _next = (i + 1) % _count;
+
+        if (!ok) {
+            dev.failures++;
+            return (int8_t)i;
+        }
+
+        dev.samples++;
+        const SW3538_Data_t& d = dev.driver.data;
+        // 电流读数无效时保持上次值，不能据此判断负载稳定
+        if ((d.validMask & SW3538_VALID_CURRENTS) == SW3538_VALID_CURRENTS) {
+            dev.scan.updateCurrent(d.currentPath1mA + d.currentPath2mA);
+        }
+        if (_events.process(d, dev.events, i) & AdaptiveScan::EVENT_MASK) {
+            dev.scan.notifyChange();
+        }
+
+        if (_callback) {
+            _callback(i, dev, _callbackCtx);
+        }
+        return (int8_t)i;
+    }
+
+    return -1;
+}
+
+uint32_t SW3538Manager::getTotalSamples() const {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < _count; i++) {
+        total += _devices[i].samples;
+    }
+    return total;
+}
+
+void SW3538Manager::printStatus(Print& serial) {
+    char buf[64];
+    serial.println("--- SW3538 Devices ---");
+    for (uint8_t i = 0; i < _count; i++) {
+        const SW3538Device& dev = _devices[i];
+        snprintf(buf, sizeof(buf), "#%u 0x%02X int:%lums read:%luus ok:%lu err:%lu",
+                 i, dev.driver.getAddress(),
+                 (unsigned long)dev.scan.getCurrentInterval(),
+                 (unsigned long)dev.lastReadUs,
+                 (unsigned long)dev.samples,
+                 (unsigned long)dev.failures);
+        serial.println(buf);
+    }
+    serial.print("Budget skips: "); serial.println(_budgetSkips);
+    serial.println("----------------------");
+}
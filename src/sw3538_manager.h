@@ -0,0 +1,151 @@
+/*
+ * sw3538_manager.h - 多芯片轮询管理器
+ *
+ * 设计说明：
+ * 1. 固定容量设备表，无动态内存分配
+ * 2. 每个设备独立的AdaptiveScan状态：忙碌端口高频采样，空闲端口低频采样
+ * 3. 轮询调度：每次poll()最多读取一个到期设备，按轮转顺序保证公平
+ * 4. 总线时间预算：在统计窗口内限制readAllData()占用的总线时间
+ */
+
+#ifndef SW3538_MANAGER_H
+#define SW3538_MANAGER_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "SW3538.h"
+#include "adaptive_scan.h"
+#include "sw3538_events.h"
+
+// 最大设备数量
+#ifndef SW3538_MAX_DEVICES
+#define SW3538_MAX_DEVICES 8
+#endif
+
+/**
+ * @brief 单个受管设备
+ */
+struct SW3538Device {
+    SW3538 driver;            // 驱动实例（含最新数据）
+    AdaptiveScan scan;        // 独立的自适应扫描状态
+    SW3538EventState events;  // 事件比较状态
+    uint32_t lastReadUs;      // 上次readAllData()耗时，单位us
+    uint32_t samples;         // 成功采样次数
+    uint32_t failures;        // 读取失败次数
+};
+
+/**
+ * @class SW3538Manager
+ * @brief 多个SW3538/SW3556/SW3558芯片的发现与轮询
+ *
+ * 使用方式：
+ * 1. 初始化各条I2C总线后调用discover()或addDevice()
+ * 2. 调用begin()初始化各设备扫描状态
+ * 3. 在主循环中持续调用poll()
+ */
+class SW3538Manager {
+public:
+    /**
+     * @brief 采样回调
+     *
+     * @param index 设备序号
+     * @param device 设备（data字段为最新采样）
+     * @param ctx 注册时传入的上下文
+     */
+    typedef void (*SampleCallback)(uint8_t index, SW3538Device& device, void* ctx);
+
+    SW3538Manager();
+
+    /**
+     * @brief 在指定总线上探测芯片并加入设备表
+     *
+     * 逐个地址检查应答和版本寄存器，与scanI2CAddresses()相同的判定，
+     * 但直接发起总线事务、不构造驱动实例，也不打印
+     *
+     * @param wire 已初始化的I2C总线
+     * @param firstAddr 起始地址（含）
+     * @param lastAddr 结束地址（含）
+     * @return 本次新增的设备数量
+     */
+    uint8_t discover(TwoWire& wire, uint8_t firstAddr = 0x08, uint8_t lastAddr = 0x77);
+
+    /**
+     * @brief 直接添加已知地址的设备（不探测）
+     *
+     * @return false 设备表已满或设备已存在
+     */
+    bool addDevice(TwoWire& wire, uint8_t address);
+
+    /**
+     * @brief 初始化所有设备的扫描状态
+     */
+    void begin();
+
+    /**
+     * @brief 设置总线时间预算
+     *
+     * @param budgetUs 每个窗口内允许的总读取时间，单位us
+     * @param windowMs 统计窗口长度，单位ms
+     */
+    void setBusBudget(uint32_t budgetUs, uint32_t windowMs);
+
+    /**
+     * @brief 设置采样回调
+     */
+    void setSampleCallback(SampleCallback cb, void* ctx) { _callback = cb; _callbackCtx = ctx; }
+
+    /**
+     * @brief 轮询一次
+     *
+     * 从上次位置开始轮转查找第一个到期设备并读取，非阻塞（单次读取除外）
+     *
+     * @return 已读取的设备序号，无设备到期或预算耗尽时返回-1
+     */
+    int8_t poll();
+
+    uint8_t getDeviceCount() const { return _count; }
+    SW3538Device& getDevice(uint8_t index) { return _devices[index]; }
+
+    /**
+     * @brief 获取事件总线
+     *
+     * 所有设备的事件经同一总线分发，SW3538_Event::source为设备序号
+     */
+    SW3538EventBus& getEventBus() { return _events; }
+
+    /**
+     * @brief 获取所有设备的累计成功采样数
+     */
+    uint32_t getTotalSamples() const;
+
+    /**
+     * @brief 获取预算耗尽导致的跳过次数
+     */
+    uint32_t getBudgetSkips() const { return _budgetSkips; }
+
+    /**
+     * @brief 打印设备表状态
+     */
+    void printStatus(Print& serial);
+
+private:
+    SW3538Device _devices[SW3538_MAX_DEVICES];
+    uint8_t _count;
+    uint8_t _next;                // 下次轮询起点
+
+    uint32_t _budgetUs;           // 窗口预算，0表示不限制
+    uint32_t _windowMs;
+    uint32_t _windowStart;
+    uint32_t _windowUsedUs;
+    uint32_t _budgetSkips;
+
+    SW3538EventBus _events;
+
+    SampleCallback _callback;
+    void* _callbackCtx;
+
+    bool hasDevice(TwoWire& wire, uint8_t address) const;
+    static bool probe(TwoWire& wire, uint8_t address);
+};
+
+#endif // SW3538_MANAGER_H
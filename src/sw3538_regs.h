@@ -0,0 +1,128 @@
+/*
+ * sw3538_regs.h - SW3538寄存器字段描述表
+ *
+ * 设计说明：
+ * 1. 每个SW3538_Data_t字段对应一条描述：寄存器地址（含页号）、原始帧槽位、
+ *    位范围、换算系数、有无符号；ADC字段另记通道号和强制使能位
+ * 2. 采集（readAllData）、解码（decodeRawFrame）、寄存器转储（dumpRegisters）
+ *    都遍历同一张表，新增字段只需加一行；同一寄存器的字段共用一次读取
+ * 3. 表为constexpr，解码循环次数和每项参数都是编译期常量，可展开为直线代码
+ * 4. 地址高字节为页号；0x100以上的寄存器需要翻页访问，驱动目前不支持，
+ *    读写时直接报错而不是截断成低8位去访问另一个寄存器
+ */
+
+#ifndef SW3538_REGS_H
+#define SW3538_REGS_H
+
+#include <Arduino.h>
+
+#define SW3538_REG_PAGE(reg)        ((uint8_t)((reg) >> 8))
+#define SW3538_REG_OFFSET(reg)      ((uint8_t)((reg) & 0xFF))
+
+// 原始帧槽位（SW3538_RawFrame中的成员）
+enum SW3538_Source : uint8_t {
+    SW3538_SRC_VERSION = 0,
+    SW3538_SRC_MAX_POWER,
+    SW3538_SRC_FAST_CHARGE,
+    SW3538_SRC_STATUS0,
+    SW3538_SRC_STATUS1,
+    SW3538_SRC_NTC_STATE,
+    SW3538_SRC_ADC_IBUS1,       // 以下为adc[]，顺序同SW3538_RAW_*
+    SW3538_SRC_ADC_IBUS2,
+    SW3538_SRC_ADC_VIN,
+    SW3538_SRC_ADC_VOUT,
+    SW3538_SRC_ADC_NTC,
+    SW3538_SRC_COUNT
+};
+
+#define SW3538_SRC_ADC_FIRST        SW3538_SRC_ADC_IBUS1
+
+// 解码目标
+enum SW3538_Target : uint8_t {
+    SW3538_T_CHIP_VERSION = 0,
+    SW3538_T_MAX_POWER,
+    SW3538_T_FAST_CHARGE,
+    SW3538_T_PD_VERSION,
+    SW3538_T_PROTOCOL,
+    SW3538_T_BUCK1,
+    SW3538_T_BUCK2,
+    SW3538_T_ONLINE1,
+    SW3538_T_ONLINE2,
+    SW3538_T_NTC_40UA,          // 不写入数据，供温度换算使用
+    SW3538_T_CURRENT1,
+    SW3538_T_CURRENT2,
+    SW3538_T_VIN,
+    SW3538_T_VOUT,
+    SW3538_T_NTC_TEMP,          // B值公式换算，依赖SW3538_T_NTC_40UA
+};
+
+/**
+ * @brief 字段描述
+ */
+struct SW3538_FieldDesc {
+    const char* name;
+    uint16_t reg;               // 寄存器地址（高字节为页号）；ADC字段为数据低字节寄存器
+    uint8_t adcChannel;         // ADC通道号，非ADC字段为SW3538_ADC_CH_NONE
+    uint8_t adcEnableBit;       // FORCE_OP2中的强制使能位
+    uint8_t source;             // SW3538_Source
+    uint8_t lsb;                // 起始位
+    uint8_t width;              // 位宽
+    bool isSigned;
+    float scale;                // 原始值→物理量（mA/mV），1为原始值
+    uint8_t target;             // SW3538_Target
+};
+
+#define SW3538_NO_ADC  0xFF, 0xFF
+
+// 按原始帧槽位排序：同一寄存器的字段相邻，采集时只读一次
+// 先读版本和最大功率，两者同为0xFF即判定通信失败
+static constexpr SW3538_FieldDesc SW3538_FIELDS[] = {
+    // name           reg    adc ch / en bit    source                  lsb w  signed scale   target
+    { "chipVersion",  0x00, SW3538_NO_ADC,      SW3538_SRC_VERSION,     0, 2,  false, 1.0f,  SW3538_T_CHIP_VERSION },
+    { "maxPowerW",    0x02, SW3538_NO_ADC,      SW3538_SRC_MAX_POWER,   0, 7,  false, 1.0f,  SW3538_T_MAX_POWER },
+    { "fastCharge",   0x09, SW3538_NO_ADC,      SW3538_SRC_FAST_CHARGE, 6, 2,  false, 1.0f,  SW3538_T_FAST_CHARGE },
+    { "pdVersion",    0x09, SW3538_NO_ADC,      SW3538_SRC_FAST_CHARGE, 4, 2,  false, 1.0f,  SW3538_T_PD_VERSION },
+    { "protocol",     0x09, SW3538_NO_ADC,      SW3538_SRC_FAST_CHARGE, 0, 4,  false, 1.0f,  SW3538_T_PROTOCOL },
+    { "path1Buck",    0x0A, SW3538_NO_ADC,      SW3538_SRC_STATUS0,     0, 1,  false, 1.0f,  SW3538_T_BUCK1 },
+    { "path2Buck",    0x0A, SW3538_NO_ADC,      SW3538_SRC_STATUS0,     1, 1,  false, 1.0f,  SW3538_T_BUCK2 },
+    { "path1Online",  0x0D, SW3538_NO_ADC,      SW3538_SRC_STATUS1,     1, 1,  false, 1.0f,  SW3538_T_ONLINE1 },
+    { "path2Online",  0x0D, SW3538_NO_ADC,      SW3538_SRC_STATUS1,     0, 1,  false, 1.0f,  SW3538_T_ONLINE2 },
+    { "ntc40uA",      0x44, SW3538_NO_ADC,      SW3538_SRC_NTC_STATE,   7, 1,  false, 1.0f,  SW3538_T_NTC_40UA },
+    { "currentPath1", 0x41, 1, 1,               SW3538_SRC_ADC_IBUS1,   0, 12, false, 2.5f,  SW3538_T_CURRENT1 },
+    { "currentPath2", 0x41, 2, 2,               SW3538_SRC_ADC_IBUS2,   0, 12, false, 2.5f,  SW3538_T_CURRENT2 },
+    { "inputVoltage", 0x41, 6, 6,               SW3538_SRC_ADC_VIN,     0, 12, false, 10.0f, SW3538_T_VIN },
+    { "outputVoltage",0x41, 11, 5,              SW3538_SRC_ADC_VOUT,    0, 15, false, 1.0f,  SW3538_T_VOUT },
+    { "ntcVoltage",   0x41, 7, 7,               SW3538_SRC_ADC_NTC,     0, 12, false, 1.2f,  SW3538_T_NTC_TEMP },
+};
+
+#undef SW3538_NO_ADC
+
+#define SW3538_FIELD_COUNT  (sizeof(SW3538_FIELDS) / sizeof(SW3538_FIELDS[0]))
+
+// ===== 编译期查询（C++11 constexpr，单表达式递归） =====
+
+// Table为描述表结构体（提供fieldCount和field(i)，见SW3538.h的SW3538Fields）
+
+// ADC通道对应的描述下标，未找到返回Table::fieldCount
+template<class Table>
+constexpr uint8_t sw3538AdcFieldIndex(uint8_t channel, uint8_t i = 0) {
+    return i >= Table::fieldCount ? (uint8_t)Table::fieldCount :
+           Table::field(i).adcChannel == channel ? i : sw3538AdcFieldIndex<Table>(channel, i + 1);
+}
+
+// 表中全部ADC字段的强制使能位掩码
+template<class Table>
+constexpr uint8_t sw3538AdcEnableMask(uint8_t i = 0) {
+    return i >= Table::fieldCount ? 0 :
+           (Table::field(i).adcEnableBit < 8 ? (uint8_t)(1 << Table::field(i).adcEnableBit) : 0) |
+           sw3538AdcEnableMask<Table>(i + 1);
+}
+
+// 位范围提取，有符号字段做符号扩展
+constexpr int32_t sw3538ExtractField(uint16_t value, const SW3538_FieldDesc& f) {
+    return f.isSigned && ((value >> (f.lsb + f.width - 1)) & 1)
+         ? (int32_t)((value >> f.lsb) & ((1UL << f.width) - 1)) - (int32_t)(1UL << f.width)
+         : (int32_t)((value >> f.lsb) & ((1UL << f.width) - 1));
+}
+
+#endif // SW3538_REGS_H
@@ -0,0 +1,19 @@
+/*
+ * bench_main.cpp - 主机基准入口
+ *
+ * 依次运行热路径微基准、过采样代价和串口报告代价，表格输出到标准输出
+ * （读取校验的故障注入见test_sw3538_read.cpp）
+ */
+
+#include <Arduino.h>
+#include "benchmark.h"
+
+int main() {
+    // 微基准按真实时间计时；模拟总线的耗时仍按虚拟时钟统计
+    hostUseRealClock(true);
+
+    runBenchmarks(Serial);
+    runOversampleBench(Serial);
+    runReportBench(Serial);
+    return 0;
+}
@@ -0,0 +1,421 @@
+/*
+ * benchmark.cpp - 解码与渲染热路径微基准实现
+ *
+ * 只链接进主机基准程序：这里替换的malloc/calloc/realloc对整个进程生效
+ */
+
+#include "benchmark.h"
+#include "SW3538.h"
+#include "global_data.h"
+#include "display.h"
+#include "adaptive_scan.h"
+#include "profile_generator.h"
+#include "history_graph.h"
+#include "packed_sample.h"
+#include "sim_bus.h"
+#include "report_builder.h"
+#include "channel_stats.h"
+#include <stddef.h>
+
+#define BENCH_INPUTS   16      // 输入样本数（2的幂）
+
+static volatile uint32_t benchSink;
+
+static SW3538_RawFrame inputFrames[BENCH_INPUTS];
+static SW3538_Data_t inputData[BENCH_INPUTS];
+static SW3538Snapshot inputSnaps[BENCH_INPUTS];
+static AdaptiveScan benchScan;
+
+// 用PD固定档脚本的不同时刻生成输入，覆盖空闲、快充、涓流
+static void prepareInputs() {
+    ProfileGenerator gen;
+    gen.begin(PROFILE_PD_FIXED, 7);
+    for (uint8_t i = 0; i < BENCH_INPUTS; i++) {
+        gen.sample(i * 10000UL, inputFrames[i]);
+        SW3538::decodeRawFrame(inputFrames[i], inputData[i]);
+        inputSnaps[i].data = inputData[i];
+        computeDisplayData(inputData[i], inputSnaps[i].display);
+        inputSnaps[i].version = i + 1;
+    }
+    benchScan.begin();
+}
+
+// ===== 用例 =====
+
+static void benchDecode(uint32_t n) {
+    SW3538_Data_t data;
+    for (uint32_t i = 0; i < n; i++) {
+        SW3538::decodeRawFrame(inputFrames[i & (BENCH_INPUTS - 1)], data);
+        benchSink += data.currentPath1mA;
+    }
+}
+
+static void benchNtc(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        benchSink += SW3538::ntcRawToCelsius(inputFrames[i & (BENCH_INPUTS - 1)].adc[SW3538_RAW_NTC], false);
+    }
+}
+
+static void benchDisplayData(uint32_t n) {
+    DisplayData out;
+    for (uint32_t i = 0; i < n; i++) {
+        computeDisplayData(inputData[i & (BENCH_INPUTS - 1)], out);
+        benchSink += (uint32_t)out.power;
+    }
+}
+
+static void benchProtocolName(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        benchSink += SW3538::getProtocolName((SW3538_FastChargeProtocol)(i & 0x0F))[0];
+    }
+}
+
+// 与displaySw3538Data()相同的6次格式化
+static void benchFormat(uint32_t n) {
+    char buf[16];
+    for (uint32_t i = 0; i < n; i++) {
+        const DisplayData& d = inputSnaps[i & (BENCH_INPUTS - 1)].display;
+        benchSink += snprintf(buf, sizeof(buf), "%.1fW", d.current1 * d.outputVoltage);
+        benchSink += snprintf(buf, sizeof(buf), "%.2fV", d.outputVoltage);
+        benchSink += snprintf(buf, sizeof(buf), "%.2fA", d.current1);
+        benchSink += snprintf(buf, sizeof(buf), "%.1fW", d.current2 * d.outputVoltage);
+        benchSink += snprintf(buf, sizeof(buf), "%.2fV", d.outputVoltage);
+        benchSink += snprintf(buf, sizeof(buf), "%.2fA", d.current2);
+    }
+}
+
+static void benchRender(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        renderSw3538Data(inputSnaps[i & (BENCH_INPUTS - 1)]);
+    }
+    benchSink += n;
+}
+
+// 曲线屏：整屏重绘与增量滚动（每次一列）对比
+static HistoryGraph benchGraph;
+
+static void benchGraphFull(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        benchGraph.push(inputData[i & (BENCH_INPUTS - 1)]);
+        benchSink += benchGraph.renderFull();
+    }
+}
+
+static void benchGraphScroll(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        benchGraph.push(inputData[i & (BENCH_INPUTS - 1)]);
+        benchSink += benchGraph.render();
+    }
+}
+
+static void benchPack(uint32_t n) {
+    PackedSample p;
+    for (uint32_t i = 0; i < n; i++) {
+        packSample(inputData[i & (BENCH_INPUTS - 1)], 200, p);
+        benchSink += p.w[1];
+    }
+}
+
+static void benchUnpack(uint32_t n) {
+    PackedSample packed[BENCH_INPUTS];
+    for (uint8_t i = 0; i < BENCH_INPUTS; i++) packSample(inputData[i], 200, packed[i]);
+    SW3538_Data_t data;
+    for (uint32_t i = 0; i < n; i++) {
+        unpackSample(packed[i & (BENCH_INPUTS - 1)], data);
+        benchSink += data.currentPath1mA;
+    }
+}
+
+// 串口报告：逐项print与单次写出对比，输出到只计数的Print
+class CountingPrint : public Print {
+public:
+    uint32_t bytes = 0;
+    uint32_t calls = 0;
+    size_t write(uint8_t) override { bytes++; calls++; return 1; }
+    size_t write(const uint8_t*, size_t size) override { bytes += size; calls++; return size; }
+};
+
+static CountingPrint benchSerial;
+static SW3538SimBus benchBus;
+static SW3538Sim benchDriver(SW3538_DEFAULT_ADDRESS, benchBus);
+static SW3538Report benchReport;
+
+static void benchPrintAll(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        benchDriver.data = inputData[i & (BENCH_INPUTS - 1)];
+        benchDriver.printAllData(benchSerial);
+    }
+    benchSink += benchSerial.bytes;
+}
+
+static void benchReportFull(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        benchSink += benchReport.write(benchSerial, inputData[i & (BENCH_INPUTS - 1)], REPORT_FULL);
+    }
+}
+
+static void benchReportChanges(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        benchSink += benchReport.write(benchSerial, inputData[i & (BENCH_INPUTS - 1)], REPORT_CHANGES);
+    }
+}
+
+static void benchScanUpdate(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        const SW3538_Data_t& d = inputData[i & (BENCH_INPUTS - 1)];
+        benchScan.updateCurrent(d.currentPath1mA + d.currentPath2mA);
+    }
+    benchSink += benchScan.getCurrentInterval();
+}
+
+static void benchPublish(uint32_t n) {
+    SW3538Snapshot snap;
+    for (uint32_t i = 0; i < n; i++) {
+        publishSW3538Data(inputData[i & (BENCH_INPUTS - 1)]);
+        readSnapshot(snap);
+        benchSink += snap.version;
+    }
+}
+
+// 流式统计：单个P²估计器与全部通道（5通道 × Welford + 3个P²）
+static P2Quantile benchP2;
+static StreamingStats benchStats;
+
+static void benchP2Add(uint32_t n) {
+    benchP2.reset(0.95f);
+    for (uint32_t i = 0; i < n; i++) {
+        benchP2.add(inputData[i & (BENCH_INPUTS - 1)].currentPath1mA + (float)(i & 0x3F));
+    }
+    benchSink += (uint32_t)benchP2.value();
+}
+
+static void benchStatsUpdate(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        benchSink += benchStats.update(i * 200, inputData[i & (BENCH_INPUTS - 1)]);
+    }
+}
+
+struct BenchCase {
+    const char* name;
+    void (*fn)(uint32_t n);
+};
+
+static const BenchCase BENCH_CASES[] = {
+    { "decode",        benchDecode },
+    { "ntc",           benchNtc },
+    { "display-data",  benchDisplayData },
+    { "protocol-name", benchProtocolName },
+    { "format",        benchFormat },
+    { "render",        benchRender },
+    { "graph-full",    benchGraphFull },
+    { "graph-scroll",  benchGraphScroll },
+    { "pack",          benchPack },
+    { "unpack",        benchUnpack },
+    { "print-all",     benchPrintAll },
+    { "report-full",   benchReportFull },
+    { "report-change", benchReportChanges },
+    { "scan-update",   benchScanUpdate },
+    { "p2-add",        benchP2Add },
+    { "stats-update",  benchStatsUpdate },
+    { "publish+read",  benchPublish },
+};
+
+#define BENCH_CASE_COUNT (sizeof(BENCH_CASES) / sizeof(BENCH_CASES[0]))
+
+// ===== 运行器 =====
+
+// glibc的原始实现；operator new经由malloc分配，同样被计入
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+}
+
+static volatile uint32_t allocCount = 0;
+
+extern "C" void* malloc(size_t size) {
+    allocCount++;
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    allocCount++;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) {
+    allocCount++;
+    return __libc_realloc(ptr, size);
+}
+
+static uint32_t timeRun(void (*fn)(uint32_t), uint32_t n) {
+    uint32_t t0 = micros();
+    fn(n);
+    return micros() - t0;
+}
+
+// 迭代次数翻倍直到单轮超过目标的1/8，再按比例放大到目标时长
+static uint32_t calibrate(void (*fn)(uint32_t)) {
+    uint32_t n = 1;
+    uint32_t us = timeRun(fn, n);
+    while (us < BENCH_TARGET_US / 8 && n < 0x10000000UL) {
+        n <<= 1;
+        us = timeRun(fn, n);
+    }
+    if (us == 0) return n;
+    uint64_t scaled = (uint64_t)n * BENCH_TARGET_US / us;
+    return scaled > 0 ? (uint32_t)scaled : 1;
+}
+
+static void runCase(const BenchCase& c, BenchResult& r) {
+    uint32_t allocBefore = allocCount;
+    uint32_t n = calibrate(c.fn);
+
+    float ns[BENCH_RUNS];
+    for (uint8_t run = 0; run < BENCH_RUNS; run++) {
+        ns[run] = timeRun(c.fn, n) * 1000.0f / n;
+    }
+
+    // 插入排序，取中位数
+    for (uint8_t i = 1; i < BENCH_RUNS; i++) {
+        float v = ns[i];
+        int8_t j = i - 1;
+        while (j >= 0 && ns[j] > v) {
+            ns[j + 1] = ns[j];
+            j--;
+        }
+        ns[j + 1] = v;
+    }
+
+    r.name = c.name;
+    r.iterations = n;
+    r.minNs = ns[0];
+    r.medianNs = ns[BENCH_RUNS / 2];
+    r.maxNs = ns[BENCH_RUNS - 1];
+    r.allocations = allocCount - allocBefore;
+}
+
+uint8_t runBenchmarks(BenchResult* results, uint8_t maxResults) {
+    // publish用例会改写全局快照，结束后恢复
+    SW3538Snapshot saved;
+    bool hadData = readSnapshot(saved);
+    prepareInputs();
+
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < BENCH_CASE_COUNT && count < maxResults; i++) {
+        BENCH_CASES[i].fn(BENCH_INPUTS);  // 预热
+        runCase(BENCH_CASES[i], results[count++]);
+    }
+
+    if (hadData) publishSW3538Data(saved.data);
+    return count;
+}
+
+uint8_t runBenchmarks(Print& serial) {
+    BenchResult results[BENCH_CASE_COUNT];
+    uint8_t count = runBenchmarks(results, BENCH_CASE_COUNT);
+
+    char buf[72];
+    snprintf(buf, sizeof(buf), "[Bench] %u runs x %lums", BENCH_RUNS, (unsigned long)(BENCH_TARGET_US / 1000));
+    serial.println(buf);
+    snprintf(buf, sizeof(buf), "%-14s %10s %9s %9s %6s", "case", "min ns/op", "median", "max", "allocs");
+    serial.println(buf);
+    for (uint8_t i = 0; i < count; i++) {
+        const BenchResult& r = results[i];
+        snprintf(buf, sizeof(buf), "%-14s %10.1f %9.1f %9.1f %6lu",
+                 r.name, r.minNs, r.medianNs, r.maxNs, (unsigned long)r.allocations);
+        serial.println(buf);
+    }
+    return count;
+}
+
+// ===== 过采样代价 =====
+
+void runOversampleBench(Print& serial) {
+    // PD固定档快充段的一帧作为真值，各通道附加0.375 LSB的小数部分
+    ProfileGenerator gen;
+    SW3538_RawFrame truth;
+    gen.begin(PROFILE_PD_FIXED, 7);
+    gen.setNoise(0, 0);
+    gen.sample(30000, truth);
+
+    SW3538SimBus& bus = benchBus;
+    SW3538Sim& driver = benchDriver;
+    bus.setFrame(truth, 96);
+    bus.setNoise(OVERSAMPLE_BENCH_NOISE_Q8);
+
+    char buf[80];
+    snprintf(buf, sizeof(buf), "[Oversample] noise %.2f LSB, %u reads per setting",
+             OVERSAMPLE_BENCH_NOISE_Q8 / 256.0f, OVERSAMPLE_BENCH_READS);
+    serial.println(buf);
+    snprintf(buf, sizeof(buf), "%4s %4s %9s %9s %9s %8s %8s", "bits", "N", "ms@100k", "ms@400k",
+             "+ms/bit", "eff(I1)", "rms LSB");
+    serial.println(buf);
+
+    float baseMs = 0;
+    for (uint8_t bits = 0; bits <= SW3538_OVERSAMPLE_MAX_BITS; bits++) {
+        driver.setOversampleBits(bits);
+        bus.resetStats();
+
+        // 通路1电流与真值的均方根误差（LSB）
+        float truthLsb = bus.getAdcTruth(SW3538_RAW_IBUS1) / 256.0f;
+        float errSq = 0, eff = 0;
+        for (uint8_t r = 0; r < OVERSAMPLE_BENCH_READS; r++) {
+            driver.readAllData();
+            const SW3538_Oversample& os = driver.getOversample(SW3538_RAW_IBUS1);
+            float err = (float)os.value / (1 << bits) - truthLsb;
+            errSq += err * err;
+            eff += driver.getEffectiveBits(SW3538_RAW_IBUS1);
+        }
+
+        float ms100 = bus.busTimeUs(100000) / 1000.0f / OVERSAMPLE_BENCH_READS;
+        float ms400 = bus.busTimeUs(400000) / 1000.0f / OVERSAMPLE_BENCH_READS;
+        if (bits == 0) baseMs = ms100;
+        snprintf(buf, sizeof(buf), "%4u %4u %9.2f %9.2f %9.2f %8.2f %8.3f",
+                 bits, 1U << (2 * bits), ms100, ms400, bits ? (ms100 - baseMs) / bits : 0.0f,
+                 eff / OVERSAMPLE_BENCH_READS, sqrtf(errSq / OVERSAMPLE_BENCH_READS));
+        serial.println(buf);
+    }
+    driver.setOversampleBits(0);
+}
+
+// ===== 串口报告代价 =====
+
+void runReportBench(Print& serial) {
+    // PD固定档脚本按200ms扫描，带默认噪声，接近实际的字段变化率
+    ProfileGenerator gen;
+    SW3538_RawFrame frame;
+    gen.begin(PROFILE_PD_FIXED, 7);
+
+    static SW3538_Data_t scans[REPORT_BENCH_SCANS];
+    for (uint16_t i = 0; i < REPORT_BENCH_SCANS; i++) {
+        gen.sample(i * 200UL, frame);
+        SW3538::decodeRawFrame(frame, scans[i]);
+    }
+
+    static const char* const names[3] = { "print-all", "report-full", "report-change" };
+    char buf[72];
+    snprintf(buf, sizeof(buf), "[Report] %u scans", REPORT_BENCH_SCANS);
+    serial.println(buf);
+    snprintf(buf, sizeof(buf), "%-14s %10s %10s %10s", "method", "bytes/scan", "calls/scan", "us/scan");
+    serial.println(buf);
+
+    for (uint8_t m = 0; m < 3; m++) {
+        CountingPrint sink;
+        benchReport.reset();
+        uint32_t t0 = micros();
+        for (uint16_t i = 0; i < REPORT_BENCH_SCANS; i++) {
+            if (m == 0) {
+                benchDriver.data = scans[i];
+                benchDriver.printAllData(sink);
+            } else {
+                benchReport.write(sink, scans[i], m == 1 ? REPORT_FULL : REPORT_CHANGES);
+            }
+        }
+        uint32_t us = micros() - t0;
+        snprintf(buf, sizeof(buf), "%-14s %10.1f %10.1f %10.2f", names[m],
+                 (float)sink.bytes / REPORT_BENCH_SCANS, (float)sink.calls / REPORT_BENCH_SCANS,
+                 (float)us / REPORT_BENCH_SCANS);
+        serial.println(buf);
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ * benchmark.h - 解码与渲染热路径微基准
+ *
+ * 设计说明：
+ * 1. 每个用例先预热，再标定迭代次数使单轮约BENCH_TARGET_US，
+ *    共运行BENCH_RUNS轮，报告每次操作耗时的最小/中位/最大值
+ * 2. 输入取自ProfileGenerator生成的原始帧，避免常量折叠
+ * 3. 替换malloc系列直接统计每个用例内的分配次数，热路径应为0
+ * 4. 结果写入volatile汇点，防止被优化掉
+ *
+ * 仅在主机上构建（make -C test/host bench），修改热路径前后各运行一次作为对比基线
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <Arduino.h>
+
+// 单轮目标时长（us）
+#ifndef BENCH_TARGET_US
+#define BENCH_TARGET_US   20000
+#endif
+
+// 每个用例的轮数（取中位数）
+#ifndef BENCH_RUNS
+#define BENCH_RUNS        7
+#endif
+
+// 过采样基准：单次转换噪声（1/256 LSB）和每档读取次数
+#ifndef OVERSAMPLE_BENCH_NOISE_Q8
+#define OVERSAMPLE_BENCH_NOISE_Q8   384     // 1.5 LSB
+#endif
+#ifndef OVERSAMPLE_BENCH_READS
+#define OVERSAMPLE_BENCH_READS      8
+#endif
+
+// 串口报告基准的扫描次数
+#ifndef REPORT_BENCH_SCANS
+#define REPORT_BENCH_SCANS          600
+#endif
+
+/**
+ * @brief 单个用例的结果
+ */
+struct BenchResult {
+    const char* name;
+    uint32_t iterations;      // 每轮迭代次数
+    float minNs;              // 每次操作耗时，单位ns
+    float medianNs;
+    float maxNs;
+    uint32_t allocations;     // 标定和计时各轮中的分配次数（malloc/calloc/realloc/new）
+};
+
+/**
+ * @brief 运行全部用例并输出表格
+ *
+ * 阻塞运行，耗时约 用例数 × BENCH_RUNS × BENCH_TARGET_US
+ *
+ * @param serial 输出目标
+ * @return 用例数
+ */
+uint8_t runBenchmarks(Print& serial);
+
+/**
+ * @brief 运行全部用例，结果写入数组
+ *
+ * @param results 输出数组
+ * @param maxResults 数组容量
+ * @return 实际运行的用例数
+ */
+uint8_t runBenchmarks(BenchResult* results, uint8_t maxResults);
+
+/**
+ * @brief 过采样代价：模拟总线上各过采样位数的总线时间、有效分辨率和实测误差
+ *
+ * 驱动连接SW3538SimBus，真值含LSB以下的小数部分，叠加OVERSAMPLE_BENCH_NOISE_Q8的噪声；
+ * 输出每多1位分辨率增加的总线时间
+ *
+ * @param serial 输出目标
+ */
+void runOversampleBench(Print& serial);
+
+/**
+ * @brief 串口报告代价：printAllData()与SW3538Report两种模式的每次扫描字节数、写调用次数和CPU时间
+ *
+ * 输入为PD固定档脚本按200ms扫描的REPORT_BENCH_SCANS帧，输出到只计数的Print
+ *
+ * @param serial 输出目标
+ */
+void runReportBench(Print& serial);
+
+#endif // BENCHMARK_H
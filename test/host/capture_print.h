@@ -0,0 +1,31 @@
+/*
+ * capture_print.h - 测试用Print：把输出收集到缓冲区，便于比较文本
+ */
+
+#ifndef CAPTURE_PRINT_H
+#define CAPTURE_PRINT_H
+
+#include <Arduino.h>
+
+class CapturePrint : public Print {
+public:
+    CapturePrint() { clear(); }
+
+    size_t write(uint8_t c) override {
+        if (_len < sizeof(_buf) - 1) _buf[_len++] = (char)c;
+        _buf[_len] = '\0';
+        return 1;
+    }
+    using Print::write;
+
+    void clear() { _len = 0; _buf[0] = '\0'; }
+    const char* text() const { return _buf; }
+    size_t length() const { return _len; }
+    bool contains(const char* s) const { return strstr(_buf, s) != nullptr; }
+
+private:
+    char _buf[4096];
+    size_t _len;
+};
+
+#endif // CAPTURE_PRINT_H
@@ -0,0 +1,43 @@
+/*
+ * host_test.h - 主机单元测试最小框架
+ *
+ * 用法：
+ *   HOST_TEST(name) { CHECK(cond); CHECK_NEAR(a, b, tol); }
+ * 测试在静态初始化时登记，由host_test_main.cpp按登记顺序运行
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+#include <math.h>
+
+struct HostTestCase {
+    const char* name;
+    void (*fn)();
+    HostTestCase* next;
+};
+
+void hostTestRegister(HostTestCase* tc);
+void hostTestFail(const char* file, int line, const char* expr);
+
+struct HostTestRegistrar {
+    HostTestRegistrar(HostTestCase* tc) { hostTestRegister(tc); }
+};
+
+#define HOST_TEST(name) \
+    static void name(); \
+    static HostTestCase name##_case = {#name, name, nullptr}; \
+    static HostTestRegistrar name##_registrar(&name##_case); \
+    static void name()
+
+#define CHECK(cond) \
+    do { if (!(cond)) hostTestFail(__FILE__, __LINE__, #cond); } while (0)
+
+#define CHECK_NEAR(a, b, tol) \
+    do { if (fabs((double)(a) - (double)(b)) > (double)(tol)) { \
+        char msg_[160]; \
+        snprintf(msg_, sizeof(msg_), "%s ~ %s (%g vs %g, tol %g)", #a, #b, (double)(a), (double)(b), (double)(tol)); \
+        hostTestFail(__FILE__, __LINE__, msg_); } } while (0)
+
+#endif // HOST_TEST_H
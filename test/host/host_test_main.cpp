@@ -0,0 +1,43 @@
+/*
+ * host_test_main.cpp - 主机单元测试入口
+ *
+ * 运行全部测试，或只运行名称包含命令行参数的测试
+ */
+
+#include <Arduino.h>
+#include <string.h>
+#include "host_test.h"
+
+static HostTestCase* head = nullptr;
+static HostTestCase* tail = nullptr;
+static unsigned failures = 0;
+
+void hostTestRegister(HostTestCase* tc) {
+    if (tail) tail->next = tc;
+    else head = tc;
+    tail = tc;
+}
+
+void hostTestFail(const char* file, int line, const char* expr) {
+    failures++;
+    fprintf(stderr, "  FAIL %s:%d: %s\n", file, line, expr);
+}
+
+int main(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    unsigned run = 0, failed = 0;
+
+    hostSerialMute(true);
+    for (HostTestCase* tc = head; tc; tc = tc->next) {
+        if (filter && !strstr(tc->name, filter)) continue;
+        unsigned before = failures;
+        tc->fn();
+        run++;
+        bool ok = failures == before;
+        if (!ok) failed++;
+        printf("%-40s %s\n", tc->name, ok ? "ok" : "FAILED");
+    }
+
+    printf("%u tests, %u failed\n", run, failed);
+    return failed == 0 ? 0 : 1;
+}
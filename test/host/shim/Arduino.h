@@ -0,0 +1,119 @@
+/*
+ * Arduino.h - 主机测试用的Arduino最小替身
+ *
+ * 设计说明：
+ * 1. 只提供src/（main.cpp除外）用到的接口，不定义ARDUINO，
+ *    各模块走stdio分支（Preferences/LittleFS改用本地文件）
+ * 2. 时钟默认纯虚拟：只由delay()和模拟总线传输推进，测试结果可复现；
+ *    基准测试切换为真实时钟+虚拟偏移
+ * 3. Serial写到stdout，可静音
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+
+using std::max;
+using std::min;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define INPUT_PULLUP 2
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+int digitalRead(uint8_t pin);
+void pinMode(uint8_t pin, uint8_t mode);
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buf, size_t n) {
+        size_t k = 0;
+        while (n--) k += write(*buf++);
+        return k;
+    }
+    size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t write(const char* s, size_t n) { return write((const uint8_t*)s, n); }
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    size_t print(const char* s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char v, int = 10) { return printNum((unsigned long)v); }
+    size_t print(short v, int = 10) { return printNum((long)v); }
+    size_t print(unsigned short v, int = 10) { return printNum((unsigned long)v); }
+    size_t print(int v, int = 10) { return printNum((long)v); }
+    size_t print(unsigned int v, int = 10) { return printNum((unsigned long)v); }
+    size_t print(long v, int = 10) { return printNum(v); }
+    size_t print(unsigned long v, int = 10) { return printNum(v); }
+    size_t print(double v, int digits = 2) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.*f", digits, v);
+        return write(buf);
+    }
+
+    size_t println() { return write("\r\n", 2); }
+    template<typename T>
+    size_t println(T v) { size_t n = print(v); return n + println(); }
+    template<typename T>
+    size_t println(T v, int fmt) { size_t n = print(v, fmt); return n + println(); }
+
+private:
+    size_t printNum(long v) { char buf[24]; snprintf(buf, sizeof(buf), "%ld", v); return write(buf); }
+    size_t printNum(unsigned long v) { char buf[24]; snprintf(buf, sizeof(buf), "%lu", v); return write(buf); }
+};
+
+class Stream : public Print {
+public:
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    virtual int peek() { return -1; }
+};
+
+class HostSerial : public Stream {
+public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buf, size_t n) override;
+    using Print::write;
+    int availableForWrite() override { return 4096; }
+    operator bool() const { return true; }
+};
+
+extern HostSerial Serial;
+
+// ===== 主机仿真扩展 =====
+
+/**
+ * @brief 推进虚拟时钟
+ */
+void hostAdvanceUs(uint32_t us);
+
+/**
+ * @brief 切换真实时钟（基准测试用），默认纯虚拟时钟
+ */
+void hostUseRealClock(bool enable);
+
+/**
+ * @brief Serial静音（仍统计字节数）
+ */
+void hostSerialMute(bool mute);
+
+/**
+ * @brief Serial累计写出字节数
+ */
+uint32_t hostSerialBytes();
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,79 @@
+/*
+ * U8g2lib.h - 主机测试用的U8g2替身
+ *
+ * 只保留1024字节帧缓冲和基本图元，文字只计宽度不绘制
+ */
+
+#ifndef HOST_U8G2LIB_H
+#define HOST_U8G2LIB_H
+
+#include <Arduino.h>
+
+struct u8g2_cb_t {};
+extern const u8g2_cb_t* U8G2_R0;
+
+#define U8X8_PIN_NONE 255
+
+extern const uint8_t u8g2_font_helvR08_tr[];
+extern const uint8_t u8g2_font_helvR14_tr[];
+extern const uint8_t u8g2_font_heisans_tr[];
+extern const uint8_t u8g2_font_4x6_tr[];
+
+class U8G2 {
+public:
+    U8G2();
+
+    bool begin() { return true; }
+    void initDisplay() {}
+    void setPowerSave(uint8_t) {}
+    void clearBuffer();
+    void sendBuffer() { _sentBytes += sizeof(_buf); }
+    void clearDisplay() { clearBuffer(); sendBuffer(); }
+    void clear() { clearDisplay(); }
+    void firstPage() { clearBuffer(); }
+    uint8_t nextPage() { sendBuffer(); return 0; }
+    void updateDisplay() { sendBuffer(); }
+    void updateDisplayArea(uint8_t tx, uint8_t ty, uint8_t tw, uint8_t th) { _sentBytes += 8UL * tw * th; (void)tx; (void)ty; }
+    void setBufferCurrTileRow(uint8_t) {}
+
+    uint8_t* getBufferPtr() { return _buf; }
+    uint8_t getBufferTileWidth() const { return 16; }
+    uint8_t getBufferTileHeight() const { return 8; }
+    int getDisplayWidth() const { return 128; }
+    int getDisplayHeight() const { return 64; }
+
+    void setFont(const uint8_t* font) { _font = font; }
+    void setDrawColor(uint8_t color) { _color = color; }
+    int getAscent() const;
+    int getDescent() const;
+    int getStrWidth(const char* s) const;
+    void drawStr(int x, int y, const char* s);
+
+    void drawPixel(int x, int y);
+    void drawHLine(int x, int y, int w) { drawBox(x, y, w, 1); }
+    void drawVLine(int x, int y, int h) { drawBox(x, y, 1, h); }
+    void drawLine(int x0, int y0, int x1, int y1);
+    void drawBox(int x, int y, int w, int h);
+    void drawFrame(int x, int y, int w, int h);
+
+    // ===== 主机仿真扩展 =====
+    uint32_t getSentBytes() const { return _sentBytes; }
+
+private:
+    uint8_t _buf[1024];
+    const uint8_t* _font;
+    uint8_t _color;
+    uint32_t _sentBytes;
+};
+
+#define HOST_U8G2_DRIVER(name) \
+    class name : public U8G2 { \
+    public: \
+        name(const u8g2_cb_t*, uint8_t, uint8_t, uint8_t) {} \
+    };
+
+HOST_U8G2_DRIVER(U8G2_SSD1306_128X64_NONAME_F_SW_I2C)
+HOST_U8G2_DRIVER(U8G2_SSD1306_128X64_NONAME_1_SW_I2C)
+HOST_U8G2_DRIVER(U8G2_SSD1306_128X64_NONAME_2_SW_I2C)
+
+#endif // HOST_U8G2LIB_H
@@ -0,0 +1,61 @@
+/*
+ * Wire.h - 主机测试用的TwoWire替身
+ *
+ * 事务按地址路由到挂接的SW3538SimBus，无设备应答的地址返回NACK；
+ * 按标准模式时序统计总线位数，并以设定时钟推进虚拟时钟，
+ * 使micros()测得的读取耗时与真实总线一致
+ */
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include <Arduino.h>
+
+class SW3538SimBus;
+
+#ifndef HOST_WIRE_MAX_DEVICES
+#define HOST_WIRE_MAX_DEVICES 16
+#endif
+
+class TwoWire : public Stream {
+public:
+    TwoWire();
+
+    bool begin() { return true; }
+    bool begin(int, int) { return true; }
+    bool setClock(uint32_t hz) { _clockHz = hz; return true; }
+    uint32_t getClock() const { return _clockHz; }
+
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t value) override;
+    using Print::write;
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity);
+    int available() override;
+    int read() override;
+
+    // ===== 主机仿真扩展 =====
+    /**
+     * @brief 挂接模拟芯片，按SW3538SimBus::getAddress()路由
+     */
+    bool attach(SW3538SimBus& device);
+    void detachAll() { _count = 0; _current = nullptr; }
+    uint32_t getTransactions() const { return _transactions; }
+
+private:
+    SW3538SimBus* _devices[HOST_WIRE_MAX_DEVICES];
+    uint8_t _count;
+    SW3538SimBus* _current;
+    uint8_t _rxLeft;
+    uint32_t _clockHz;
+    uint32_t _transactions;
+    uint64_t _bitRemainder;     // 不足1us的位时间累计（位 × 1000000）
+
+    SW3538SimBus* find(uint8_t address);
+    void spendBits(uint32_t bits);
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
+
+#endif // HOST_WIRE_H
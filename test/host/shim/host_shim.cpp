@@ -0,0 +1,183 @@
+/*
+ * host_shim.cpp - 主机测试替身实现
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <U8g2lib.h>
+#include <chrono>
+#include "sim_bus.h"
+
+// ===== 时钟 =====
+
+static uint64_t virtualUs = 0;
+static bool realClock = false;
+static const std::chrono::steady_clock::time_point clockStart = std::chrono::steady_clock::now();
+
+static uint64_t nowUs() {
+    uint64_t us = virtualUs;
+    if (realClock) {
+        us += std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - clockStart).count();
+    }
+    return us;
+}
+
+unsigned long millis() { return (unsigned long)(nowUs() / 1000); }
+unsigned long micros() { return (unsigned long)nowUs(); }
+void delay(unsigned long ms) { virtualUs += (uint64_t)ms * 1000; }
+void delayMicroseconds(unsigned int us) { virtualUs += us; }
+int digitalRead(uint8_t) { return HIGH; }
+void pinMode(uint8_t, uint8_t) {}
+
+void hostAdvanceUs(uint32_t us) { virtualUs += us; }
+void hostUseRealClock(bool enable) { realClock = enable; }
+
+// ===== Serial =====
+
+static bool serialMuted = false;
+static uint32_t serialBytes = 0;
+
+size_t HostSerial::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t HostSerial::write(const uint8_t* buf, size_t n) {
+    serialBytes += n;
+    if (!serialMuted) fwrite(buf, 1, n, stdout);
+    return n;
+}
+
+void hostSerialMute(bool mute) { serialMuted = mute; }
+uint32_t hostSerialBytes() { return serialBytes; }
+
+HostSerial Serial;
+
+// ===== TwoWire =====
+
+TwoWire::TwoWire()
+    : _count(0), _current(nullptr), _rxLeft(0), _clockHz(100000), _transactions(0), _bitRemainder(0) {
+}
+
+bool TwoWire::attach(SW3538SimBus& device) {
+    if (_count >= HOST_WIRE_MAX_DEVICES) return false;
+    _devices[_count++] = &device;
+    return true;
+}
+
+SW3538SimBus* TwoWire::find(uint8_t address) {
+    for (uint8_t i = 0; i < _count; i++) {
+        if (_devices[i]->getAddress() == address) return _devices[i];
+    }
+    return nullptr;
+}
+
+// 总线时间折算为虚拟时钟
+void TwoWire::spendBits(uint32_t bits) {
+    _bitRemainder += (uint64_t)bits * 1000000UL;
+    uint64_t us = _bitRemainder / _clockHz;
+    _bitRemainder -= us * _clockHz;
+    virtualUs += us;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+    _transactions++;
+    _current = find(address);
+    if (_current) _current->beginTransmission(address);
+    spendBits(1 + 9);
+}
+
+size_t TwoWire::write(uint8_t value) {
+    spendBits(9);
+    if (_current) _current->write(value);
+    return 1;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    if (sendStop) spendBits(1);
+    if (!_current) return 2;
+    return _current->endTransmission(sendStop);
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity) {
+    _transactions++;
+    spendBits(1 + 9 + 9UL * quantity + 1);
+    _current = find(address);
+    _rxLeft = _current ? _current->requestFrom(address, quantity) : 0;
+    return _rxLeft;
+}
+
+int TwoWire::available() {
+    return _rxLeft;
+}
+
+int TwoWire::read() {
+    if (_rxLeft == 0 || !_current) return -1;
+    _rxLeft--;
+    return _current->read();
+}
+
+TwoWire Wire;
+TwoWire Wire1;
+
+// ===== U8G2 =====
+
+static const u8g2_cb_t rotation0 = {};
+const u8g2_cb_t* U8G2_R0 = &rotation0;
+
+// 字体数据只存序号，用于查宽度/上下伸
+const uint8_t u8g2_font_helvR08_tr[1] = {0};
+const uint8_t u8g2_font_helvR14_tr[1] = {1};
+const uint8_t u8g2_font_heisans_tr[1] = {2};
+const uint8_t u8g2_font_4x6_tr[1] = {3};
+
+static const int8_t FONT_WIDTH[] = {5, 10, 6, 4};
+static const int8_t FONT_ASCENT[] = {8, 14, 9, 5};
+static const int8_t FONT_DESCENT[] = {-2, -3, -2, -1};
+
+U8G2::U8G2() : _font(u8g2_font_helvR08_tr), _color(1), _sentBytes(0) {
+    clearBuffer();
+}
+
+void U8G2::clearBuffer() {
+    memset(_buf, 0, sizeof(_buf));
+}
+
+int U8G2::getAscent() const { return FONT_ASCENT[_font[0]]; }
+int U8G2::getDescent() const { return FONT_DESCENT[_font[0]]; }
+int U8G2::getStrWidth(const char* s) const { return (int)strlen(s) * FONT_WIDTH[_font[0]]; }
+
+void U8G2::drawStr(int, int, const char*) {
+}
+
+void U8G2::drawPixel(int x, int y) {
+    if (x < 0 || x > 127 || y < 0 || y > 63) return;
+    uint8_t& b = _buf[(y / 8) * 128 + x];
+    if (_color) b |= (uint8_t)(1 << (y & 7));
+    else b &= (uint8_t)~(1 << (y & 7));
+}
+
+void U8G2::drawLine(int x0, int y0, int x1, int y1) {
+    int dx = abs(x1 - x0), dy = -abs(y1 - y0);
+    int sx = x0 < x1 ? 1 : -1, sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    for (;;) {
+        drawPixel(x0, y0);
+        if (x0 == x1 && y0 == y1) break;
+        int e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x0 += sx; }
+        if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+}
+
+void U8G2::drawBox(int x, int y, int w, int h) {
+    for (int j = y; j < y + h; j++)
+        for (int i = x; i < x + w; i++) drawPixel(i, j);
+}
+
+void U8G2::drawFrame(int x, int y, int w, int h) {
+    drawHLine(x, y, w);
+    drawHLine(x, y + h - 1, w);
+    drawVLine(x, y, h);
+    drawVLine(x + w - 1, y, h);
+}
@@ -0,0 +1,32 @@
+/*
+ * sim_frames.h - 测试用原始帧构造
+ */
+
+#ifndef SIM_FRAMES_H
+#define SIM_FRAMES_H
+
+#include "SW3538.h"
+
+/**
+ * @brief 构造单路输出的原始帧
+ *
+ * @param currentMA 通路1电流，0表示降压关闭、未接设备
+ * @param voutMV 输出电压
+ */
+inline SW3538_RawFrame makeFrame(uint16_t currentMA, uint16_t voutMV = 5000) {
+    SW3538_RawFrame f = {};
+    f.version = 0x01;
+    f.maxPower = 0x41;
+    f.fastCharge = 0x00;
+    f.status0 = currentMA > 0 ? 0x01 : 0x00;
+    f.status1 = currentMA > 0 ? 0x02 : 0x00;
+    f.ntcState = 0x00;
+    f.adc[SW3538_RAW_IBUS1] = (uint16_t)(currentMA / 2.5f);
+    f.adc[SW3538_RAW_IBUS2] = 0;
+    f.adc[SW3538_RAW_VIN] = 2000;           // 20V
+    f.adc[SW3538_RAW_VOUT] = voutMV;
+    f.adc[SW3538_RAW_NTC] = 1000;
+    return f;
+}
+
+#endif // SIM_FRAMES_H
@@ -0,0 +1,40 @@
+/*
+ * soak_main.cpp - 主机浸泡测试入口
+ *
+ * 在Linux上用虚拟时钟运行负载脚本，输出扫描分布、故障和事件检测延迟
+ *
+ *   ./soak                 全部脚本，各1小时
+ *   ./soak <序号> [小时]   指定脚本和时长
+ */
+
+#include <Arduino.h>
+#include <stdlib.h>
+#include "profile_generator.h"
+
+int main(int argc, char** argv) {
+    int first = 0, last = PROFILE_COUNT - 1;
+    float hours = 1.0f;
+
+    if (argc > 1) {
+        first = last = atoi(argv[1]);
+        if (first < 0 || first >= PROFILE_COUNT) {
+            fprintf(stderr, "profile must be 0..%d\n", PROFILE_COUNT - 1);
+            return 2;
+        }
+    }
+    if (argc > 2) hours = (float)atof(argv[2]);
+    if (hours <= 0.0f || hours > 1000.0f) {
+        fprintf(stderr, "hours must be in (0, 1000]\n");
+        return 2;
+    }
+
+    // SoakRunner自己推进虚拟时间，耗时用真实时钟统计
+    static SoakRunner soak;
+    uint32_t durationMs = (uint32_t)(hours * 3600000.0f);
+    for (int p = first; p <= last; p++) {
+        SoakResult result;
+        soak.run((LoadProfile)p, durationMs, result);
+        SoakRunner::printResult((LoadProfile)p, result, Serial);
+    }
+    return 0;
+}
@@ -0,0 +1,23 @@
+/*
+ * test_adaptive_scan.cpp - 扫描调度不产生串口输出
+ */
+
+#include "host_test.h"
+#include "adaptive_scan.h"
+
+// 默认配置下tick()只做调度，每次扫描不打印（ADAPTIVE_SCAN_DEBUG=1时才输出间隔）
+HOST_TEST(adaptive_scan_tick_is_silent) {
+    AdaptiveScan scan;
+    scan.begin();
+    uint32_t before = hostSerialBytes();
+    uint32_t scans = 0;
+    for (uint32_t ms = 0; ms < 60000; ms += 10) {
+        if (scan.tick()) {
+            scans++;
+            scan.updateCurrent(1000);
+        }
+        hostAdvanceUs(10000);
+    }
+    CHECK(scans > 10);
+    CHECK(hostSerialBytes() == before);
+}
@@ -0,0 +1,99 @@
+/*
+ * test_burst_capture.cpp - 突发采集：后触发放弃条件、与守护的快速读取通道仲裁
+ */
+
+#include <Wire.h>
+#include "host_test.h"
+#include "sim_frames.h"
+#include "sim_bus.h"
+#include "burst_capture.h"
+#include "protection_guard.h"
+
+#define BURST_ADDR      0x3D
+#define PERIOD_US       10000
+
+static SW3538SimBus chip(BURST_ADDR);
+static TwoWire burstBus;
+static SW3538 driver(BURST_ADDR, burstBus);
+static SW3538EventBus events;
+
+static void setupChip(uint16_t currentMA) {
+    burstBus.setClock(100000);
+    burstBus.attach(chip);
+    chip.setFrame(makeFrame(currentMA, 9000));
+    chip.setFaults(0, 0);
+    chip.setGlitchTargets(SIM_GLITCH_ALL);
+    driver.begin();
+}
+
+// 预触发窗口内的读失败超过BURST_POST_SAMPLES次，后触发仍采满
+HOST_TEST(burst_pre_trigger_errors_do_not_cut_post_capture) {
+    setupChip(1000);
+    static BurstCapture burst;
+    burst.begin(driver, events);
+    burst.arm(SW3538_ADC_CH_IBUS1, BURST_DEFAULT_TRIGGER, 1000);
+
+    chip.setGlitchTargets(SIM_GLITCH_ADC_HIGH);
+    chip.setFaults(0, 1000);
+    for (uint16_t i = 0; i < BURST_POST_SAMPLES + 100; i++) {
+        burst.service();
+        hostAdvanceUs(1000);
+    }
+    CHECK(burst.getErrors() > BURST_POST_SAMPLES);
+
+    // 触发后仍有少量毛刺：按触发后的失败计数不会放弃
+    uint16_t preErrors = burst.getErrors();
+    chip.setFaults(0, 20);
+    burst.trigger();
+    burst.service();
+    CHECK(burst.isDone());
+    CHECK(burst.getErrors() > preErrors);
+    CHECK(burst.getPostCount() == BURST_POST_SAMPLES);
+    CHECK(driver.getFastOwner() == nullptr);
+    CHECK(driver.getFastChannel() == SW3538_ADC_CH_NONE);
+}
+
+// 守护期间占用通道，突发采集暂停而不是逐次重新选通；守护结束后突发采集接管
+HOST_TEST(burst_yields_fast_channel_to_guard) {
+    setupChip(3200);
+    static BurstCapture burst;
+    burst.begin(driver, events);
+    burst.arm(SW3538_ADC_CH_VOUT, 0, 1000);
+    burst.service();
+    CHECK(driver.getFastOwner() == &burst);
+
+    ProtectionGuard guard;
+    guard.begin(driver);
+    guard.setCurrentLimit(3300, 300);
+    guard.setGuardPeriod(PERIOD_US);
+    CHECK(driver.readAllData());
+    guard.update(driver.data);
+    CHECK(guard.getGuardedChannel() == GUARD_CURRENT1);
+
+    // 首次守护采样在readAllData()之后，需重新选通一次
+    guard.service();
+    chip.resetStats();
+    for (uint16_t i = 0; i < 200; i++) {
+        burst.service();
+        guard.service();
+        hostAdvanceUs(PERIOD_US / 4);
+    }
+    CHECK(driver.getFastOwner() == &guard);
+    CHECK(chip.getRegister(SW3538_REG_ADC_CONFIG) == SW3538_ADC_CH_IBUS1);
+    // 只剩守护的快速读取：每周期至多两次（越限确认），每次读低、高字节各2个事务；
+    // 互相重新选通时每轮还有解锁、读改写和选通
+    CHECK(chip.getTransactions() <= (200 / 4 + 1) * 2 * 4);
+
+    // 电流回落，守护退出并释放通道
+    chip.setFrame(makeFrame(1000, 9000));
+    CHECK(driver.readAllData());
+    guard.update(driver.data);
+    CHECK(guard.getGuardedChannel() == GUARD_NONE);
+    CHECK(driver.getFastOwner() == nullptr);
+    hostAdvanceUs(1000);
+    burst.service();
+    CHECK(driver.getFastOwner() == &burst);
+    CHECK(driver.getFastChannel() == SW3538_ADC_CH_VOUT);
+    burst.disarm();
+    CHECK(driver.getFastOwner() == nullptr);
+}
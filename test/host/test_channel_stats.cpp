@@ -0,0 +1,87 @@
+/*
+ * test_channel_stats.cpp - P²分位数精度与Welford均值/方差
+ */
+
+#include <algorithm>
+#include "host_test.h"
+#include "channel_stats.h"
+
+#define N_SAMPLES 20000
+
+static float samples[N_SAMPLES];
+static float sorted[N_SAMPLES];
+
+static uint32_t rng = 1;
+static float uniform() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return (rng & 0xFFFFFF) / 16777216.0f;
+}
+
+// 12个均匀分布之和近似正态
+static float gaussian() {
+    float s = 0.0f;
+    for (uint8_t i = 0; i < 12; i++) s += uniform();
+    return s - 6.0f;
+}
+
+static float exactQuantile(float p) {
+    return sorted[(size_t)(p * (N_SAMPLES - 1) + 0.5f)];
+}
+
+static void checkQuantiles(float tolFraction) {
+    ChannelStats st;
+    st.reset();
+    double sum = 0.0;
+    for (size_t i = 0; i < N_SAMPLES; i++) {
+        st.add(samples[i]);
+        sum += samples[i];
+    }
+    std::copy(samples, samples + N_SAMPLES, sorted);
+    std::sort(sorted, sorted + N_SAMPLES);
+
+    // 容差按分布跨度（p1..p99.9）的比例给出
+    float span = exactQuantile(0.999f) - exactQuantile(0.001f);
+    float tol = span * tolFraction;
+    CHECK_NEAR(st.p50(), exactQuantile(0.50f), tol);
+    CHECK_NEAR(st.p95(), exactQuantile(0.95f), tol);
+    CHECK_NEAR(st.p99(), exactQuantile(0.99f), tol);
+
+    double mean = sum / N_SAMPLES;
+    double m2 = 0.0;
+    for (size_t i = 0; i < N_SAMPLES; i++) m2 += (samples[i] - mean) * (samples[i] - mean);
+    CHECK(st.count() == N_SAMPLES);
+    CHECK_NEAR(st.mean(), mean, fabs(mean) * 1e-4 + 1e-3);
+    CHECK_NEAR(st.variance(), m2 / (N_SAMPLES - 1), m2 / (N_SAMPLES - 1) * 1e-3);
+    CHECK(st.min() == sorted[0]);
+    CHECK(st.max() == sorted[N_SAMPLES - 1]);
+}
+
+HOST_TEST(p2_uniform_current) {
+    for (size_t i = 0; i < N_SAMPLES; i++) samples[i] = 500.0f + 2500.0f * uniform();
+    checkQuantiles(0.01f);
+}
+
+HOST_TEST(p2_gaussian_voltage) {
+    for (size_t i = 0; i < N_SAMPLES; i++) samples[i] = 9000.0f + 40.0f * gaussian();
+    checkQuantiles(0.02f);
+}
+
+// 双峰：30%空闲、70%充电
+HOST_TEST(p2_bimodal_current) {
+    for (size_t i = 0; i < N_SAMPLES; i++) {
+        samples[i] = (uniform() < 0.7f ? 2000.0f : 10.0f) + 20.0f * gaussian();
+    }
+    checkQuantiles(0.02f);
+}
+
+HOST_TEST(p2_few_samples_exact) {
+    P2Quantile q;
+    q.reset(0.5f);
+    CHECK(q.value() == 0.0f);
+    q.add(30.0f);
+    q.add(10.0f);
+    q.add(20.0f);
+    CHECK(q.value() == 20.0f);
+}
@@ -0,0 +1,145 @@
+/*
+ * test_charge_session.cpp - 充电会话：插拔起止、能量积分、协议时间线、会话表覆盖
+ */
+
+#include <Wire.h>
+#include "host_test.h"
+#include "capture_print.h"
+#include "sim_frames.h"
+#include "sim_bus.h"
+#include "charge_session.h"
+
+#define SAMPLE_MS   500
+
+// 每个测试独立的模拟芯片和采样流水线，顺序同main.cpp：能量积分→事件分发→会话统计
+struct SessionBench {
+    SW3538SimBus chip;
+    SW3538Sim driver;
+    EnergyMeter meter;
+    SW3538EventBus events;
+    ChargeSessionTracker sessions;
+
+    SessionBench() : driver(SW3538_DEFAULT_ADDRESS, chip) {
+        chip.setNoise(0);
+        meter.setCheckpointInterval(0);
+        sessions.begin(events, meter);
+        driver.begin();
+    }
+
+    // 采样一次，返回采样时间（读取本身也推进虚拟时钟）
+    uint32_t step(const SW3538_RawFrame& frame) {
+        chip.setFrame(frame);
+        CHECK(driver.readAllData());
+        uint32_t now = millis();
+        meter.update(now, driver.data);
+        events.process(driver.data);
+        sessions.update(now, driver.data);
+        hostAdvanceUs(SAMPLE_MS * 1000UL);
+        return now;
+    }
+};
+
+static SW3538_RawFrame fastFrame(uint16_t currentMA, uint16_t voutMV) {
+    SW3538_RawFrame f = makeFrame(currentMA, voutMV);
+    f.fastCharge = 0x80 | (2 << 4) | SW3538_FC_PD_FIX;     // 快充中、PD3.0、PD固定电压
+    return f;
+}
+
+// 通路2单独接入
+static SW3538_RawFrame path2Frame(uint16_t currentMA) {
+    SW3538_RawFrame f = makeFrame(0);
+    f.status0 = 0x02;
+    f.status1 = 0x01;
+    f.adc[SW3538_RAW_IBUS2] = (uint16_t)(currentMA / 2.5f);
+    return f;
+}
+
+// 一次插拔：5V起步，握手后9V快充；能量与按相同采样点的梯形积分一致
+HOST_TEST(session_start_end_and_energy) {
+    SessionBench b;
+    for (uint8_t i = 0; i < 10; i++) b.step(makeFrame(0));
+    CHECK(b.sessions.count() == 0);
+
+    uint32_t t0 = 0, tFast = 0, tLast = 0, t = 0;
+    double expectedmWms = 0.0;       // mW·ms
+    double lastPowermW = 0.0;
+    for (uint16_t i = 0; i < 120; i++) {
+        bool fast = i >= 40;
+        double powermW = fast ? 9.0 * 2000 : 5.0 * 1000;
+        t = b.step(fast ? fastFrame(2000, 9000) : makeFrame(1000, 5000));
+        if (i > 0) expectedmWms += (lastPowermW + powermW) / 2.0 * (t - tLast);
+        lastPowermW = powermW;
+        tLast = t;
+        if (i == 40) tFast = t;
+        if (i == 0) {
+            t0 = t;
+            const ChargeSession* s = b.sessions.getActive(1);
+            CHECK(s != nullptr && s->active && s->startMs == t0);
+            CHECK(b.sessions.getActive(2) == nullptr);
+        }
+    }
+    uint32_t t1 = b.step(makeFrame(0));
+    expectedmWms += lastPowermW / 2.0 * (t1 - tLast);   // 拔出采样电流为0
+    for (uint8_t i = 0; i < 10; i++) b.step(makeFrame(0));
+
+    CHECK(b.sessions.count() == 1);
+    CHECK(b.sessions.getActive(1) == nullptr);
+    const ChargeSession& s = b.sessions.get(0);
+    CHECK(!s.active);
+    CHECK(s.path == 1);
+    CHECK(s.startMs == t0);
+    CHECK(s.endMs == t1);
+    CHECK(s.durationMs() > 120UL * SAMPLE_MS);
+    CHECK(s.samples == 120);
+    CHECK(s.peakPowermW == 18000);
+    // 快充状态从第41个采样起计，至拔出前最后一个采样
+    CHECK(s.fastChargeMs == tLast - tFast);
+    CHECK_NEAR(s.energymWh(), expectedmWms / 3600000.0, expectedmWms / 3600000.0 * 0.001);
+    CHECK_NEAR(s.averagePowerW(), expectedmWms / s.durationMs() / 1000.0, 0.01);
+
+    // 时间线：接入时无协议，握手后PD固定电压
+    CHECK(s.timelineCount == 2);
+    CHECK(s.timeline[0].offsetMs == 0 && s.timeline[0].protocol == SW3538_FC_NONE);
+    CHECK(s.timeline[1].offsetMs == tFast - t0);
+    CHECK(s.timeline[1].protocol == SW3538_FC_PD_FIX && s.timeline[1].pdVersion == 2);
+
+    CapturePrint out;
+    b.sessions.printSessions(out);
+    CHECK(out.contains("P1   6"));
+    CHECK(out.contains("peak:18.0W"));
+    CHECK(out.contains("PD"));
+}
+
+// 两路独立计时计能；会话表满后覆盖最旧会话
+HOST_TEST(session_paths_independent_and_ring_wraps) {
+    SessionBench b;
+    b.step(makeFrame(0));
+    uint32_t t0 = b.step(path2Frame(1500));
+    for (uint8_t i = 1; i < 20; i++) b.step(path2Frame(1500));
+    uint32_t t1 = b.step(makeFrame(0));
+    CHECK(b.sessions.count() == 1);
+    const ChargeSession& p2 = b.sessions.get(0);
+    CHECK(p2.path == 2 && !p2.active);
+    CHECK(p2.durationMs() == t1 - t0);
+    CHECK(p2.peakPowermW == 7500);
+    // 恒定功率，拔出的一段按梯形取一半
+    CHECK(b.meter.getCounter(1, false).energy2nJ == 0);
+    double lastDt = (t1 - t0) / 20.0;
+    CHECK_NEAR(p2.energymWh(), 7500.0 * (t1 - t0 - lastDt / 2) / 3600000.0, 0.01);
+
+    uint32_t firstStart = 0;
+    for (uint8_t k = 0; k < CHARGE_SESSION_MAX + 3; k++) {
+        uint32_t start = b.step(makeFrame(1000));
+        if (k == 3) firstStart = start;
+        for (uint8_t i = 1; i < 4; i++) b.step(makeFrame(1000));
+        b.step(makeFrame(0));
+    }
+    // 通路2会话和最早的2次通路1会话被覆盖
+    CHECK(b.sessions.count() == CHARGE_SESSION_MAX);
+    CHECK(b.sessions.get(0).startMs == firstStart);
+    for (size_t i = 0; i < b.sessions.count(); i++) {
+        CHECK(b.sessions.get(i).path == 1);
+        CHECK(b.sessions.get(i).samples == 4);
+        if (i > 0) CHECK(b.sessions.get(i).startMs > b.sessions.get(i - 1).startMs);
+    }
+}
@@ -0,0 +1,45 @@
+/*
+ * test_display.cpp - 屏幕开关后的曲线屏重绘
+ */
+
+#include "host_test.h"
+#include "sim_frames.h"
+#include "display.h"
+#include "history_graph.h"
+#include <string.h>
+
+static void showScreen(DisplayScreen screen) {
+    while (getCurrentScreen() != screen) nextScreen();
+}
+
+// 关屏期间采样继续推进曲线；重新亮屏时显存已清空，必须整屏重绘而非增量滚动
+HOST_TEST(display_graph_full_redraw_after_screen_on) {
+    SW3538_Data_t data;
+    initOled();
+    showScreen(SCREEN_GRAPH);
+
+    for (uint16_t i = 0; i < 40; i++) {
+        SW3538::decodeRawFrame(makeFrame(500 + i * 50), data);
+        historyGraph.push(data);
+        publishSW3538Data(data);
+        displaySw3538Data();
+    }
+    CHECK(getLastDisplayUpdateBytes() < 1024);   // 亮屏时为增量刷新
+
+    turnOffOled();
+    for (uint16_t i = 0; i < 3; i++) {
+        SW3538::decodeRawFrame(makeFrame(3000 - i * 100), data);
+        historyGraph.push(data);
+        publishSW3538Data(data);
+    }
+    turnOnOled();
+    CHECK(getLastDisplayUpdateBytes() == 1024);
+
+    // 亮屏后的显存与从头整屏绘制一致
+    static uint8_t shown[1024];
+    memcpy(shown, u8g2.getBufferPtr(), sizeof(shown));
+    historyGraph.renderFull();
+    CHECK(memcmp(shown, u8g2.getBufferPtr(), sizeof(shown)) == 0);
+
+    showScreen(SCREEN_DATA);
+}
@@ -0,0 +1,84 @@
+/*
+ * test_energy_meter.cpp - 梯形积分误差上界（可变采样间隔）
+ */
+
+#include "host_test.h"
+#include "energy_meter.h"
+
+#define PI_D 3.14159265358979323846
+
+static SW3538_Data_t sample(int16_t i1mA, uint16_t voutMV) {
+    SW3538_Data_t d = {};
+    d.currentPath1mA = i1mA;
+    d.outputVoltagemV = voutMV;
+    return d;
+}
+
+// 线性变化的电流：梯形积分精确（整数读数时无舍入）
+HOST_TEST(energy_linear_ramp_is_exact) {
+    EnergyMeter meter;
+    meter.setCheckpointInterval(0);
+    uint32_t t = 0;
+    uint32_t steps[] = { 200, 1000, 5000, 300, 2600 };
+    for (uint32_t k = 0; k <= 500; k++) {
+        // I = 100 + t/100 mA（t为ms，步长取100ms的倍数使读数为整数）
+        meter.update(t, sample((int16_t)(100 + t / 100), 5000));
+        t += steps[k % 5];
+    }
+    t -= steps[500 % 5];
+    // ∫(100 + t/100)dt = 100t + t²/200，单位mA·ms
+    double exactUC = 100.0 * t + (double)t * t / 200.0;
+    CHECK_NEAR(meter.getCounter(1).charge2uC / 2.0, exactUC, 0.5);
+    CHECK_NEAR(meter.getCounter(1).energy2nJ / 2.0, exactUC * 5000.0, 5000.0);
+}
+
+// 正弦电流、200ms-5s随机间隔：误差不超过梯形公式上界 + 读数量化
+HOST_TEST(energy_sine_within_trapezoid_bound) {
+    EnergyMeter meter;
+    meter.setCheckpointInterval(0);
+    const double periodMs = 60000.0;
+    const double amp = 500.0;
+    const double w = 2.0 * PI_D / periodMs;
+    const uint16_t vout = 9000;
+
+    uint32_t rng = 12345;
+    uint32_t t = 0;
+    double bound = 0.0;
+    const double maxI2 = amp * w * w;       // |I''|上限
+    const uint32_t endMs = 3600000;
+
+    while (true) {
+        double i = 1000.0 + amp * sin(w * t);
+        meter.update(t, sample((int16_t)lround(i), vout));
+        rng = rng * 1103515245u + 12345u;
+        uint32_t h = 200 + (rng >> 8) % 4801;
+        if (t + h > endMs) break;
+        // 梯形公式单段误差 h³/12·max|f''|，读数四舍五入带来 0.5mA·h
+        bound += (double)h * h * h / 12.0 * maxI2 + 0.5 * h;
+        t += h;
+    }
+
+    double exactUC = 1000.0 * t + amp / w * (1.0 - cos(w * t));
+    double gotUC = meter.getCounter(1).charge2uC / 2.0;
+    CHECK_NEAR(gotUC, exactUC, bound);
+    // 相对误差小于0.1%
+    CHECK(fabs(gotUC - exactUC) < exactUC * 1e-3);
+    CHECK_NEAR(meter.getChargemAh(1), exactUC / 3.6e6, exactUC / 3.6e6 * 1e-3);
+    CHECK_NEAR(meter.getEnergymWh(1), exactUC * vout / 3.6e9, exactUC * vout / 3.6e9 * 1e-3);
+    CHECK(meter.getSkippedGaps() == 0);
+}
+
+HOST_TEST(energy_skips_long_gaps) {
+    EnergyMeter meter;
+    meter.setCheckpointInterval(0);
+    meter.setMaxGap(10000);
+    meter.update(0, sample(1000, 5000));
+    meter.update(1000, sample(1000, 5000));
+    meter.update(61000, sample(1000, 5000));       // 60秒间隔不外推
+    meter.update(62000, sample(1000, 5000));
+    CHECK(meter.getSkippedGaps() == 1);
+    CHECK(meter.getCounter(1).charge2uC == 2 * 2000LL * 1000);
+    meter.resetSession();
+    CHECK(meter.getCounter(1).charge2uC == 0);
+    CHECK(meter.getCounter(1, false).charge2uC == 2 * 2000LL * 1000);
+}
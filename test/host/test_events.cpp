@@ -0,0 +1,62 @@
+/*
+ * test_events.cpp - 事件总线：阈值事件的前后值
+ */
+
+#include "host_test.h"
+#include "sw3538_events.h"
+
+static SW3538_Event lastEvent;
+static unsigned eventCount;
+
+static void onEvent(const SW3538_Event& evt, void*) {
+    lastEvent = evt;
+    eventCount++;
+}
+
+HOST_TEST(events_current_threshold_reports_readings) {
+    SW3538EventBus bus;
+    bus.setCurrentThreshold(1000, 100);
+    bus.subscribe(SW3538_EVT_MASK(SW3538_EVT_CURRENT_ABOVE) | SW3538_EVT_MASK(SW3538_EVT_CURRENT_BELOW), onEvent);
+
+    SW3538_Data_t d = {};
+    d.ntcTemperatureC = 25;
+    d.currentPath1mA = 600;
+    bus.process(d);
+    CHECK(eventCount == 0);
+
+    d.currentPath1mA = 1500;
+    bus.process(d);
+    CHECK(eventCount == 1);
+    CHECK(lastEvent.type == SW3538_EVT_CURRENT_ABOVE);
+    CHECK(lastEvent.path == 1);
+    CHECK(lastEvent.oldValue == 600);
+    CHECK(lastEvent.newValue == 1500);
+
+    // 回差内不触发
+    d.currentPath1mA = 950;
+    bus.process(d);
+    CHECK(eventCount == 1);
+
+    d.currentPath1mA = 850;
+    bus.process(d);
+    CHECK(eventCount == 2);
+    CHECK(lastEvent.type == SW3538_EVT_CURRENT_BELOW);
+    CHECK(lastEvent.oldValue == 950);
+    CHECK(lastEvent.newValue == 850);
+}
+
+HOST_TEST(events_over_temp_reports_readings) {
+    SW3538EventBus bus;
+    bus.setOverTempThreshold(60, 5);
+    bus.subscribe(SW3538_EVT_MASK(SW3538_EVT_OVER_TEMP), onEvent);
+    eventCount = 0;
+
+    SW3538_Data_t d = {};
+    d.ntcTemperatureC = 55;
+    bus.process(d);
+    d.ntcTemperatureC = 62;
+    bus.process(d);
+    CHECK(eventCount == 1);
+    CHECK(lastEvent.oldValue == 55);
+    CHECK(lastEvent.newValue == 62);
+}
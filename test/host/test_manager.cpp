@@ -0,0 +1,128 @@
+/*
+ * test_manager.cpp - 多芯片管理器：静默发现、快慢端口调度、总线预算
+ */
+
+#include <stdio.h>
+#include <Wire.h>
+#include "host_test.h"
+#include "sim_frames.h"
+#include "sim_bus.h"
+#include "sw3538_manager.h"
+
+#define CHIPS       9       // 多于SW3538_MAX_DEVICES，验证设备表上限
+#define FIRST_ADDR  0x10
+#define BUSY_CHIPS  2
+
+// 每个测试独立的芯片、总线和管理器，不依赖执行顺序
+struct ManagerBench {
+    SW3538SimBus chips[CHIPS];
+    TwoWire bus;
+    SW3538Manager manager;
+    uint32_t readUs[SW3538_MAX_DEVICES];
+
+    ManagerBench() : readUs() {
+        bus.setClock(400000);
+        for (uint8_t i = 0; i < CHIPS; i++) {
+            chips[i] = SW3538SimBus(FIRST_ADDR + i);
+            chips[i].setFrame(makeFrame(0));
+            bus.attach(chips[i]);
+        }
+    }
+};
+
+static void onSample(uint8_t index, SW3538Device& device, void* ctx) {
+    static_cast<ManagerBench*>(ctx)->readUs[index] += device.lastReadUs;
+}
+
+HOST_TEST(manager_discover_is_quiet) {
+    ManagerBench b;
+
+    uint32_t before = hostSerialBytes();
+    uint8_t added = b.manager.discover(b.bus);
+    uint32_t printed = hostSerialBytes() - before;
+
+    CHECK(added == SW3538_MAX_DEVICES);
+    CHECK(b.manager.getDeviceCount() == SW3538_MAX_DEVICES);
+    CHECK(b.manager.getDevice(0).driver.getAddress() == FIRST_ADDR);
+    // 开启SW3538_DEBUG时也只允许一行汇总，不能逐地址打印
+    CHECK(printed < 32);
+    // 再次发现不会重复添加
+    CHECK(b.manager.discover(b.bus) == 0);
+}
+
+HOST_TEST(manager_busy_ports_sampled_faster) {
+    ManagerBench b;
+    CHECK(b.manager.discover(b.bus) == SW3538_MAX_DEVICES);
+    b.manager.setSampleCallback(onSample, &b);
+    b.manager.setBusBudget(500000, 1000);   // 每秒最多500ms总线时间
+    b.manager.begin();
+
+    const uint32_t runMs = 30000;
+    uint32_t start = millis();
+    uint32_t nextFrame = start;
+    uint16_t step = 0;
+    while (millis() - start < runMs) {
+        // 忙碌端口电流持续变化，空闲端口恒为0
+        if ((int32_t)(millis() - nextFrame) >= 0) {
+            nextFrame += 100;
+            step++;
+            for (uint8_t i = 0; i < BUSY_CHIPS; i++) {
+                b.chips[i].setFrame(makeFrame(1000 + (step % 20) * 100, 9000));
+            }
+        }
+        if (b.manager.poll() < 0) hostAdvanceUs(1000);
+    }
+
+    uint32_t busy = b.manager.getDevice(0).samples;
+    uint32_t idle = b.manager.getDevice(BUSY_CHIPS).samples;
+    CHECK(busy > 4 * idle);
+    CHECK(b.manager.getDevice(0).scan.getCurrentInterval() < b.manager.getDevice(BUSY_CHIPS).scan.getCurrentInterval());
+    for (uint8_t i = 0; i < SW3538_MAX_DEVICES; i++) {
+        CHECK(b.manager.getDevice(i).failures == 0);
+        CHECK(b.manager.getDevice(i).samples > 0);
+    }
+
+    // 预算：总线时间不超过每窗口预算，允许每窗口超出最后一次读取
+    uint32_t totalUs = 0, maxReadUs = 0;
+    for (uint8_t i = 0; i < SW3538_MAX_DEVICES; i++) {
+        totalUs += b.readUs[i];
+        if (b.manager.getDevice(i).lastReadUs > maxReadUs) maxReadUs = b.manager.getDevice(i).lastReadUs;
+    }
+    CHECK(maxReadUs > 0);
+    CHECK(b.manager.getBudgetSkips() > 0);
+    CHECK(totalUs <= 30UL * (500000 + maxReadUs));
+
+    // 总吞吐：全部设备的采样率和总线占用
+    uint32_t total = b.manager.getTotalSamples();
+    printf("  %u devices: %lu samples in %lus = %.1f samples/s (busy %.1f/s, idle %.1f/s), "
+           "bus %.1f%%, %lu budget skips\n",
+           (unsigned)b.manager.getDeviceCount(), (unsigned long)total, (unsigned long)(runMs / 1000),
+           total * 1000.0 / runMs, busy * 1000.0 / runMs, idle * 1000.0 / runMs,
+           totalUs / (runMs * 10.0), (unsigned long)b.manager.getBudgetSkips());
+}
+
+// 电流读数无效时保持的旧值不参与自适应调速
+HOST_TEST(manager_invalid_currents_do_not_steer_scan) {
+    ManagerBench b;
+    CHECK(b.manager.discover(b.bus) == SW3538_MAX_DEVICES);
+    b.manager.begin();
+    uint32_t fastest = b.manager.getDevice(0).scan.getCurrentInterval();
+
+    // 设备0的ADC高字节持续出错，设备1读数正常且恒定
+    b.chips[0].setFrame(makeFrame(1500, 9000));
+    b.chips[0].setGlitchTargets(SIM_GLITCH_ADC_HIGH);
+    b.chips[0].setFaults(0, 1000);
+    b.chips[1].setFrame(makeFrame(1500, 9000));
+
+    uint32_t start = millis();
+    while (millis() - start < 10000) {
+        if (b.manager.poll() < 0) hostAdvanceUs(1000);
+    }
+
+    const SW3538Device& bad = b.manager.getDevice(0);
+    const SW3538Device& good = b.manager.getDevice(1);
+    CHECK(bad.samples > 0);
+    CHECK((bad.driver.data.validMask & SW3538_VALID_CURRENTS) == 0);
+    CHECK(bad.scan.getCurrentInterval() == fastest);
+    CHECK(good.scan.getCurrentInterval() > fastest);
+}
@@ -0,0 +1,124 @@
+/*
+ * test_packed_sample.cpp - 打包格式往返：驱动可解码出的全部取值无损，超量程饱和
+ */
+
+#include "host_test.h"
+#include "sim_frames.h"
+#include "packed_sample.h"
+
+// 打包保存的字段（芯片版本、最大功率、有效位、时间不打包）
+static bool samePacked(const SW3538_Data_t& a, const SW3538_Data_t& b) {
+    return a.inputVoltagemV == b.inputVoltagemV &&
+           a.outputVoltagemV == b.outputVoltagemV &&
+           a.currentPath1mA == b.currentPath1mA &&
+           a.currentPath2mA == b.currentPath2mA &&
+           a.ntcTemperatureC == b.ntcTemperatureC &&
+           a.pdVersion == b.pdVersion &&
+           a.fastChargeProtocol == b.fastChargeProtocol &&
+           a.fastChargeStatus == b.fastChargeStatus &&
+           a.path1Online == b.path1Online &&
+           a.path2Online == b.path2Online &&
+           a.path1BuckStatus == b.path1BuckStatus &&
+           a.path2BuckStatus == b.path2BuckStatus;
+}
+
+// 解码原始帧后打包再解包，返回是否无损
+static bool roundTrips(const SW3538_RawFrame& raw) {
+    SW3538_Data_t decoded, unpacked;
+    PackedSample p;
+    SW3538::decodeRawFrame(raw, decoded);
+    packSample(decoded, 200, p);
+    return unpackSample(p, unpacked) && samePacked(decoded, unpacked) && packedSampleDtMs(p) == 200;
+}
+
+// 每个ADC通道遍历完整位宽（VOUT 15位，其余12位）
+HOST_TEST(packed_adc_full_range_round_trip) {
+    static const uint16_t widths[SW3538_RAW_ADC_COUNT] = { 4096, 4096, 4096, 32768, 4096 };
+    uint32_t bad = 0;
+    for (uint8_t ch = 0; ch < SW3538_RAW_ADC_COUNT; ch++) {
+        SW3538_RawFrame raw = makeFrame(1000);
+        for (uint32_t v = 0; v < widths[ch]; v++) {
+            raw.adc[ch] = (uint16_t)v;
+            if (!roundTrips(raw)) bad++;
+        }
+        // NTC两档电流源换算不同
+        if (ch == SW3538_RAW_NTC) {
+            raw.ntcState ^= 0x80;
+            for (uint32_t v = 0; v < widths[ch]; v++) {
+                raw.adc[ch] = (uint16_t)v;
+                if (!roundTrips(raw)) bad++;
+            }
+        }
+    }
+    CHECK(bad == 0);
+}
+
+// 状态寄存器逐个遍历0~255
+HOST_TEST(packed_state_registers_round_trip) {
+    uint32_t bad = 0;
+    for (uint16_t v = 0; v < 256; v++) {
+        SW3538_RawFrame raw = makeFrame(1000);
+        raw.fastCharge = (uint8_t)v;
+        if (!roundTrips(raw)) bad++;
+        raw = makeFrame(1000);
+        raw.status0 = (uint8_t)v;
+        if (!roundTrips(raw)) bad++;
+        raw = makeFrame(1000);
+        raw.status1 = (uint8_t)v;
+        if (!roundTrips(raw)) bad++;
+    }
+    CHECK(bad == 0);
+}
+
+// 随机整帧（各寄存器和ADC同时变化）
+HOST_TEST(packed_random_frames_round_trip) {
+    uint32_t rng = 12345, bad = 0;
+    for (uint32_t i = 0; i < 20000; i++) {
+        SW3538_RawFrame raw;
+        uint8_t* bytes = (uint8_t*)&raw;
+        for (uint8_t b = 0; b < sizeof(raw); b++) {
+            rng = rng * 1664525UL + 1013904223UL;
+            bytes[b] = (uint8_t)(rng >> 24);
+        }
+        if (raw.version == 0xFF && raw.maxPower == 0xFF) raw.version = 0x01;  // 解码拒绝的帧
+        raw.adc[SW3538_RAW_VOUT] &= 0x7FFF;
+        for (uint8_t ch = 0; ch < SW3538_RAW_ADC_COUNT; ch++) {
+            if (ch != SW3538_RAW_VOUT) raw.adc[ch] &= 0x0FFF;
+        }
+        if (!roundTrips(raw)) bad++;
+    }
+    CHECK(bad == 0);
+}
+
+// 超量程饱和、温度无效值、时间差饱和、版本不符拒绝
+HOST_TEST(packed_saturation_and_version) {
+    SW3538_Data_t d = {}, out;
+    PackedSample p;
+
+    d.currentPath1mA = -5;
+    d.currentPath2mA = 20000;
+    d.outputVoltagemV = 40000;
+    d.inputVoltagemV = 65535;
+    d.ntcTemperatureC = -999;
+    packSample(d, 70000, p);
+    CHECK(unpackSample(p, out));
+    CHECK(out.currentPath1mA == 0);
+    CHECK(out.currentPath2mA == PACKED_SAMPLE_CURRENT_MAX);
+    CHECK(out.outputVoltagemV == PACKED_SAMPLE_VOUT_MAX);
+    CHECK(out.inputVoltagemV == PACKED_SAMPLE_VIN_MAX * 10);
+    CHECK(out.ntcTemperatureC == -999);
+    CHECK(packedSampleDtMs(p) == PACKED_SAMPLE_DT_MAX);
+
+    d.ntcTemperatureC = -100;
+    packSample(d, 0, p);
+    unpackSample(p, out);
+    CHECK(out.ntcTemperatureC == 1 - PACKED_SAMPLE_TEMP_OFFSET);
+    d.ntcTemperatureC = 500;
+    packSample(d, 0, p);
+    unpackSample(p, out);
+    CHECK(out.ntcTemperatureC == 255 - PACKED_SAMPLE_TEMP_OFFSET);
+
+    CHECK(packedSampleVersion(p) == PACKED_SAMPLE_VERSION);
+    p.w[1] = (p.w[1] & 0x0FFFFFFFUL) | ((uint32_t)(PACKED_SAMPLE_VERSION + 1) << 28);
+    CHECK(!unpackSample(p, out));
+}
@@ -0,0 +1,146 @@
+/*
+ * test_param_registry.cpp - 参数注册表：命令解析、范围和约束检查、保存加载、单字符命令
+ */
+
+#include "host_test.h"
+#include "capture_print.h"
+#include "param_registry.h"
+#include "SW3538.h"
+#include "report_builder.h"
+
+#define PARAM_FILE "params_test.bin"
+
+// 按行送入CommandLine，返回最后一行（逐字符，模拟串口）
+static const char* feedLine(CommandLine& cl, const char* s) {
+    const char* line = nullptr;
+    while (*s) line = cl.feed(*s++);
+    return line;
+}
+
+HOST_TEST(param_command_line_parse) {
+    CommandLine cl;
+    CHECK(feedLine(cl, "  set scan.eps 80 ") == nullptr);
+    const char* line = cl.feed('\n');
+    CHECK(line != nullptr && strcmp(line, "set scan.eps 80") == 0);
+    CHECK(feedLine(cl, "\r\n") == nullptr);            // 空行忽略
+
+    // 超长行整行丢弃，下一行正常
+    char longLine[PARAM_LINE_BYTES + 8];
+    memset(longLine, 'x', sizeof(longLine) - 1);
+    longLine[sizeof(longLine) - 1] = '\0';
+    feedLine(cl, longLine);
+    CHECK(cl.feed('\n') == nullptr);
+    line = feedLine(cl, "list\n");
+    CHECK(line != nullptr && strcmp(line, "list") == 0);
+
+    ParamRegistry reg;
+    CapturePrint out;
+    CHECK(reg.handleCommand("set scan.eps 80", out));
+    CHECK(reg.get(PARAM_SCAN_EPSILON_MA) == 80);
+    CHECK(out.contains("scan.eps"));
+    CHECK(reg.handleCommand("set i2c.clock 0x61A80", out));   // strtoul按前缀识别进制
+    CHECK(reg.get(PARAM_I2C_CLOCK_HZ) == 400000);
+    out.clear();
+    CHECK(reg.handleCommand("get nosuch", out));
+    CHECK(out.contains("unknown"));
+    CHECK(!reg.handleCommand("d", out));               // 非参数命令交给调用者
+    CHECK(!reg.handleCommand("format", out));
+}
+
+HOST_TEST(param_rejects_out_of_range_and_conflicts) {
+    ParamRegistry reg;
+    CapturePrint out;
+    uint16_t version = reg.getVersion();
+
+    CHECK(!reg.set(PARAM_SCAN_EPSILON_MA, 0));
+    CHECK(!reg.set(PARAM_ADC_OVERSAMPLE, SW3538_OVERSAMPLE_MAX_BITS + 1));
+    CHECK(reg.handleCommand("set scan.eps 9999", out));
+    CHECK(out.contains("invalid value"));
+    out.clear();
+    CHECK(reg.handleCommand("set scan.eps 12abc", out));
+    CHECK(out.contains("invalid value"));
+    CHECK(reg.get(PARAM_SCAN_EPSILON_MA) == ParamRegistry::desc(PARAM_SCAN_EPSILON_MA).def);
+    CHECK(reg.getVersion() == version);
+
+    // 各自在范围内，但scan.min > scan.max
+    CHECK(!reg.set(PARAM_SCAN_MIN_MS, 6000));
+    CHECK(!reg.set(PARAM_SCAN_MAX_MS, 100));
+    out.clear();
+    CHECK(reg.handleCommand("set scan.min 6000", out));
+    CHECK(out.contains("conflicts"));
+    CHECK(reg.get(PARAM_SCAN_MIN_MS) == 200);
+    CHECK(reg.getVersion() == version);
+
+    // 先放宽上限再提高下限
+    CHECK(reg.set(PARAM_SCAN_MAX_MS, 20000));
+    CHECK(reg.set(PARAM_SCAN_MIN_MS, 6000));
+    CHECK(reg.set(PARAM_SCAN_MIN_MS, 20000));         // 相等允许
+
+    // 逐个恢复会先得到min=200 > max=150，整体恢复不受影响
+    CHECK(reg.set(PARAM_SCAN_MIN_MS, 10));
+    CHECK(reg.set(PARAM_SCAN_MAX_MS, 150));
+    reg.resetDefaults();
+    CHECK(reg.get(PARAM_SCAN_MIN_MS) == 200);
+    CHECK(reg.get(PARAM_SCAN_MAX_MS) == 5000);
+}
+
+static uint8_t changes;
+static void onChange(ParamId, uint32_t, void*) { changes++; }
+
+HOST_TEST(param_save_load_round_trip) {
+    remove(PARAM_FILE);
+    ParamRegistry a;
+    CHECK(!a.begin(PARAM_FILE));                        // 没有保存过
+    CHECK(a.set(PARAM_SCAN_MAX_MS, 30000));
+    CHECK(a.set(PARAM_SCAN_MIN_MS, 10000));
+    CHECK(a.set(PARAM_REPORT_CHANGES, !REPORT_CHANGES_ONLY));
+    CHECK(a.set(PARAM_SCREEN_OFF_MS, 120000));
+    CHECK(a.save());
+
+    ParamRegistry b;
+    CHECK(b.begin(PARAM_FILE));
+    for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+        CHECK(b.get((ParamId)i) == a.get((ParamId)i));
+    }
+    changes = 0;
+    b.setCallback(onChange);
+    b.applyAll();
+    CHECK(changes == PARAM_COUNT);
+
+    // 存储中违反约束的组合（旧版本或手工改写）恢复默认值
+    FILE* f = fopen(PARAM_FILE, "r+b");
+    CHECK(f != nullptr);
+    uint32_t badMin = 50000;
+    fseek(f, 4 + PARAM_SCAN_MIN_MS * sizeof(uint32_t), SEEK_SET);
+    fwrite(&badMin, sizeof(badMin), 1, f);
+    fclose(f);
+    ParamRegistry c;
+    CHECK(c.begin(PARAM_FILE));
+    CHECK(c.get(PARAM_SCAN_MIN_MS) == 200);
+    CHECK(c.get(PARAM_SCAN_MAX_MS) == 5000);
+    CHECK(c.get(PARAM_SCREEN_OFF_MS) == 120000);
+    remove(PARAM_FILE);
+}
+
+// 单字符命令不带换行：空闲超时后返回；多字符命令不受影响
+HOST_TEST(param_single_key_without_newline) {
+    CommandLine cl;
+    CHECK(cl.feed('e') == nullptr);
+    CHECK(cl.idle() == nullptr);
+    hostAdvanceUs(PARAM_KEY_IDLE_MS * 1000UL);
+    const char* key = cl.idle();
+    CHECK(key != nullptr && strcmp(key, "e") == 0);
+    CHECK(cl.idle() == nullptr);
+    CHECK(cl.feed('\n') == nullptr);                   // 已执行，随后的换行不再重复
+
+    feedLine(cl, "li");
+    hostAdvanceUs(PARAM_KEY_IDLE_MS * 1000UL);
+    CHECK(cl.idle() == nullptr);
+    const char* line = feedLine(cl, "st\n");
+    CHECK(line != nullptr && strcmp(line, "list") == 0);
+
+    // 带换行的单字符命令照常按行返回
+    line = feedLine(cl, "d\n");
+    CHECK(line != nullptr && strcmp(line, "d") == 0);
+    CHECK(cl.idle() == nullptr);
+}
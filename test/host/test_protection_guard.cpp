@@ -0,0 +1,160 @@
+/*
+ * test_protection_guard.cpp - 守护检测延迟：模拟总线上的斜坡电流
+ *
+ * 模拟主循环：每200ms一次readAllData()+update()，其余时间调用service()，
+ * 每轮循环另有LOOP_WORK_US的其它工作。电流按斜坡越过限值，
+ * 检测延迟 = 回调时刻 - 斜坡解析越限时刻
+ */
+
+#include <Wire.h>
+#include "host_test.h"
+#include "sim_frames.h"
+#include "sim_bus.h"
+#include "protection_guard.h"
+
+#define GUARD_ADDR      0x3C
+#define LIMIT_MA        3300
+#define MARGIN_MA       300
+#define PERIOD_US       10000
+#define SCAN_MS         200
+#define LOOP_WORK_US    500
+#define RAMP_MA_PER_S   1000    // 裕量300mA用时300ms，大于扫描间隔，越限前必已进入守护
+
+static SW3538SimBus chip(GUARD_ADDR);
+static TwoWire guardBus;
+static SW3538 driver(GUARD_ADDR, guardBus);
+
+static bool tripped;
+static uint32_t tripUs;
+
+static void onTrip(GuardChannel ch, float, uint32_t, void*) {
+    if (ch == GUARD_CURRENT1) {
+        tripped = true;
+        tripUs = micros();
+    }
+}
+
+// 斜坡起点之前恒为2500mA，之后按RAMP_MA_PER_S上升
+static uint16_t rampCurrent(uint32_t nowUs, uint32_t startUs) {
+    if ((int32_t)(nowUs - startUs) < 0) return 2500;
+    uint32_t ma = 2500 + (uint64_t)(nowUs - startUs) * RAMP_MA_PER_S / 1000000UL;
+    return ma > 4000 ? 4000 : (uint16_t)ma;
+}
+
+static uint32_t measure(bool (*fn)()) {
+    uint32_t t0 = micros();
+    fn();
+    return micros() - t0;
+}
+
+static bool doReadAll() { return driver.readAllData(); }
+static bool doRearm() { driver.endFastRead(); return driver.beginFastRead(SW3538_ADC_CH_IBUS1); }
+static bool doFastRead() { uint16_t raw; return driver.readFast(raw); }
+
+HOST_TEST(guard_latency_bound_with_full_scans) {
+    guardBus.setClock(100000);      // 驱动默认时钟
+    guardBus.attach(chip);
+    chip.setFrame(makeFrame(2500, 9000));
+    driver.begin();
+
+    // 各环节耗时（模拟总线100kHz，含ADC转换等待）
+    uint32_t readAllUs = measure(doReadAll);
+    uint32_t rearmUs = measure(doRearm);
+    uint32_t fastUs = measure(doFastRead);
+    driver.endFastRead();
+    CHECK(readAllUs > 20000);
+
+    // 上界：守护周期 + 一次完整扫描 + 重新选通 + 两次快速读取（越限确认） + 一轮循环的其它工作
+    const uint32_t boundUs = PERIOD_US + readAllUs + rearmUs + 2 * fastUs + LOOP_WORK_US;
+    uint32_t worstUs = 0;
+
+    // 越限时刻相对扫描周期的相位逐次错开
+    for (uint32_t trial = 0; trial < 40; trial++) {
+        ProtectionGuard guard;
+        guard.begin(driver);
+        guard.setCurrentLimit(LIMIT_MA, MARGIN_MA);
+        guard.setGuardPeriod(PERIOD_US);
+        guard.setCallback(onTrip);
+        tripped = false;
+
+        uint32_t startUs = micros() + 1000000UL + trial * 4900UL;
+        uint32_t crossUs = startUs + (uint64_t)(LIMIT_MA - 2500) * 1000000UL / RAMP_MA_PER_S;
+        uint32_t nextScanMs = millis();
+
+        while (!tripped && (int32_t)(micros() - crossUs) < 500000) {
+            chip.setFrame(makeFrame(rampCurrent(micros(), startUs), 9000));
+            if ((int32_t)(millis() - nextScanMs) >= 0) {
+                nextScanMs += SCAN_MS;
+                if (driver.readAllData()) guard.update(driver.data);
+            }
+            guard.service();
+            hostAdvanceUs(LOOP_WORK_US);
+        }
+
+        CHECK(tripped);
+        uint32_t latencyUs = (int32_t)(tripUs - crossUs) > 0 ? tripUs - crossUs : 0;
+        if (latencyUs > worstUs) worstUs = latencyUs;
+        CHECK(guard.getLastLatencyUs() <= boundUs);
+        driver.endFastRead();
+    }
+
+    // 最坏情况确实包含一次完整扫描：只按守护周期计算的上界不成立
+    CHECK(worstUs <= boundUs);
+    CHECK(worstUs > PERIOD_US + fastUs + LOOP_WORK_US);
+    printf("  guard worst %.1fms bound %.1fms (readAll %.1fms rearm %.1fms fast %.2fms)\n",
+           worstUs / 1000.0, boundUs / 1000.0, readAllUs / 1000.0, rearmUs / 1000.0, fastUs / 1000.0);
+}
+
+// 快速读取的毛刺不触发：3200mA（原始值0x500）低字节读到0xFF即为3837mA，越过3300mA限值；
+// 高字节0xFF由驱动丢弃。确认读未越限时不判定
+HOST_TEST(guard_ignores_fast_read_glitches) {
+    // 独立的模拟芯片：故障注入的随机序列不受前面测试的影响
+    SW3538SimBus glitchChip(GUARD_ADDR);
+    TwoWire glitchBus;
+    SW3538 glitchDriver(GUARD_ADDR, glitchBus);
+    glitchBus.setClock(100000);
+    glitchBus.attach(glitchChip);
+    glitchChip.setFrame(makeFrame(3200, 9000));
+    glitchDriver.begin();
+
+    ProtectionGuard guard;
+    guard.begin(glitchDriver);
+    guard.setCurrentLimit(LIMIT_MA, MARGIN_MA);
+    guard.setGuardPeriod(PERIOD_US);
+    guard.setCallback(onTrip);
+    tripped = false;
+    CHECK(glitchDriver.readAllData());
+    guard.update(glitchDriver.data);
+    CHECK(guard.getGuardedChannel() == GUARD_CURRENT1);
+
+    // 一次确认只防单次毛刺：确认读也是毛刺的概率为故障率²，5‰下2000个周期期望0.05次
+    glitchChip.setGlitchTargets(SIM_GLITCH_ADC_LOW);
+    glitchChip.setFaults(0, 5);
+    glitchChip.resetStats();
+    for (uint16_t i = 0; i < 2000; i++) {
+        guard.service();
+        hostAdvanceUs(PERIOD_US);
+    }
+    CHECK(glitchChip.getInjectedFaults() > 0);
+    CHECK(guard.getRejected() > 0);
+    CHECK(!tripped);
+
+    glitchChip.setGlitchTargets(SIM_GLITCH_ADC_HIGH);
+    glitchChip.setFaults(0, 1000);
+    for (uint16_t i = 0; i < 100; i++) {
+        guard.service();
+        hostAdvanceUs(PERIOD_US);
+    }
+    CHECK(!tripped);
+
+    // 真实越限照常触发
+    glitchChip.setGlitchTargets(SIM_GLITCH_ALL);
+    glitchChip.setFaults(0, 0);
+    glitchChip.setFrame(makeFrame(3400, 9000));
+    for (uint16_t i = 0; i < 3 && !tripped; i++) {
+        hostAdvanceUs(PERIOD_US);
+        guard.service();
+    }
+    CHECK(tripped);
+    glitchDriver.endFastRead();
+}
@@ -0,0 +1,112 @@
+/*
+ * test_report_builder.cpp - 串口报告：完整模式与原printAllData()格式逐字节一致
+ */
+
+#include "host_test.h"
+#include "capture_print.h"
+#include "sim_frames.h"
+#include "sim_bus.h"
+#include "report_builder.h"
+
+// 原SW3538::printAllData()的输出格式（逐项print），作为对照
+static void legacyPrintAllData(const SW3538_Data_t& data, Print& serial) {
+    serial.println("--- SW3538 ---");
+    serial.print("Version: "); serial.println(data.chipVersion);
+    serial.print("MaxPower: "); serial.print(data.maxPowerW); serial.println("W");
+    serial.print("FastCharger: "); serial.println(data.fastChargeStatus ? "ON" : "OFF");
+    serial.print("Protocol: "); serial.println(SW3538::getProtocolName(data.fastChargeProtocol));
+    serial.print("PD_Version: "); serial.println(data.pdVersion == 1 ? "2.0" : (data.pdVersion == 2 ? "3.0" : "RSV"));
+    serial.print("Path1 Link: "); serial.print(data.path1Online ? "ON" : "OFF");
+    serial.print(" Path1 Buck:"); serial.println(data.path1BuckStatus ? "ON" : "OFF");
+    serial.print("Path2 Link: "); serial.print(data.path2Online ? "ON" : "OFF");
+    serial.print(" Path2 Buck:"); serial.println(data.path2BuckStatus ? "ON" : "OFF");
+    serial.print("Path1 Current: "); serial.print(data.currentPath1mA); serial.println("mA");
+    serial.print("Path2 Current: "); serial.print(data.currentPath2mA); serial.println("mA");
+    serial.print("Input Voltage: "); serial.print(data.inputVoltagemV); serial.println("mV");
+    serial.print("Output Voltage: "); serial.print(data.outputVoltagemV); serial.println("mV");
+    serial.print("Temperature: ");
+    if (data.ntcTemperatureC == -999) {
+        serial.println("N/A");
+    } else {
+        serial.print(data.ntcTemperatureC); serial.println("C");
+    }
+    serial.println("--------------");
+}
+
+static bool sameAsLegacy(SW3538Report& report, const SW3538_Data_t& d) {
+    CapturePrint legacy, built;
+    legacyPrintAllData(d, legacy);
+    size_t n = report.write(built, d, REPORT_FULL);
+    return n == legacy.length() && built.length() == legacy.length() &&
+           memcmp(built.text(), legacy.text(), legacy.length()) == 0 &&
+           memcmp(report.text(), legacy.text(), legacy.length()) == 0;
+}
+
+// 固定帧：输出与原格式的文本逐字节一致
+HOST_TEST(report_full_matches_legacy_fixed_frame) {
+    SW3538_RawFrame raw = makeFrame(1500, 9000);
+    raw.fastCharge = 0x80 | (2 << 4) | SW3538_FC_PD_FIX;
+    SW3538_Data_t d;
+    CHECK(SW3538Sim::decodeRawFrame(raw, d));
+
+    SW3538Report report;
+    CapturePrint out;
+    report.write(out, d, REPORT_FULL);
+    CapturePrint legacy;
+    legacyPrintAllData(d, legacy);
+
+    char expected[320];
+    snprintf(expected, sizeof(expected),
+             "--- SW3538 ---\r\n"
+             "Version: 1\r\n"
+             "MaxPower: %uW\r\n"
+             "FastCharger: ON\r\n"
+             "Protocol: PD-FIX\r\n"
+             "PD_Version: 3.0\r\n"
+             "Path1 Link: ON Path1 Buck:ON\r\n"
+             "Path2 Link: OFF Path2 Buck:OFF\r\n"
+             "Path1 Current: 1500mA\r\n"
+             "Path2 Current: 0mA\r\n"
+             "Input Voltage: %umV\r\n"
+             "Output Voltage: 9000mV\r\n"
+             "Temperature: %dC\r\n"
+             "--------------\r\n",
+             d.maxPowerW, d.inputVoltagemV, d.ntcTemperatureC);
+    CHECK(strcmp(legacy.text(), expected) == 0);
+    CHECK(strcmp(out.text(), expected) == 0);
+    CHECK(out.length() == report.length());
+}
+
+// 逐次变化的数据经同一个构建器（字段缓存复用）：每次都与原格式一致
+HOST_TEST(report_full_matches_legacy_across_changes) {
+    SW3538Report report;
+    SW3538_Data_t d = {};
+    uint32_t seed = 12345;
+    for (uint16_t i = 0; i < 2000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        uint32_t r = seed >> 8;
+        // 大多数采样只变一两个字段，偶尔全部变化
+        switch (r % 8) {
+            case 0: d.currentPath1mA = (int16_t)((r >> 4) % 12000) - 2000; break;
+            case 1: d.currentPath2mA = (int16_t)((r >> 4) % 7000); break;
+            case 2: d.outputVoltagemV = (uint16_t)((r >> 4) % 21000); break;
+            case 3: d.ntcTemperatureC = (r >> 4) % 5 == 0 ? -999 : (int16_t)((r >> 4) % 140) - 20; break;
+            case 4: d.fastChargeProtocol = (SW3538_FastChargeProtocol)((r >> 4) % 17); break;
+            case 5: d.pdVersion = (r >> 4) % 4; d.fastChargeStatus = (r >> 6) & 1; break;
+            case 6:
+                d.path1Online = r & 0x10; d.path1BuckStatus = r & 0x20;
+                d.path2Online = r & 0x40; d.path2BuckStatus = r & 0x80;
+                break;
+            default:
+                d.chipVersion = (r >> 4) % 4;
+                d.maxPowerW = (uint16_t)((r >> 6) % 200);
+                d.inputVoltagemV = (uint16_t)((r >> 4) % 30000);
+                break;
+        }
+        if (!sameAsLegacy(report, d)) {
+            CHECK(false);
+            break;
+        }
+    }
+    CHECK(report.getFormats() < 2000UL * RF_COUNT / 2);   // 未变化的字段不重新格式化
+}
@@ -0,0 +1,114 @@
+/*
+ * test_sample_history.cpp - 多分辨率历史：各级容量、桶统计、区间查询
+ */
+
+#include "host_test.h"
+#include "sample_history.h"
+
+static SampleHistory history;       // 约70KB，静态分配
+#define MAX_POINTS (HISTORY_RAW_LEN + HISTORY_TIER1_LEN)
+static HistoryPoint points[MAX_POINTS];
+
+// 时间比较是回绕安全的（相差不超过2^31ms），查询终点取测试范围之后的时刻
+#define QUERY_END 100000000UL
+
+static void values(uint16_t i, uint16_t out[HISTORY_CH_COUNT]) {
+    out[HISTORY_CH_CURRENT1] = i;
+    out[HISTORY_CH_CURRENT2] = 0;
+    out[HISTORY_CH_VOUT] = 5000;
+    out[HISTORY_CH_VIN] = 20000;
+    out[HISTORY_CH_TEMP] = 25 + 273;
+}
+
+HOST_TEST(history_raw_tier_wraps_and_keeps_times) {
+    history.clear();
+    uint16_t v[HISTORY_CH_COUNT];
+    const uint32_t n = HISTORY_RAW_LEN + 50;
+    for (uint32_t i = 0; i < n; i++) {
+        values(i * 10, v);
+        history.append(1000 + i * 200, v);
+    }
+    CHECK(history.size(HISTORY_TIER_RAW) == HISTORY_RAW_LEN);
+
+    size_t got = history.query(HISTORY_TIER_RAW, 0, QUERY_END, points, MAX_POINTS);
+    CHECK(got == HISTORY_RAW_LEN);
+    // 最旧一条是第50次采样，时间与电流无损
+    CHECK(points[0].timeMs == 1000 + 50 * 200);
+    CHECK(points[0].meanV[HISTORY_CH_CURRENT1] == 500);
+    CHECK(points[got - 1].timeMs == 1000 + (n - 1) * 200);
+    CHECK(points[got - 1].meanV[HISTORY_CH_CURRENT1] == (n - 1) * 10);
+    CHECK(SampleHistory::decodeTemp(points[0].meanV[HISTORY_CH_TEMP]) == 25);
+}
+
+HOST_TEST(history_raw_tier_restarts_after_gap) {
+    history.clear();
+    uint16_t v[HISTORY_CH_COUNT];
+    values(100, v);
+    for (uint32_t i = 0; i < 10; i++) history.append(i * 1000, v);
+    // 间隔超过打包时间差上限，原始级重新开始，聚合级不受影响
+    history.append(9000 + PACKED_SAMPLE_DT_MAX + 1, v);
+    CHECK(history.size(HISTORY_TIER_RAW) == 1);
+    CHECK(history.size(HISTORY_TIER_10S) >= 1);
+}
+
+HOST_TEST(history_aggregate_buckets) {
+    history.clear();
+    uint16_t v[HISTORY_CH_COUNT];
+    // 1秒一次，电流按秒递增，持续10分钟
+    for (uint32_t s = 0; s < 600; s++) {
+        values(s, v);
+        if (s % 7 == 0) v[HISTORY_CH_CURRENT2] = HISTORY_INVALID;   // 无效值不参与统计
+        else v[HISTORY_CH_CURRENT2] = 300;
+        history.append(s * 1000, v);
+    }
+
+    // 最后一个桶未完成，不返回
+    CHECK(history.size(HISTORY_TIER_10S) == 59);
+    CHECK(history.size(HISTORY_TIER_1MIN) == 9);
+
+    size_t got = history.query(HISTORY_TIER_10S, 0, QUERY_END, points, MAX_POINTS);
+    CHECK(got == 59);
+    for (size_t i = 0; i < got; i++) {
+        const HistoryPoint& p = points[i];
+        CHECK(p.timeMs == i * HISTORY_TIER1_PERIOD_MS);
+        CHECK(p.count == 10);
+        CHECK(p.minV[HISTORY_CH_CURRENT1] == i * 10);
+        CHECK(p.maxV[HISTORY_CH_CURRENT1] == i * 10 + 9);
+        CHECK(p.meanV[HISTORY_CH_CURRENT1] == i * 10 + 5);      // 4.5四舍五入
+        CHECK(p.meanV[HISTORY_CH_CURRENT2] == 300);
+    }
+
+    got = history.query(HISTORY_TIER_1MIN, 0, QUERY_END, points, MAX_POINTS);
+    CHECK(got == 9);
+    CHECK(points[3].timeMs == 3 * HISTORY_TIER2_PERIOD_MS);
+    CHECK(points[3].count == 60);
+    CHECK(points[3].minV[HISTORY_CH_CURRENT1] == 180);
+    CHECK(points[3].maxV[HISTORY_CH_CURRENT1] == 239);
+}
+
+HOST_TEST(history_aggregate_wraps_and_range_query) {
+    history.clear();
+    uint16_t v[HISTORY_CH_COUNT];
+    // 2小时，10秒级只保留最近1小时
+    for (uint32_t s = 0; s < 7200; s++) {
+        values((uint16_t)(s / 10), v);
+        history.append(s * 1000, v);
+    }
+    CHECK(history.size(HISTORY_TIER_10S) == HISTORY_TIER1_LEN);
+    CHECK(history.size(HISTORY_TIER_1MIN) == 119);
+
+    size_t got = history.query(HISTORY_TIER_10S, 0, QUERY_END, points, MAX_POINTS);
+    CHECK(got == HISTORY_TIER1_LEN);
+    CHECK(points[0].timeMs == (719 - HISTORY_TIER1_LEN) * HISTORY_TIER1_PERIOD_MS);
+    for (size_t i = 1; i < got; i++) CHECK(points[i].timeMs - points[i - 1].timeMs == HISTORY_TIER1_PERIOD_MS);
+
+    // 区间查询：含两端，落在桶中间的起点从下一个桶开始
+    got = history.query(HISTORY_TIER_10S, 5000005, 5100000, points, MAX_POINTS);
+    CHECK(got == 10);
+    CHECK(points[0].timeMs == 5010000);
+    CHECK(points[got - 1].timeMs == 5100000);
+    CHECK(points[0].meanV[HISTORY_CH_CURRENT1] == 501);
+
+    // 输出容量限制
+    CHECK(history.query(HISTORY_TIER_10S, 0, QUERY_END, points, 3) == 3);
+}
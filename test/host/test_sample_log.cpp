@@ -0,0 +1,125 @@
+/*
+ * test_sample_log.cpp - 采样日志：每块一次写入、区间扫描、重启恢复
+ */
+
+#include "host_test.h"
+#include "sample_log.h"
+
+#define LOG_DIR "samplelog_test"
+
+static SampleLog logA;
+static SampleLog logB;
+static uint32_t scanned;
+static int32_t lastCurrent;
+
+static void onSample(const LogSample& s, void*) {
+    scanned++;
+    lastCurrent = s.currentPath1mA;
+}
+
+static void clearDir() {
+    char path[64];
+    for (uint32_t id = 0; id < 64; id++) {
+        snprintf(path, sizeof(path), LOG_DIR "/seg%05lu.bin", (unsigned long)id);
+        remove(path);
+    }
+    remove(LOG_DIR "/index.bin");
+}
+
+// 遍历段文件的块头（布局同SampleLog::BlockHeader：magic、count、payloadLen、reserved、t0、t1）
+static uint32_t countBlocks(uint32_t& bytes) {
+    char path[64];
+    uint32_t blocks = 0;
+    bytes = 0;
+    for (uint32_t id = 0; id < 64; id++) {
+        snprintf(path, sizeof(path), LOG_DIR "/seg%05lu.bin", (unsigned long)id);
+        FILE* f = fopen(path, "rb");
+        if (!f) continue;
+        uint16_t hdr[8];
+        while (fread(hdr, 1, sizeof(hdr), f) == sizeof(hdr)) {
+            blocks++;
+            bytes += sizeof(hdr) + hdr[2];
+            fseek(f, hdr[2], SEEK_CUR);
+        }
+        fclose(f);
+    }
+    return blocks;
+}
+
+HOST_TEST(sample_log_one_write_per_block) {
+    clearDir();
+    CHECK(logA.begin(LOG_DIR));
+    uint32_t writes0 = logA.getFlashWrites();       // 索引
+    uint32_t bytes0 = logA.getFlashBytes();
+
+    SW3538_Data_t d = {};
+    d.outputVoltagemV = 9000;
+    d.inputVoltagemV = 20000;
+    d.ntcTemperatureC = 30;
+    for (uint32_t i = 0; i < 2000; i++) {
+        d.currentPath1mA = (int16_t)(1000 + (i % 50) * 7);
+        CHECK(logA.append(d, i * 200));
+    }
+    CHECK(logA.flush());
+
+    // 未滚动段时，写入次数 = 文件中的块数，字节数 = 段文件总长
+    uint32_t fileBytes;
+    uint32_t blocks = countBlocks(fileBytes);
+    CHECK(blocks > 1);
+    CHECK(logA.getFlashWrites() - writes0 == blocks);
+    CHECK(logA.getFlashBytes() - bytes0 == fileBytes);
+
+    scanned = 0;
+    CHECK(logA.scan(0, 0xFFFFFFFF, onSample, nullptr) == 2000);
+    CHECK(scanned == 2000);
+    CHECK(lastCurrent == 1000 + (1999 % 50) * 7);
+}
+
+HOST_TEST(sample_log_recovers_after_restart) {
+    // 新实例模拟重启：从索引和块头恢复，日志时间接续
+    CHECK(logB.begin(LOG_DIR));
+    scanned = 0;
+    CHECK(logB.scan(0, 0xFFFFFFFF, onSample, nullptr) == 2000);
+    CHECK(logB.toLogTime(0) > 1999UL * 200);
+}
+
+// 索引末尾为空段（已滚动但未落盘就掉电）：日志时间仍从最晚的非空段接续，不回到1
+// 索引布局同SampleLog::IndexFile：magic、nextId、count、reserved，之后每段id、t0、t1、bytes
+HOST_TEST(sample_log_time_continues_past_empty_segment) {
+    static SampleLog first;
+    static SampleLog second;
+    const char* dir = "samplelog_empty_test";
+    char path[64];
+    for (uint32_t id = 0; id < 8; id++) {
+        snprintf(path, sizeof(path), "%s/seg%05lu.bin", dir, (unsigned long)id);
+        remove(path);
+    }
+    snprintf(path, sizeof(path), "%s/index.bin", dir);
+    remove(path);
+
+    CHECK(first.begin(dir));
+    SW3538_Data_t d = {};
+    for (uint32_t i = 0; i < 100; i++) {
+        d.currentPath1mA = (int16_t)i;
+        CHECK(first.append(d, 50000 + i * 200));
+    }
+    CHECK(first.flush());
+    uint32_t lastMs = first.toLogTime(50000 + 99 * 200);
+
+    uint32_t index[4 + 4 * SAMPLE_LOG_MAX_SEGMENTS] = {};
+    FILE* f = fopen(path, "rb");
+    CHECK(f != nullptr);
+    size_t n = fread(index, 1, sizeof(index), f);
+    fclose(f);
+    uint16_t* count = (uint16_t*)&index[2];
+    CHECK(n == 12 + 16U * *count);
+    uint32_t* seg = &index[3 + 4 * *count];
+    seg[0] = index[1]++;
+    (*count)++;
+    f = fopen(path, "wb");
+    fwrite(index, 1, 12 + 16U * *count, f);
+    fclose(f);
+
+    CHECK(second.begin(dir));
+    CHECK(second.toLogTime(0) > lastMs);
+}
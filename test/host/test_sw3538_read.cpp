@@ -0,0 +1,206 @@
+/*
+ * test_sw3538_read.cpp - readAllData()读取校验：模拟总线注入故障
+ */
+
+#include "host_test.h"
+#include "sim_frames.h"
+#include "sim_bus.h"
+#include "profile_generator.h"
+
+// 有效槽位与真值的偏差：寄存器须相同，ADC不超过重读容差
+static uint32_t countBadFields(const SW3538_RawFrame& got, const SW3538_RawFrame& truth, uint16_t validMask) {
+    uint32_t bad = 0;
+    for (uint8_t s = 0; s < SW3538_SRC_COUNT; s++) {
+        if (!(validMask & SW3538_VALID(s))) continue;
+        int32_t diff = (int32_t)sw3538RawGet(got, s) - sw3538RawGet(truth, s);
+        int32_t tol = s >= SW3538_SRC_ADC_FIRST ? SW3538_REREAD_TOLERANCE_LSB : 0;
+        if (diff > tol || diff < -tol) bad++;
+    }
+    return bad;
+}
+
+// 低字节为0xFF的ADC读数是合法值：只在首次（相对初值0跳变）重读确认，稳定后不再重读
+HOST_TEST(read_accepts_adc_low_byte_0xff) {
+    SW3538SimBus bus;
+    SW3538Sim driver(SW3538_DEFAULT_ADDRESS, bus);
+    SW3538_RawFrame truth = makeFrame(1000, 5000);
+    truth.adc[SW3538_RAW_IBUS1] = 0x1FF;    // 1277mA
+    truth.adc[SW3538_RAW_VOUT] = 0x13FF;    // 5119mV
+    truth.adc[SW3538_RAW_NTC] = 0x3FF;
+    bus.setFrame(truth);
+
+    CHECK(driver.readAllData());
+    CHECK(driver.data.validMask == SW3538_VALID_ALL);
+    uint32_t rereads = driver.getReadStats().rereads;
+    CHECK(rereads <= 3);
+
+    for (uint8_t i = 0; i < 20; i++) {
+        CHECK(driver.readAllData());
+        CHECK(driver.data.validMask == SW3538_VALID_ALL);
+    }
+    CHECK(driver.getReadStats().rereads == rereads);
+    CHECK(driver.getReadStats().held == 0);
+    CHECK(countBadFields(driver.getRawFrame(), truth, SW3538_VALID_ALL) == 0);
+    CHECK(driver.getRawFrame().adc[SW3538_RAW_IBUS1] == 0x1FF);
+}
+
+// 寄存器真实值为0xFF：每次重读一次，一致即接受，不会被保持为旧值
+HOST_TEST(read_accepts_register_0xff_after_one_reread) {
+    SW3538SimBus bus;
+    SW3538Sim driver(SW3538_DEFAULT_ADDRESS, bus);
+    SW3538_RawFrame truth = makeFrame(1000, 5000);
+    truth.ntcState = 0xFF;
+    bus.setFrame(truth);
+
+    for (uint8_t i = 0; i < 10; i++) {
+        CHECK(driver.readAllData());
+        CHECK(driver.data.validMask == SW3538_VALID_ALL);
+    }
+    const SW3538_ReadStats& st = driver.getReadStats();
+    CHECK(st.rereads == 10);
+    CHECK(st.confirmed == 10);
+    CHECK(st.held == 0);
+    CHECK(driver.getRawFrame().ntcState == 0xFF);
+}
+
+// 按目标分别注入毛刺（另加无应答），默认1轮重读：有效字段全部正确
+// 重读与首次一致即接受，同一毛刺在重读中重复出现（概率为故障率²）才会接受错误值，
+// 5‰下400次扫描期望不到0.1个
+HOST_TEST(read_fault_injection_per_target) {
+    static const uint8_t targets[] = { SIM_GLITCH_REG, SIM_GLITCH_ADC_LOW, SIM_GLITCH_ADC_HIGH, SIM_GLITCH_ALL };
+    for (uint8_t t = 0; t < sizeof(targets); t++) {
+        SW3538SimBus bus;
+        SW3538Sim driver(SW3538_DEFAULT_ADDRESS, bus);
+        ProfileGenerator gen;
+        SW3538_RawFrame truth;
+        gen.begin(PROFILE_PD_FIXED, 7);
+        gen.setNoise(0, 0);
+
+        // 先无故障读一帧，之后无效字段保持的是真实的上次值
+        gen.sample(0, truth);
+        bus.setFrame(truth);
+        CHECK(driver.readAllData());
+        driver.resetReadStats();
+
+        bus.setGlitchTargets(targets[t]);
+        bus.setFaults(5, 5);
+        uint32_t ok = 0, bad = 0;
+        for (uint16_t i = 1; i <= 400; i++) {
+            gen.sample(i * 200UL, truth);
+            bus.setFrame(truth);
+            if (!driver.readAllData()) continue;
+            ok++;
+            bad += countBadFields(driver.getRawFrame(), truth, driver.data.validMask);
+        }
+        CHECK(ok >= 390);
+        CHECK(bad == 0);
+        CHECK(driver.getReadStats().implausible > 0);   // 毛刺确被发现
+    }
+}
+
+// 过采样：所有子样本高字节都是毛刺时该槽位读失败、保持旧值，且不整槽重读
+HOST_TEST(read_oversample_all_subsamples_bad) {
+    SW3538SimBus bus;
+    SW3538Sim driver(SW3538_DEFAULT_ADDRESS, bus);
+    SW3538_RawFrame truth = makeFrame(2000);
+    bus.setFrame(truth);
+    driver.setOversampleBits(2);
+    CHECK(driver.readAllData());
+
+    bus.setFrame(makeFrame(500));
+    bus.setGlitchTargets(SIM_GLITCH_ADC_HIGH);
+    bus.setFaults(0, 1000);
+    bus.resetStats();
+    driver.resetReadStats();
+    CHECK(driver.readAllData());     // 寄存器照常读到
+    CHECK((driver.data.validMask & SW3538_VALID_CURRENTS) == 0);
+    CHECK(driver.getReadStats().rereads == 0);
+    CHECK(bus.getConversions() == SW3538_RAW_ADC_COUNT * 16U);
+    CHECK(driver.getOversample(SW3538_RAW_IBUS1).samples == 0);
+    CHECK(driver.getRawFrame().adc[SW3538_RAW_IBUS1] == truth.adc[SW3538_RAW_IBUS1]);
+}
+
+// 合理性检查不误报：全部脚本的无故障帧（含默认噪声）
+HOST_TEST(read_plausibility_no_false_positives) {
+    ProfileGenerator gen;
+    SW3538_RawFrame frame;
+    uint32_t flagged = 0;
+    for (uint8_t p = 0; p < PROFILE_COUNT; p++) {
+        gen.begin((LoadProfile)p, 7);
+        for (uint16_t i = 0; i < 400; i++) {
+            gen.sample(i * 200UL, frame);
+            if (SW3538::checkPlausibility(frame) != 0) flagged++;
+        }
+    }
+    CHECK(flagged == 0);
+}
+
+// 过采样：失败和毛刺的子样本被丢弃，均值仍准确，且不整槽重读（转换次数不超过5×4^k）
+HOST_TEST(read_oversample_discards_bad_subsamples) {
+    SW3538SimBus bus;
+    SW3538Sim driver(SW3538_DEFAULT_ADDRESS, bus);
+    SW3538_RawFrame truth = makeFrame(2000, 9000);
+    bus.setFrame(truth);
+    bus.setNoise(0);
+    driver.setOversampleBits(2);
+    CHECK(driver.readAllData());
+
+    bus.setFaults(20, 20);
+    uint32_t partial = 0, wrong = 0, overBudget = 0;
+    for (uint16_t i = 0; i < 200; i++) {
+        bus.resetStats();
+        if (!driver.readAllData()) continue;
+        if (bus.getConversions() > SW3538_RAW_ADC_COUNT * 16U) overBudget++;
+        for (uint8_t slot = 0; slot < SW3538_RAW_ADC_COUNT; slot++) {
+            const SW3538_Oversample& os = driver.getOversample(slot);
+            if (os.samples < 16) partial++;
+            // 无噪声时有效子样本全部等于真值
+            if (os.samples > 0 && os.value != ((uint32_t)truth.adc[slot] << 2)) wrong++;
+        }
+    }
+    CHECK(overBudget == 0);
+    CHECK(partial > 0);     // 确有子样本被丢弃
+    CHECK(wrong == 0);
+    CHECK(driver.getRawFrame().adc[SW3538_RAW_IBUS1] == truth.adc[SW3538_RAW_IBUS1]);
+}
+
+// 读改写中读失败：不写入（原先把0xFF写回FORCE_OP2，打开无关的强制控制位）
+HOST_TEST(rmw_failed_read_does_not_write) {
+    SW3538SimBus bus;
+    SW3538Sim driver(SW3538_DEFAULT_ADDRESS, bus);
+    bus.setFrame(makeFrame(1000));
+    bus.setRegister(SW3538_REG_FORCE_OP2, 0x01);
+
+    bus.setFailedRead(SW3538_REG_FORCE_OP2);
+    CHECK(!driver.startConversion());
+    CHECK(!driver.beginFastRead(SW3538_ADC_CH_IBUS1));
+    CHECK(bus.getRegister(SW3538_REG_FORCE_OP2) == 0x01);
+    driver.readAllData();
+    CHECK(bus.getRegister(SW3538_REG_FORCE_OP2) == 0x01);
+
+    bus.setFailedRead(SW3538_REG_NTC_CURRENT_STATE);
+    CHECK(!driver.setNTC(1));
+    CHECK(bus.getRegister(SW3538_REG_NTC_CURRENT_STATE) == 0x00);
+
+    // 读成功时照常读改写，保留其他位
+    bus.setFailedRead(0xFFFF);
+    CHECK(driver.startConversion());
+    CHECK(bus.getRegister(SW3538_REG_FORCE_OP2) == (0x01 | SW3538Variant::adcEnableMask));
+    CHECK(driver.setNTC(1));
+    CHECK(bus.getRegister(SW3538_REG_NTC_CURRENT_STATE) == 0x80);
+}
+
+// 翻页寄存器的设置函数：解锁前拒绝，总线上没有任何事务（不留写保护解除的状态）
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+HOST_TEST(paged_setters_reject_before_unlock) {
+    SW3538SimBus bus;
+    SW3538Sim driver(SW3538_DEFAULT_ADDRESS, bus);
+    bus.setFrame(makeFrame(1000));
+    bus.resetStats();
+    CHECK(!driver.setMOSInternalResistance(1));
+    CHECK(!driver.setNTCOverTempThreshold(3));
+    CHECK(bus.getTransactions() == 0);
+    CHECK(bus.getRegister(SW3538_REG_I2C_ENABLE) == 0);
+}
+#pragma GCC diagnostic pop
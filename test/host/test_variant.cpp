@@ -0,0 +1,92 @@
+/*
+ * test_variant.cpp - 型号策略与日志策略：另一张描述表实例化驱动，日志只经策略输出
+ */
+
+#include "host_test.h"
+#include "sim_frames.h"
+#include "sim_bus.h"
+#include "SW3538_impl.h"
+
+// 单口型号示例：只有通路1，输出电压ADC为12位、2mV/bit，使能位与SW3538不同
+// 仅用于验证型号策略，非真实芯片的寄存器表
+static constexpr SW3538_FieldDesc SINGLE_PORT_FIELDS[] = {
+    { "chipVersion",  0x00, 0xFF, 0xFF, SW3538_SRC_VERSION,     0, 2,  false, 1.0f,  SW3538_T_CHIP_VERSION },
+    { "maxPowerW",    0x02, 0xFF, 0xFF, SW3538_SRC_MAX_POWER,   0, 7,  false, 1.0f,  SW3538_T_MAX_POWER },
+    { "path1Buck",    0x0A, 0xFF, 0xFF, SW3538_SRC_STATUS0,     0, 1,  false, 1.0f,  SW3538_T_BUCK1 },
+    { "path1Online",  0x0D, 0xFF, 0xFF, SW3538_SRC_STATUS1,     1, 1,  false, 1.0f,  SW3538_T_ONLINE1 },
+    { "currentPath1", 0x41, 1, 1,       SW3538_SRC_ADC_IBUS1,   0, 12, false, 2.5f,  SW3538_T_CURRENT1 },
+    { "outputVoltage",0x41, 11, 3,      SW3538_SRC_ADC_VOUT,    0, 12, false, 2.0f,  SW3538_T_VOUT },
+};
+
+struct SinglePortFields {
+    static constexpr uint8_t fieldCount = sizeof(SINGLE_PORT_FIELDS) / sizeof(SINGLE_PORT_FIELDS[0]);
+    static constexpr const SW3538_FieldDesc& field(uint8_t i) { return SINGLE_PORT_FIELDS[i]; }
+};
+
+typedef SW3538VariantT<SinglePortFields> SinglePortVariant;
+typedef SW3538T<SW3538SimBus, SW3538NullLogger, SW3538NoRetry, SinglePortVariant> SinglePortSim;
+template class SW3538T<SW3538SimBus, SW3538NullLogger, SW3538NoRetry, SinglePortVariant>;
+
+typedef SW3538T<SW3538SimBus, SW3538SerialLogger, SW3538NoRetry, SW3538Variant> SW3538SimVerbose;
+template class SW3538T<SW3538SimBus, SW3538SerialLogger, SW3538NoRetry, SW3538Variant>;
+
+// 编译期查询随描述表变化
+static_assert(SinglePortVariant::adcEnableMask == 0x0A, "IBUS1 + VOUT");
+static_assert(SinglePortVariant::adcHighMask(11) == 0x0F, "12-bit VOUT");
+static_assert(SinglePortVariant::adcEnableBit(11) == 3, "VOUT enable bit");
+static_assert(SW3538Variant::adcEnableMask == 0xE6, "SW3538 table unchanged");
+static_assert(SW3538Variant::adcHighMask(11) == 0x7F, "15-bit VOUT");
+
+// 另一型号只读自己表中的通道，按自己的位宽和系数解码
+HOST_TEST(variant_table_drives_read_and_decode) {
+    SW3538SimBus bus;
+    SinglePortSim driver(SW3538_DEFAULT_ADDRESS, bus);
+    SW3538_RawFrame truth = makeFrame(1000, 5000);
+    truth.adc[SW3538_RAW_IBUS2] = 800;
+    bus.setFrame(truth);
+    bus.setNoise(0);
+
+    CHECK(driver.startConversion());
+    CHECK(bus.getRegister(SW3538_REG_FORCE_OP2) == SinglePortVariant::adcEnableMask);
+    bus.resetStats();
+    CHECK(driver.readAllData());
+    CHECK(bus.getConversions() == 2);            // 只转换IBUS1和VOUT
+    CHECK(driver.data.currentPath1mA == 1000);
+    CHECK(driver.data.currentPath2mA == 0);      // 表中没有通路2
+    CHECK(driver.data.outputVoltagemV == (5000 & 0x0FFF) * 2);
+    CHECK(driver.data.path1Online);
+    CHECK(bus.getRegister(SW3538_REG_FORCE_OP2) == 0);
+
+    // 同一原始帧经SW3538表解码：15位、1mV/bit
+    SW3538_Data_t full;
+    CHECK(SW3538Sim::decodeRawFrame(truth, full));
+    CHECK(full.outputVoltagemV == 5000);
+    CHECK(full.currentPath2mA == 2000);
+}
+
+// 探测和扫描的输出只经日志策略：空日志策略下不写串口
+HOST_TEST(logger_policy_gates_probe_output) {
+    SW3538SimBus bus;
+    SW3538Sim quiet(SW3538_DEFAULT_ADDRESS, bus);
+    SW3538SimVerbose verbose(SW3538_DEFAULT_ADDRESS, bus);
+    bus.setFrame(makeFrame(1000));
+
+    hostSerialMute(true);
+    uint32_t before = hostSerialBytes();
+    CHECK(quiet.testI2CAddress(SW3538_DEFAULT_ADDRESS));
+    CHECK(!quiet.testI2CAddress(SW3538_DEFAULT_ADDRESS + 1));
+    CHECK(quiet.scanI2CAddresses() == 1);
+    CHECK(hostSerialBytes() == before);
+
+    // 运行时静音（快速启动首帧之前）
+    SW3538SerialLogger::mute(true);
+    verbose.begin();
+    CHECK(verbose.testI2CAddress(SW3538_DEFAULT_ADDRESS));
+    CHECK(hostSerialBytes() == before);
+    SW3538SerialLogger::mute(false);
+
+    CHECK(verbose.testI2CAddress(SW3538_DEFAULT_ADDRESS));
+    CHECK(verbose.scanI2CAddresses() == 1);
+    CHECK(hostSerialBytes() > before);
+    hostSerialMute(false);
+}